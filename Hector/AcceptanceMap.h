@@ -0,0 +1,159 @@
+#ifndef Hector_AcceptanceMap_h
+#define Hector_AcceptanceMap_h
+
+#include "Hector/PropagationContext.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace hector {
+  class Beamline;
+  class Executor;
+  /// Geometric acceptance of a beamline position, tabulated on a multi-dimensional grid of the particles kinematics
+  /// \note Once built (see AcceptanceMapBuilder), a map can be persisted to a compact binary file, and looked up
+  ///  without any propagation.
+  class AcceptanceMap {
+  public:
+    /// Kinematic variable associated to one axis of the grid
+    enum class Variable : unsigned char {
+      xi,            ///< Longitudinal momentum loss
+      t,             ///< Absolute four-momentum transfer squared |t| (GeV^2)
+      phi,           ///< Azimuthal angle of the scattered particle (rad)
+      vertexX,       ///< Horizontal position of the interaction vertex (m)
+      vertexY,       ///< Vertical position of the interaction vertex (m)
+      crossingAngle  ///< Horizontal angle of the beam at the interaction point (rad)
+    };
+    /// Regular binning of one kinematic variable
+    struct Axis {
+      Variable variable;      ///< Kinematic variable
+      unsigned int num_bins;  ///< Number of bins
+      double min;             ///< Lower edge of the first bin
+      double max;             ///< Upper edge of the last bin
+
+      /// Width of one bin
+      double binWidth() const { return (max - min) / num_bins; }
+      /// Bin index for a value (-1 if out of range)
+      int bin(double val) const;
+      /// Central value of one bin
+      double binCenter(unsigned int i) const { return min + (i + 0.5) * binWidth(); }
+    };
+    /// Propagation counts for one grid cell
+    struct Cell {
+      uint32_t num_generated;  ///< Number of particles generated in the cell
+      uint32_t num_accepted;   ///< Number of particles having reached the beamline position
+
+      /// Fraction of the particles having reached the beamline position
+      double acceptance() const { return (num_generated > 0) ? (double)num_accepted / num_generated : 0.; }
+      /// Binomial uncertainty on the acceptance
+      double error() const;
+    };
+
+  public:
+    /// Build an empty map
+    /// \param[in] key Identifier of the beamline, run parameters and generation settings the map was built for
+    /// \param[in] axes Grid binning, one axis per kinematic variable
+    explicit AcceptanceMap(uint64_t key = 0, const std::vector<Axis>& axes = {});
+
+    /// Read a map from its binary file
+    static AcceptanceMap load(const std::string& path);
+    /// Check the structure of a map binary file, without raising any exception
+    /// \return An empty string if valid, the failure reason otherwise
+    static std::string check(const std::string& path);
+    /// Write the map into a binary file
+    void save(const std::string& path) const;
+
+    /// Identifier of the beamline, run parameters and generation settings the map was built for
+    uint64_t key() const { return key_; }
+    /// Grid binning
+    const std::vector<Axis>& axes() const { return axes_; }
+    /// Index of the axis associated to a kinematic variable (-1 if not binned)
+    int axis(Variable var) const;
+
+    /// Number of grid cells
+    size_t numCells() const { return cells_.size(); }
+    /// Counts in one grid cell
+    Cell& cell(size_t i) { return cells_[i]; }
+    /// Counts in one grid cell
+    const Cell& cell(size_t i) const { return cells_[i]; }
+    /// Index of the grid cell associated to a set of bin indices (one per axis)
+    size_t cellIndex(const std::vector<unsigned int>& bins) const;
+    /// Bin indices (one per axis) of one grid cell
+    std::vector<unsigned int> cellBins(size_t i) const;
+
+    /// Acceptance of the cell containing a point
+    /// \param[in] point Kinematics, one value per axis (in the axes ordering)
+    /// \return Cell acceptance, or 0 if the point lies outside the grid
+    double acceptance(const std::vector<double>& point) const;
+    /// Acceptance at a point, linearly interpolated between the neighbouring cell centres
+    /// \param[in] point Kinematics, one value per axis (in the axes ordering)
+    /// \return Interpolated acceptance, or 0 if the point lies outside the grid
+    double interpolate(const std::vector<double>& point) const;
+
+  private:
+    /// Read the header of a map binary file
+    /// \return An empty string if valid, the failure reason otherwise
+    static std::string readHeader(std::istream&, uint64_t& key, std::vector<Axis>& axes);
+
+    uint64_t key_;
+    std::vector<Axis> axes_;
+    /// Cells counts, with the last axis running fastest
+    std::vector<Cell> cells_;
+  };
+  /// Human-readable printout of a kinematic variable
+  std::ostream& operator<<(std::ostream&, const AcceptanceMap::Variable&);
+
+  /// Builder of acceptance maps, propagating particles through a beamline for each cell of a kinematics grid
+  /// \note Particles are generated from reproducible random streams, and the cells are filled in parallel.
+  ///  For each particle, the outgoing kinematics is derived from its (xi, |t|, phi) values, with the scattering angle
+  ///  \f$ \theta = \sqrt{|t| - t_{min}} / p \f$ and \f$ t_{min} = m^2 \xi^2 / (1 - \xi) \f$; kinematically
+  ///  forbidden particles are not counted. Non-binned variables are set to zero.
+  class AcceptanceMapBuilder {
+  public:
+    /// Prepare the builder for a given beamline position
+    /// \param[in] bl A sequenced beamline (see Beamline::sequencedBeamline)
+    /// \param[in] s Longitudinal position to be reached (m)
+    /// \param[in] ctx Run parameters snapshot
+    AcceptanceMapBuilder(const Beamline* bl,
+                         double s,
+                         const PropagationContext& ctx = PropagationContext::fromParameters());
+
+    /// Bin one kinematic variable
+    AcceptanceMapBuilder& addAxis(AcceptanceMap::Variable var, unsigned int num_bins, double min, double max);
+    /// Set the number of particles to be generated in each cell
+    AcceptanceMapBuilder& setParticlesPerCell(unsigned int num) {
+      num_per_cell_ = num;
+      return *this;
+    }
+    /// Set the number of momentum loss values sampled in each cell
+    /// \note Particles sharing a momentum loss are propagated together ; values are evenly spaced in the bin
+    AcceptanceMapBuilder& setMomentumLossSteps(unsigned int num) {
+      num_xi_steps_ = num;
+      return *this;
+    }
+    /// Set the seed of the random streams
+    AcceptanceMapBuilder& setSeed(uint64_t seed) {
+      seed_ = seed;
+      return *this;
+    }
+
+    /// Identifier of the beamline content, run parameters and generation settings
+    uint64_t key() const;
+    /// Fill a new acceptance map
+    AcceptanceMap build(Executor&) const;
+    /// Retrieve the acceptance map from a file if it matches the current settings, or build and store it
+    AcceptanceMap build(const std::string& path, Executor&) const;
+
+  private:
+    const Beamline* beamline_;  // NOT owning
+    double s_;
+    PropagationContext context_;
+    std::vector<AcceptanceMap::Axis> axes_;
+    unsigned int num_per_cell_;
+    unsigned int num_xi_steps_;
+    uint64_t seed_;
+  };
+}  // namespace hector
+
+#endif
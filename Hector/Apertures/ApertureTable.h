@@ -0,0 +1,58 @@
+#ifndef Hector_Apertures_ApertureTable_h
+#define Hector_Apertures_ApertureTable_h
+
+#include "Hector/Apertures/ApertureType.h"
+
+#include <cmath>
+#include <vector>
+
+namespace hector {
+  class Beamline;
+  namespace aperture {
+    class ApertureBase;
+    /// Flattened collection of the apertures of a sequence of elements, for fast acceptance tests
+    /// \note All supported shapes are described as the intersection of a rectangle and an ellipse (either of them
+    ///  possibly unbounded), so that the acceptance test is a single branch-free expression.
+    class ApertureTable {
+    public:
+      /// Pre-computed shape of an aperture
+      struct Entry {
+        /// Flatten the shape of an aperture
+        /// \note Elements without aperture, or with a shape not yet implemented, are never restricting
+        static Entry fromAperture(const ApertureBase*);
+        /// Check if a transverse position is contained in the aperture
+        /// \note Follows the strict inequalities of the ApertureBase::contains implementations
+        bool contains(double x, double y) const {
+          const double dx = x - x0, dy = y - y0, ex = dx * inv_a, ey = dy * inv_b;
+          return restricted ? (std::fabs(dx) < half_x) & (std::fabs(dy) < half_y) & (ex * ex + ey * ey < 1.) : true;
+        }
+
+        Type type;        ///< Aperture type (anInvalidAperture if not restricted)
+        bool restricted;  ///< Does the aperture restrict the particles path?
+        double x0;        ///< Horizontal position of the aperture centre (m)
+        double y0;        ///< Vertical position of the aperture centre (m)
+        double half_x;    ///< Horizontal half-width of the rectangular part (infinite if none) (m)
+        double half_y;    ///< Vertical half-width of the rectangular part (infinite if none) (m)
+        double inv_a;     ///< Inverse horizontal semi-axis of the elliptic part (0 if none, inf if closed) (m^-1)
+        double inv_b;     ///< Inverse vertical semi-axis of the elliptic part (0 if none, inf if closed) (m^-1)
+      };
+
+    public:
+      ApertureTable() = default;
+      /// Build the table for all elements of a beamline, in the same order
+      explicit ApertureTable(const Beamline*);
+
+      /// Append the shape of an aperture (null if the element is not restricted)
+      void add(const ApertureBase*);
+      /// Number of entries in the table
+      size_t size() const { return entries_.size(); }
+      /// Pre-computed aperture shape for the i-th element
+      const Entry& operator[](size_t i) const { return entries_[i]; }
+
+    private:
+      std::vector<Entry> entries_;
+    };
+  }  // namespace aperture
+}  // namespace hector
+
+#endif
@@ -6,6 +6,7 @@
 namespace hector {
   namespace aperture {
     /// Elliptic shape aperture
+    /// \note A zero semi-axis closes the aperture, and no particle is contained
     class Elliptic : public ApertureBase {
     public:
       /// Class constructor
@@ -41,6 +41,7 @@ namespace hector {
 
     /// Add a new element in the beamline
     /// \param[in] elem Element to be copied and added to the beamline
+    /// \note For the construction of a full beamline, see BeamlineBuilder
     void add(const element::ElementPtr& elem);
     /// Get the full beamline content (vector of elements)
     const element::Elements& elements() const { return elements_; }
@@ -59,7 +60,7 @@ namespace hector {
     /// \param[in] s s-position of the element (computed wrt the interaction point)
     const element::ElementPtr& get(double s) const;
     /// Find an element by name
-    element::Elements find(const std::string&);
+    element::Elements find(const std::string&) const;
     /// Number of elements in the beamline
     unsigned short numElements() const { return elements_.size(); }
 
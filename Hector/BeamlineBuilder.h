@@ -0,0 +1,34 @@
+#ifndef Hector_BeamlineBuilder_h
+#define Hector_BeamlineBuilder_h
+
+#include "Hector/Elements/ElementBaseFwd.h"
+
+namespace hector {
+  class Beamline;
+  /// A bulk constructor for the content of a beamline
+  /// \note All elements are collected first, then sorted once and swept in s to resolve their overlaps, with the
+  ///  same splitting rules as Beamline::add (the enclosing element is split into its "/1" and "/2" parts, the
+  ///  latter having the first part as parent). Elements sharing a name with any element already built are
+  ///  discarded, and elements at the same position keep their insertion order.
+  class BeamlineBuilder {
+  public:
+    /// Start the construction of a beamline content
+    /// \param[inout] beamline Beamline to be populated (its content is replaced once built)
+    /// \param[in] sequence Fill all empty spaces between the elements with drifts?
+    explicit BeamlineBuilder(Beamline& beamline, bool sequence = false);
+
+    /// Prepare the collection for a given number of elements
+    void reserve(size_t num_elements);
+    /// Collect a new element to be added to the beamline
+    void add(const element::ElementPtr& elem);
+    /// Sort all collected elements, resolve their overlaps, and set the beamline content
+    void build();
+
+  private:
+    Beamline& beamline_;
+    bool sequence_;
+    element::Elements elements_;
+  };
+}  // namespace hector
+
+#endif
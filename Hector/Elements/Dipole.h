@@ -39,9 +39,18 @@ namespace hector {
          */
       /// \note Numerical sensitivity (~\f$10^{-8}\f$ relative precision on a 64-bit Intel machine) expected with \f$ \frac{r}{E_{\mathrm{b}}} \left(1-\cos{\theta}\right)\f$.
       ///  Using \f$ \cos{2x} = 1-2\sin^{2}{x} \f$ to transform this term (see the variable called "simp")
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and (modified) field strength
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Modified field strength (see ElementBase::fieldStrength)
+      /// \param[in] relative_energy Use the relative energy loss in the path computation?
+      /// \param[in] beam_energy Primary particles energy (GeV)
+      /// \param[in] name Element name (for logging purposes)
+      static Matrix6 genericMatrix(
+          double length, double ke, bool relative_energy, double beam_energy, const std::string& name);
     };
 
     /// Sector dipole object builder
@@ -79,9 +88,18 @@ namespace hector {
          * \f$
          * assuming \f$\theta = {L\over r}\f$, \f$ {1\over r} \equiv k =  k_{0} \cdot \frac{p_{0}}{p_{0} - \mathrm{d}p} \cdot \frac{q_{\mathrm{part}}}{q_{\mathrm{b}}} \f$
          */
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and (modified) field strength
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Modified field strength (see ElementBase::fieldStrength)
+      /// \param[in] relative_energy Use the relative energy loss in the path computation?
+      /// \param[in] beam_energy Primary particles energy (GeV)
+      /// \param[in] name Element name (for logging purposes)
+      static Matrix6 genericMatrix(
+          double length, double ke, bool relative_energy, double beam_energy, const std::string& name);
     };
   }  // namespace element
 }  // namespace hector
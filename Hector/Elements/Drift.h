@@ -14,9 +14,10 @@ namespace hector {
       Drift(const std::string&, const Type& type, double spos = 0., double length = 0.);
 
       std::shared_ptr<ElementBase> clone() const override { return std::make_shared<Drift>(*this); }
-      Matrix matrix(double eloss = -1.,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss = -1.,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
       /// Build a transfer matrix for a given drift length
       /// \param[in] length drift length
       /** \note \f$
@@ -32,7 +33,7 @@ namespace hector {
          * \right)
          * \f$
          */
-      static Matrix genericMatrix(double length);
+      static Matrix6 genericMatrix(double length);
     };
   }  // namespace element
 }  // namespace hector
@@ -2,9 +2,12 @@
 #define Hector_Elements_ElementBase_h
 
 #include "Hector/Utils/Algebra.h"
+#include "Hector/Utils/Matrix6.h"
 #include "Hector/Parameters.h"
+#include "Hector/PropagationContext.h"
 #include "Hector/Apertures/ApertureBase.h"
 #include "Hector/Elements/ElementType.h"
+#include "Hector/Elements/MatrixCache.h"
 
 #include <memory>
 
@@ -37,9 +40,24 @@ namespace hector {
       /// \param[in] eloss Particle energy loss in the element (GeV)
       /// \param[in] mp Particle mass (GeV)
       /// \param[in] qp Particle charge (e)
-      virtual Matrix matrix(double eloss,
-                            double mp = Parameters::get()->beamParticlesMass(),
-                            int qp = Parameters::get()->beamParticlesCharge()) const = 0;
+      virtual Matrix6 matrix(double eloss,
+                             double mp = Parameters::get()->beamParticlesMass(),
+                             int qp = Parameters::get()->beamParticlesCharge()) const = 0;
+      /// Compute the propagation matrix for this element, for a given set of run parameters
+      /// \param[in] eloss Particle energy loss in the element (GeV)
+      /// \param[in] mp Particle mass (GeV)
+      /// \param[in] qp Particle charge (e)
+      /// \param[in] ctx Run parameters snapshot
+      /// \note The default implementation falls back on the global run parameters
+      virtual Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const;
+      /// Retrieve the propagation matrix for this element, only computing it once per energy loss/mass/charge
+      /// \param[in] eloss Particle energy loss in the element (GeV)
+      /// \param[in] mp Particle mass (GeV)
+      /// \param[in] qp Particle charge (e)
+      Matrix6 cachedMatrix(double eloss, double mp, int qp) const;
+      /// Retrieve the propagation matrix for this element, only computing it once per energy loss/mass/charge and
+      /// set of run parameters
+      Matrix6 cachedMatrix(double eloss, double mp, int qp, const PropagationContext& ctx) const;
 
       /// Set the name of the element
       void setName(const std::string& name) { name_ = name; }
@@ -86,13 +104,19 @@ namespace hector {
       double Ty() const { return angles_.y(); }
 
       /// Set the element length (m)
-      void setLength(double length) { length_ = length; }
+      void setLength(double length) {
+        length_ = length;
+        matrices_id_ = MatrixCache::newElementId();
+      }
       /// Element length (m)
       double length() const { return length_; }
 
       /// Set the element magnetic field strength
       /// \note Strength \f$ k = \frac{e}{p}\frac{\partial B}{\partial x} \f$
-      void setMagneticStrength(double k) { magnetic_strength_ = k; }
+      void setMagneticStrength(double k) {
+        magnetic_strength_ = k;
+        matrices_id_ = MatrixCache::newElementId();
+      }
       /// Magnetic field strength
       double magneticStrength() const { return magnetic_strength_; }
 
@@ -126,6 +150,19 @@ namespace hector {
       /// Compute the modified field strength of the element for a given energy loss of a particle of given mass and charge
       /// \note \f$ k_e = k \cdot \frac{p}{p-\mathrm{d}p} \cdot \frac{q_{\mathrm{part}}}{q_{\mathrm{b}}} \f$
       double fieldStrength(double, double, int) const;
+      /// Compute the modified field strength of the element for a given energy loss of a particle of given mass and
+      /// charge, and a given set of run parameters
+      double fieldStrength(double, double, int, const PropagationContext&) const;
+      /// Compute the modified field strength for a given element strength, particle energy loss, mass and charge
+      /// \param[in] k Nominal magnetic strength of the element
+      /// \param[in] e_loss Particle energy loss (GeV)
+      /// \param[in] mp Particle mass (GeV)
+      /// \param[in] qp Particle charge (e)
+      /// \param[in] beam_energy Primary particles energy (GeV)
+      /// \param[in] beam_mass Primary particles mass (GeV)
+      /// \param[in] beam_charge Primary particles charge (e)
+      static double fieldStrength(
+          double k, double e_loss, double mp, int qp, double beam_energy, double beam_mass, int beam_charge);
 
     protected:
       /// Element type
@@ -155,6 +192,8 @@ namespace hector {
       TwoVector disp_;
       /// Relative position of the element
       TwoVector rel_pos_;
+      /// Identifier of the transfer matrices in the per-thread cache (renewed whenever they may change)
+      unsigned long long matrices_id_;
     };
 
     /// Sorting methods for the beamline construction (using the s position of each elements)
@@ -37,9 +37,14 @@ namespace hector {
          * \f$
          * assuming \f$ k =  k_{0} \cdot \frac{p_{0}}{p_{0} - \mathrm{d}p} \cdot \frac{q_{\mathrm{particle}}}{q_{\mathrm{beam}}} \f$
          */
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and kick
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Kick strength
+      static Matrix6 genericMatrix(double length, double ke);
     };
 
     /// Vertical kicker object builder
@@ -64,9 +69,14 @@ namespace hector {
          * \f$
          * assuming \f$ k =  k_{0} \cdot \frac{p_{0}}{p_{0} - \mathrm{d}p} \cdot \frac{q_{\mathrm{particle}}}{q_{\mathrm{beam}}} \f$
          */
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and kick
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Kick strength
+      static Matrix6 genericMatrix(double length, double ke);
     };
   }  // namespace element
 }  // namespace hector
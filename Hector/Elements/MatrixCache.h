@@ -0,0 +1,104 @@
+#ifndef Hector_Elements_MatrixCache_h
+#define Hector_Elements_MatrixCache_h
+
+#include "Hector/PropagationContext.h"
+#include "Hector/Utils/Matrix6.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace hector {
+  namespace element {
+    /// A least-recently-used memoisation of the elements transfer matrices, private to each thread
+    /// \note Matrices are indexed by the element (through an identifier renewed whenever its matrices may change),
+    ///  the particle energy loss, mass and charge, and the run parameters snapshot they were computed for. As each
+    ///  thread holds its own cache, lookups are lock-free and never contend between the propagation workers.
+    ///  A matrix is only stored once its key was requested twice, so that non-repeating keys (e.g. a continuous
+    ///  energy loss) bypass the cache without any allocation.
+    class MatrixCache {
+    public:
+      /// Build an empty cache
+      /// \param[in] capacity Maximal number of matrices to be kept in memory
+      explicit MatrixCache(size_t capacity = 4096);
+      MatrixCache(const MatrixCache&) = delete;
+      MatrixCache& operator=(const MatrixCache&) = delete;
+
+      /// Cache of the calling thread
+      static MatrixCache& local();
+      /// New unique identifier for the transfer matrices of an element
+      static unsigned long long newElementId();
+
+      /// Retrieve a cached matrix, or compute (and possibly store) it if not yet available
+      /// \param[in] elem_id Element identifier (see newElementId)
+      /// \param[in] eloss Particle energy loss in the element (GeV)
+      /// \param[in] mp Particle mass (GeV)
+      /// \param[in] qp Particle charge (e)
+      /// \param[in] ctx Run parameters snapshot
+      /// \param[in] compute Functor computing the transfer matrix on a cache miss
+      template <typename F>
+      Matrix6 get(unsigned long long elem_id,
+                  double eloss,
+                  double mp,
+                  int qp,
+                  const PropagationContext& ctx,
+                  F&& compute) {
+        const Key key{elem_id, eloss, mp, qp, ctx};
+        Matrix6 mat;
+        if (lookup(key, mat)) {
+          ++hits_;
+          return mat;
+        }
+        ++misses_;
+        mat = compute(eloss, mp, qp);
+        insert(key, mat);
+        return mat;
+      }
+      /// Remove all matrices from the cache
+      void clear();
+
+      /// Maximal number of matrices to be kept in memory
+      size_t capacity() const { return capacity_; }
+      /// Set the maximal number of matrices to be kept in memory
+      void setCapacity(size_t capacity);
+      /// Number of matrices currently stored
+      size_t size() const { return matrices_.size(); }
+      /// Number of successful lookups
+      unsigned long long hits() const { return hits_; }
+      /// Number of matrices computed on a failed lookup
+      unsigned long long misses() const { return misses_; }
+      /// Reset the hits/misses counters
+      void resetCounters();
+
+    private:
+      /// Indexing parameters for a transfer matrix
+      struct Key {
+        unsigned long long elem_id;
+        double eloss, mp;
+        int qp;
+        PropagationContext ctx;
+        bool operator==(const Key& oth) const {
+          return elem_id == oth.elem_id && eloss == oth.eloss && mp == oth.mp && qp == oth.qp && ctx == oth.ctx;
+        }
+      };
+      /// Hashing algorithm for the matrix indexing parameters
+      struct KeyHash {
+        size_t operator()(const Key&) const;
+      };
+      typedef std::list<std::pair<Key, Matrix6> > MatricesList;
+
+      bool lookup(const Key&, Matrix6&);
+      void insert(const Key&, const Matrix6&);
+
+      size_t capacity_;
+      /// Matrices list, ordered from the most to the least recently used
+      MatricesList matrices_;
+      std::unordered_map<Key, MatricesList::iterator, KeyHash> index_;
+      /// Hash of the last key not found in each slot, for the admission of the repeated keys
+      std::vector<size_t> requested_;
+      unsigned long long hits_, misses_;
+    };
+  }  // namespace element
+}  // namespace hector
+
+#endif
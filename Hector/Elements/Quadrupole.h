@@ -37,9 +37,15 @@ namespace hector {
          * \f$
          * assuming \f$ k =  k_{0} \cdot \frac{p_{0}}{p_{0} - \mathrm{d}p} \cdot \frac{q_{\mathrm{part}}}{q_{\mathrm{b}}} \f$ and \f$ \omega \equiv \omega(k,L) = L \sqrt{|k|} \f$
          */
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and (modified) field strength
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Modified field strength (see ElementBase::fieldStrength)
+      /// \param[in] name Element name (for logging purposes)
+      static Matrix6 genericMatrix(double length, double ke, const std::string& name);
     };
 
     /// Vertical quadrupole object builder
@@ -64,9 +70,15 @@ namespace hector {
          * \f$
          * assuming \f$ k =  k_{0} \cdot \frac{p_{0}}{p_{0} - \mathrm{d}p} \cdot \frac{q_{\mathrm{part}}}{q_{\mathrm{b}}} \f$ and \f$ \omega \equiv \omega(k,l) = L \sqrt{|k|} \f$
          */
-      Matrix matrix(double,
-                    double mp = Parameters::get()->beamParticlesMass(),
-                    int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double,
+                     double mp = Parameters::get()->beamParticlesMass(),
+                     int qp = Parameters::get()->beamParticlesCharge()) const override;
+      Matrix6 matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const override;
+      /// Build a transfer matrix for a given length and (modified) field strength
+      /// \param[in] length Element length (m)
+      /// \param[in] ke Modified field strength (see ElementBase::fieldStrength)
+      /// \param[in] name Element name (for logging purposes)
+      static Matrix6 genericMatrix(double length, double ke, const std::string& name);
     };
   }  // namespace element
 }  // namespace hector
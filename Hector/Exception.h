@@ -55,6 +55,8 @@ namespace hector {
     inline const std::string from() const { return from_; }
     /// Error code associated to the exception
     inline int errorNumber() const { return error_num_; }
+    /// Human-readable description of the exception
+    inline const std::string message() const { return message_.str(); }
     /// Type of exception encountered (info, warning, fatal error)
     inline ExceptionType type() const { return type_; }
     /// Prettified (colourised) string of the exception type
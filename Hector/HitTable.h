@@ -0,0 +1,57 @@
+#ifndef Hector_HitTable_h
+#define Hector_HitTable_h
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace hector {
+  /// Dense collection of the particles kinematics at a set of observation planes
+  /// \note Hits are stored contiguously per particle, in the ordering of the observation planes
+  class HitTable {
+  public:
+    /// Outcome of the readout of one particle at one plane
+    enum class Status : unsigned char {
+      reached,     ///< Particle crossed the plane
+      stopped,     ///< Particle was stopped by an aperture upstream of the plane
+      notReached,  ///< Plane lies outside the propagation range of the particle
+      failed       ///< Propagation failed upstream of the plane
+    };
+    /// Particle kinematics at one plane
+    struct Hit {
+      double x;       ///< Horizontal position (m)
+      double y;       ///< Vertical position (m)
+      double tx;      ///< Horizontal angle (rad)
+      double ty;      ///< Vertical angle (rad)
+      Status status;  ///< Readout outcome (the kinematics is only meaningful for reached planes)
+    };
+
+  public:
+    /// Build a table for a given number of particles and planes, with all planes not reached
+    explicit HitTable(size_t num_particles = 0, size_t num_planes = 0);
+
+    /// Number of particles
+    size_t numParticles() const { return num_particles_; }
+    /// Number of observation planes
+    size_t numPlanes() const { return num_planes_; }
+
+    /// Kinematics of one particle at one plane
+    Hit& operator()(size_t part, size_t plane) { return hits_[part * num_planes_ + plane]; }
+    /// Kinematics of one particle at one plane
+    const Hit& operator()(size_t part, size_t plane) const { return hits_[part * num_planes_ + plane]; }
+    /// Kinematics of one particle at all planes
+    Hit* row(size_t part) { return hits_.data() + part * num_planes_; }
+    /// Kinematics of one particle at all planes
+    const Hit* row(size_t part) const { return hits_.data() + part * num_planes_; }
+    /// Number of particles having reached one plane
+    size_t numReached(size_t plane) const;
+
+  private:
+    size_t num_particles_, num_planes_;
+    std::vector<Hit> hits_;
+  };
+  /// Human-readable printout of a hit readout status
+  std::ostream& operator<<(std::ostream&, const HitTable::Status&);
+}  // namespace hector
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef Hector_IO_BeamlineCache_h
+#define Hector_IO_BeamlineCache_h
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace hector {
+  class Beamline;
+  namespace io {
+    /// On-disk cache of the beamlines parsed from MAD-X Twiss files
+    /// \note Entries are identified by a hash of the Twiss file content and of all parsing options (interaction
+    ///  point, beamline window, overlaps correction), and hold the sequenced beamline along with the Twiss header
+    ///  variables, as HBL files (see HBL). Each entry is written to a temporary file then atomically renamed: many
+    ///  jobs may populate the same cache directory concurrently, and readers never observe a partial entry.
+    class BeamlineCache {
+    public:
+      /// A beamline retrieved from the cache or parsed from its Twiss file
+      struct Entry {
+        std::unique_ptr<Beamline> beamline;                 ///< Sequenced beamline
+        std::map<std::string, std::string> header_strings;  ///< String variables of the Twiss header
+        std::map<std::string, float> header_floats;         ///< Floating-point variables of the Twiss header
+        bool cached;                                        ///< Was the beamline retrieved from the cache?
+      };
+
+    public:
+      /// Build a cache handler
+      /// \param[in] directory Path to the cache directory (created if missing)
+      explicit BeamlineCache(const std::string& directory);
+
+      /// Retrieve the sequenced beamline of a Twiss file, parsing it and populating the cache on a miss
+      /// \note As for a Twiss file parsing, the beam energy, particles mass and charge of the header are applied
+      ///  to the run parameters
+      /// \param[in] filename Path to the MAD-X Twiss file
+      /// \param[in] ip_name Name of the interaction point
+      /// \param[in] max_s Maximal s-coordinate at which the Twiss file must be parsed
+      /// \param[in] min_s Minimal s-coordinate from which the Twiss file must be parsed
+      Entry load(const std::string& filename, const std::string& ip_name, float max_s = -1., float min_s = 0.) const;
+
+      /// Identifier of a Twiss file content and parsing options
+      static uint64_t key(const std::string& filename, const std::string& ip_name, float max_s, float min_s);
+      /// Path to the cache entry for a given identifier
+      std::string path(uint64_t key) const;
+
+    private:
+      /// Retrieve a cache entry (false if missing or invalid)
+      bool retrieve(const std::string& path, uint64_t key, Entry&) const;
+      /// Store a cache entry, through a temporary file renamed once complete
+      void store(const std::string& path, uint64_t key, const Entry&) const;
+
+      std::string directory_;
+    };
+  }  // namespace io
+}  // namespace hector
+
+#endif
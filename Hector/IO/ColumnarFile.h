@@ -0,0 +1,153 @@
+#ifndef Hector_IO_ColumnarFile_h
+#define Hector_IO_ColumnarFile_h
+
+#include "Hector/HitTable.h"
+#include "Hector/ObservationPlanes.h"
+#include "Hector/ParticleBatch.h"
+#include "Hector/Utils/MappedFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hector {
+  namespace io {
+    /// Columnar binary storage of particles and of their hits at observation planes
+    /// \note A file holds a header (format version, byte order, observation planes), followed by a sequence of
+    ///  chunks. Each chunk stores a group of particles as contiguous, 64 byte-aligned columns: event id, PDG id,
+    ///  charge, mass, s-coordinate, the six state vector components, the propagation status, and for each
+    ///  observation plane the hit (x, y, x', y') kinematics and readout status.
+    namespace columnar {
+      /// Column content, in the ordering of the chunk layout
+      enum Column : unsigned short {
+        eventId,
+        pdgId,
+        charge,
+        mass,
+        s,
+        stateVector,  ///< First of the six state vector components (in the StateVector::Components ordering)
+        status = stateVector + 6,
+        hits,  ///< First of the five columns (x, y, x', y', readout status) of each observation plane
+      };
+      /// Number of columns of the hits of one observation plane
+      constexpr unsigned short num_hit_columns = 5;
+    }  // namespace columnar
+
+    /// Writer of a columnar particles file
+    /// \note Chunks can be appended concurrently from multiple threads: each chunk is serialised by its caller, and
+    ///  written at its own reserved position in the file. Chunks are hence stored in no particular order.
+    class ColumnarWriter {
+    public:
+      /// Create a new file, and write its header
+      /// \param[in] path Output file path (overwritten if existing)
+      /// \param[in] planes Observation planes of the hits to be stored for each particle
+      explicit ColumnarWriter(const std::string& path, const ObservationPlanes& planes = ObservationPlanes());
+      ColumnarWriter(const ColumnarWriter&) = delete;
+      ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+      ~ColumnarWriter();
+
+      /// Append a chunk of particles (thread-safe)
+      /// \param[in] batch Particles kinematics and propagation statuses
+      /// \param[in] hits Particles hits at the observation planes (if any)
+      /// \param[in] event_ids Event identifier of each particle (0 if not provided)
+      /// \param[in] pdg_ids PDG identifier of each particle (0 if not provided)
+      void append(const ParticleBatch& batch,
+                  const HitTable* hits = nullptr,
+                  const uint64_t* event_ids = nullptr,
+                  const int32_t* pdg_ids = nullptr);
+      /// Number of particles written so far
+      size_t numParticles() const { return num_particles_; }
+      /// Close the file ; no chunk can be appended afterwards
+      void close();
+
+    private:
+      std::string path_;
+      int fd_;
+      size_t num_planes_;
+      /// Position of the next chunk in the file
+      std::atomic<uint64_t> offset_;
+      std::atomic<size_t> num_particles_;
+    };
+
+    /// Memory-mapped reader of a columnar particles file
+    class ColumnarReader {
+    public:
+      /// A group of particles, with its columns accessed in place in the mapped file
+      class Chunk {
+      public:
+        /// Number of particles in the chunk
+        size_t size() const { return size_; }
+        /// Event identifiers
+        const uint64_t* eventId() const { return column<uint64_t>(columnar::eventId); }
+        /// PDG identifiers
+        const int32_t* pdgId() const { return column<int32_t>(columnar::pdgId); }
+        /// Electric charges (e)
+        const int32_t* charge() const { return column<int32_t>(columnar::charge); }
+        /// Masses (GeV)
+        const double* mass() const { return column<double>(columnar::mass); }
+        /// Longitudinal positions (m)
+        const double* s() const { return column<double>(columnar::s); }
+        /// Column of values for one of the state vector components
+        const double* component(StateVector::Components comp) const {
+          return column<double>(columnar::stateVector + comp);
+        }
+        /// Propagation statuses
+        const ParticleBatch::Status* status() const { return column<ParticleBatch::Status>(columnar::status); }
+        /// Horizontal positions at one observation plane (m)
+        const double* hitX(size_t plane) const { return hitColumn<double>(plane, 0); }
+        /// Vertical positions at one observation plane (m)
+        const double* hitY(size_t plane) const { return hitColumn<double>(plane, 1); }
+        /// Horizontal angles at one observation plane (rad)
+        const double* hitTx(size_t plane) const { return hitColumn<double>(plane, 2); }
+        /// Vertical angles at one observation plane (rad)
+        const double* hitTy(size_t plane) const { return hitColumn<double>(plane, 3); }
+        /// Readout statuses at one observation plane
+        const HitTable::Status* hitStatus(size_t plane) const { return hitColumn<HitTable::Status>(plane, 4); }
+
+      private:
+        friend class ColumnarReader;
+        template <typename T>
+        const T* column(size_t col) const {
+          return reinterpret_cast<const T*>(data_ + offsets_[col]);
+        }
+        template <typename T>
+        const T* hitColumn(size_t plane, size_t col) const {
+          return column<T>(columnar::hits + plane * columnar::num_hit_columns + col);
+        }
+        const char* data_;
+        size_t size_;
+        std::vector<size_t> offsets_;
+      };
+
+    public:
+      /// Map a file into memory, and index its chunks
+      explicit ColumnarReader(const std::string& path);
+
+      /// Format version of the file
+      uint32_t version() const { return version_; }
+      /// Observation planes of the hits stored for each particle
+      const ObservationPlanes& planes() const { return planes_; }
+      /// Number of chunks
+      size_t numChunks() const { return chunks_.size(); }
+      /// Retrieve one chunk
+      const Chunk& chunk(size_t i) const { return chunks_[i]; }
+      /// Total number of particles
+      size_t numParticles() const { return num_particles_; }
+
+      /// Append all particles to a batch, in the chunks ordering
+      void read(ParticleBatch&) const;
+      /// Collect the hits of all particles, in the chunks ordering
+      HitTable hits() const;
+
+    private:
+      MappedFile file_;
+      uint32_t version_;
+      ObservationPlanes planes_;
+      std::vector<Chunk> chunks_;
+      size_t num_particles_;
+    };
+  }  // namespace io
+}  // namespace hector
+
+#endif
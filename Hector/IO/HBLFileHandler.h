@@ -1,18 +1,32 @@
 #ifndef Hector_IO_HBLFileHandler_h
 #define Hector_IO_HBLFileHandler_h
 
-#include <string>
+#include "Hector/Utils/MappedFile.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
 #include <memory>
+#include <string>
 
 namespace hector {
   class Beamline;
   /// Collection of input/output utilitaries
   namespace io {
+    struct HBLHeaderV2;
+    struct HBLElementV2;
     /// An HBL (Hector BeamLine) files handler
+    /// \note Files are written in the version 2 layout (see HBLHeaderV2), holding the full state of all elements,
+    ///  and the header variables of the optics file they were built from. Such files are memory-mapped, and their
+    ///  element records can be accessed in place: all processes reading a beamline share a single page-cached copy.
+    ///  Files in the version 1 layout can still be read.
     class HBL {
     public:
       /// Parse an external HBL file
       HBL(const std::string& filename);
+      /// Parse a memory-mapped HBL file in the version 2 layout, in place
+      /// \note The file structure is expected to be validated beforehand (see check), and is not checked again
+      explicit HBL(MappedFile&& file);
       HBL(const HBL&) {}
       HBL(HBL&);
       ~HBL() {}
@@ -20,14 +34,51 @@ namespace hector {
       /// Parse an external HBL file
       void parse(const std::string&);
       /// Write a beamline to an external HBL file
-      static void write(const Beamline*, const std::string& filename);
+      /// \param[in] header_strings String variables of the optics file header
+      /// \param[in] header_floats Floating-point variables of the optics file header
+      static void write(const Beamline*,
+                        const std::string& filename,
+                        const std::map<std::string, std::string>& header_strings = {},
+                        const std::map<std::string, float>& header_floats = {});
+      /// Write a beamline to an output stream, in the HBL file layout
+      static void write(const Beamline*,
+                        std::ostream&,
+                        const std::map<std::string, std::string>& header_strings = {},
+                        const std::map<std::string, float>& header_floats = {});
+      /// Check the structure and checksum of an external HBL file, without raising any exception
+      static bool valid(const std::string& filename);
+      /// Check the structure and checksum of a memory-mapped file in the version 2 layout
+      /// \return An empty string if valid, the failure reason otherwise
+      static std::string check(const MappedFile&);
       /// Retrieve the beamline parsed from an external HBL file
       Beamline* beamline() const { return beamline_.get(); };
+      /// List of all string variables stored in the HBL file
+      const std::map<std::string, std::string>& headerStrings() const { return header_str_; }
+      /// List of all floating-point variables stored in the HBL file
+      const std::map<std::string, float>& headerFloats() const { return header_float_; }
+
+      /// Number of element records in the memory-mapped file (version 2 layout only)
+      size_t numRecords() const;
+      /// Retrieve an element record, in place in the memory-mapped file (version 2 layout only)
+      const HBLElementV2& record(size_t i) const;
+      /// Name of an element record, in place in the memory-mapped file (version 2 layout only)
+      const char* name(const HBLElementV2&) const;
 
     private:
+      void parseV1(const std::string&);
+      void parseV2(const std::string&);
+      /// Parse a validated memory-mapped file in the version 2 layout
+      void parseV2(MappedFile&&);
+      const HBLHeaderV2& header() const;
+
+      std::unique_ptr<MappedFile> file_;
       std::unique_ptr<Beamline> beamline_;
+      std::map<std::string, std::string> header_str_;
+      std::map<std::string, float> header_float_;
       static constexpr unsigned long long magic_number = 0x464c4248;
-      static constexpr unsigned short version = 100;
+      static constexpr unsigned short version = 200;
+      static constexpr unsigned short version_v1 = 100;
+      static constexpr uint32_t byte_order = 0x01020304;
     };
   }  // namespace io
 }  // namespace hector
@@ -1,6 +1,9 @@
 #ifndef Hector_IO_HBLFileStructures_h
 #define Hector_IO_HBLFileStructures_h
 
+#include <algorithm>
+#include <cstdint>
+
 namespace hector {
   namespace io {
     /// Common header to HBL files
@@ -40,7 +43,7 @@ namespace hector {
             element_magnetic_strength(rhs.element_magnetic_strength),
             aperture_type(rhs.aperture_type),
             aperture_p1(rhs.aperture_p1),
-            aperture_p2(rhs.aperture_p1),
+            aperture_p2(rhs.aperture_p2),
             aperture_p3(rhs.aperture_p3),
             aperture_p4(rhs.aperture_p4),
             aperture_x(rhs.aperture_x),
@@ -72,6 +75,63 @@ namespace hector {
       /// Aperture middle vertical position
       double aperture_y;
     };
+
+    /// Common header to HBL files
+    /// \version 2.0.0
+    /// \note All fields have a fixed width and are stored in the byte order of the writing host, identified by
+    ///  \a byte_order. The file is made of this header, followed by the elements table, the header variables table,
+    ///  and the strings table (NUL-terminated strings, referenced by their offset). All tables are 8-byte aligned,
+    ///  and can hence be accessed in place from a memory-mapped file.
+    struct HBLHeaderV2 {
+      uint64_t magic;             ///< HBL file magic number (should be 0x464c4248 = 'HBL')
+      uint16_t version;           ///< HBL file version
+      uint16_t header_size;       ///< Size of this header (bytes)
+      uint32_t byte_order;        ///< Byte order marker (0x01020304 in the byte order of the file)
+      uint32_t element_size;      ///< Size of one element record (bytes)
+      uint32_t num_elements;      ///< Number of beamline elements, in their sequence ordering
+      uint32_t num_records;       ///< Number of element records (elements, and a detached interaction point)
+      int32_t interaction_point;  ///< Index of the interaction point record (-1 if none)
+      uint32_t num_variables;     ///< Number of header variables
+      uint32_t reserved;          ///< Padding (zero)
+      double max_length;          ///< Maximal beamline length (m)
+      uint64_t elements_offset;   ///< Position of the elements table in the file (bytes)
+      uint64_t variables_offset;  ///< Position of the header variables table in the file (bytes)
+      uint64_t strings_offset;    ///< Position of the strings table in the file (bytes)
+      uint64_t strings_size;      ///< Size of the strings table (bytes)
+      uint64_t checksum;          ///< Hash of all tables (see Hash::addBlock)
+    };
+    /// An element as stored in HBL files
+    /// \version 2.0.0
+    struct HBLElementV2 {
+      int32_t element_type;               ///< Beamline element type
+      uint32_t element_name;              ///< Offset of the beamline element name in the strings table
+      int32_t parent_element;             ///< Index of the parent element record (-1 if none)
+      int32_t aperture_type;              ///< Beamline element aperture type (-1 if none)
+      double element_s;                   ///< Beamline element \f$s\f$ position (m)
+      double element_length;              ///< Beamline element length (m)
+      double element_magnetic_strength;   ///< Beamline element magnetic strength
+      double element_x, element_y;        ///< Beamline element position (m)
+      double element_tx, element_ty;      ///< Beamline element tilt angles (rad)
+      double beta_x, beta_y;              ///< Beta functions at the beamline element (m)
+      double dispersion_x, dispersion_y;  ///< Dispersion functions at the beamline element (m)
+      double relative_x, relative_y;      ///< Beamline element position relative to the beam (m)
+      double aperture_x, aperture_y;      ///< Aperture middle position (m)
+      double aperture_p[4];               ///< Aperture shape parameters
+    };
+    /// A header variable as stored in HBL files
+    /// \version 2.0.0
+    struct HBLVariable {
+      /// Type of content
+      enum Type : uint32_t { string = 0, floating = 1 };
+      uint32_t name;          ///< Offset of the variable name in the strings table
+      uint32_t type;          ///< Type of content
+      uint32_t string_value;  ///< Offset of the string value in the strings table
+      uint32_t reserved;      ///< Padding (zero)
+      double float_value;     ///< Floating-point value
+    };
+    static_assert(sizeof(double) == 8, "HBL files require 64-bit floating-point values.");
+    static_assert(sizeof(HBLHeaderV2) == 88 && sizeof(HBLElementV2) == 168 && sizeof(HBLVariable) == 24,
+                  "HBL file structures must not hold any implicit padding.");
   }  // namespace io
 }  // namespace hector
 
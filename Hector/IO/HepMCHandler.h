@@ -0,0 +1,104 @@
+#ifndef Hector_IO_HepMCHandler_h
+#define Hector_IO_HepMCHandler_h
+
+#include "Hector/ObservationPlanes.h"
+#include "Hector/PropagationContext.h"
+
+#include "Hector/Utils/StreamingPipeline.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace HepMC {
+  class GenEvent;
+}
+namespace hector {
+  class Beamline;
+  namespace io {
+    /// Streaming processor of HepMC v3 ASCII event files
+    /// \note Events are parsed by a read-ahead thread, their forward, charged final-state particles are propagated
+    ///  by a pool of workers through the beamline of their arm, and the events are written back by the calling
+    ///  thread, in their input ordering, with the particles hits at the observation planes (e.g. Roman pots) stored
+    ///  as attributes. The stages run on a StreamingPipeline: the memory in use does not depend on the sample size.
+    ///
+    ///  Attributes attached to each propagated particle:
+    ///  - \a hector_status: propagation outcome (see PropagationResult::Status),
+    ///  - \a hector_\<plane\>_{x,y,tx,ty}: kinematics (m, rad) at each observation plane reached.
+    class HepMC {
+    public:
+      /// Beamline arm, from the sign of the particles longitudinal momentum
+      enum class Arm { positive, negative };
+
+    public:
+      /// Build a processor for an input and an output HepMC v3 ASCII file
+      /// \param[in] input Path to the events file to read
+      /// \param[in] output Path to the events file to write (overwritten if existing)
+      /// \param[in] ctx Run parameters snapshot
+      HepMC(const std::string& input,
+            const std::string& output,
+            const PropagationContext& ctx = PropagationContext::fromParameters());
+
+      /// Set the beamline through which the particles of one arm are propagated
+      /// \param[in] bl A sequenced beamline, shared read-only by all workers (nullptr to disable the arm)
+      /// \param[in] s_max Maximal s-coordinate to be reached (m)
+      /// \param[in] planes Observation planes where the particles hits are read out
+      /// \note Particles of the negative arm are expressed in the frame of their own beam, by a rotation of pi
+      ///  around the vertical axis (x and z are flipped)
+      HepMC& setBeamline(Arm, const Beamline* bl, double s_max, const ObservationPlanes& planes);
+      /// Set the minimal pseudorapidity (in absolute value) of the particles to be propagated
+      HepMC& setMinAbsEta(double eta) {
+        min_abs_eta_ = eta;
+        return *this;
+      }
+      /// Only propagate the electrically charged particles?
+      HepMC& setChargedOnly(bool charged) {
+        charged_only_ = charged;
+        return *this;
+      }
+      /// Set the number of propagation workers (0 to use all hardware threads)
+      HepMC& setNumWorkers(unsigned short num) {
+        runtime_.setNumWorkers(num);
+        return *this;
+      }
+      /// Set the number of events transferred at once between the stages
+      HepMC& setBatchSize(size_t num) {
+        runtime_.setBatchSize(num);
+        return *this;
+      }
+      /// Set the maximal number of batches waiting between two stages
+      HepMC& setQueueSize(size_t num) {
+        runtime_.setQueueSize(num);
+        return *this;
+      }
+      /// Set the maximal number of events to be processed (0 for no limit)
+      HepMC& setMaxEvents(uint64_t num) {
+        runtime_.setMaxEvents(num);
+        return *this;
+      }
+
+      /// Process all events of the input file
+      /// \note The first exception raised in any of the stages aborts the processing, and is rethrown
+      /// \return Number of events written
+      uint64_t run() const;
+
+      /// Electric charge (e) of a particle from its PDG id (0 if unknown)
+      static int charge(int pdg_id);
+
+    private:
+      struct ArmSettings {
+        const Beamline* beamline;  // NOT owning
+        double s_max;
+        ObservationPlanes planes;
+      };
+      std::string input_, output_;
+      PropagationContext context_;
+      ArmSettings arms_[2];
+      double min_abs_eta_;
+      bool charged_only_;
+      StreamingPipeline<std::unique_ptr<::HepMC::GenEvent> > runtime_;
+    };
+  }  // namespace io
+}  // namespace hector
+
+#endif
@@ -2,15 +2,15 @@
 #define Hector_IO_TwissHandler_h
 
 #include "Hector/Utils/OrderedParametersMap.h"
-#include "Hector/Utils/UnorderedParametersMap.h"
 
 #include "Hector/Elements/ElementType.h"
 #include "Hector/Apertures/ApertureType.h"
 
-#include <fstream>
+#include <array>
 #include <regex>
 #include <string>
 #include <memory>
+#include <vector>
 
 using std::ostream;
 
@@ -23,6 +23,8 @@ namespace hector {
   namespace io {
     /// Parsing tool for MAD-X Twiss output files
     /// \note A list of variables stored in Twiss files can be retrieved from http://mad.web.cern.ch/mad/madx.old/Introduction/tables.html
+    ///  The file is memory-mapped and tokenised in place: the positions of the columns used to build the elements are
+    ///  resolved once from the fields header, and all other columns are skipped without being converted.
     class Twiss {
     public:
       /// Class constructor
@@ -49,6 +51,9 @@ namespace hector {
       /// Get a Hector element aperture type from a Twiss element apertype string
       static aperture::Type findApertureTypeByApertype(std::string apertype);
 
+      /// Update the beam energy, particles mass and charge of the run parameters from the Twiss header variables
+      static void updateParameters(const std::map<std::string, float>& header_floats);
+
       /// Print all useful information parsed from the MAD-X Twiss file
       void printInfo() const;
       /// List of all string variables parsed from the Twiss file
@@ -57,26 +62,75 @@ namespace hector {
       std::map<std::string, float> headerFloats() const;
 
     private:
-      /// A collection of values to be propagated through this parser
-      typedef std::vector<std::string> ValuesCollection;
       /// Type of content stored in the parameters map
       enum ValueType : short { Unknown = -1, String, Float, Integer };
       /// Human-readable printout of a value type
       friend std::ostream& operator<<(std::ostream&, const ValueType&);
-
-      void parseHeader();
-      void parseElementsFields();
-      void parseElements();
-      void findInteractionPoint();
-      std::shared_ptr<element::ElementBase> parseElement(const ValuesCollection&);
+      /// Element fields used to build the beamline elements
+      enum class Column : unsigned short {
+        name,
+        keyword,
+        s,
+        l,
+        k0l,
+        k1l,
+        hkick,
+        vkick,
+        x,
+        y,
+        betx,
+        bety,
+        dx,
+        dy,
+        apertype,
+        aper_1,
+        aper_2,
+        aper_3,
+        aper_4
+      };
+      static constexpr size_t num_columns = (size_t)Column::aper_4 + 1;
+      /// Position of a field value in the mapped file
+      struct Token {
+        const char* begin;
+        const char* end;
+      };
+      /// Values of the used columns for one element line
+      struct Record {
+        std::array<Token, num_columns> fields;
+        size_t line;  ///< Line number in the file
+      };
+
+      void parseHeader(const char*& pos, const char* end);
+      void parseElementsFields(const char*& pos, const char* end);
+      /// Locate the interaction point from the first element line, only extracting the elements name
+      /// \param[in,out] line_num Line number of the first element line, then of the interaction point line
+      /// \return Beginning of the interaction point line in the file
+      const char* findInteractionPoint(const char* pos, const char* end, size_t& line_num);
+      /// Parse the elements within the beamline window around the interaction point
+      /// \param[in] begin Beginning of the first element line in the file
+      /// \param[in] ip_pos Beginning of the interaction point line
+      /// \param[in] ip_line Line number of the interaction point line
+      void parseElements(const char* begin, const char* ip_pos, const char* end, size_t ip_line);
+      /// Split the next element line into its fields, and keep the used columns
+      /// \return False if no element line is left in the file
+      bool parseRecord(const char*& pos, const char* end, Record&) const;
+      /// Does the file hold a given column?
+      bool hasColumn(Column col) const { return columns_[(size_t)col] >= 0; }
+      /// Floating-point value of a column
+      float number(const Record&, Column) const;
+      /// String value of a column, without its quotes
+      std::string string(const Record&, Column) const;
+      /// Element type from the keyword (or the name) of an element line
+      element::Type elementType(const Record&) const;
+      std::shared_ptr<element::ElementBase> parseElement(const Record&, element::Type) const;
 
       pmap::Ordered<std::string> header_str_;
       pmap::Ordered<float> header_float_;
 
-      pmap::Unordered<ValueType> elements_fields_;
-
-      std::ifstream in_file_;
-      std::streampos in_file_lastline_;
+      /// Index of each used column in the element lines (-1 if absent)
+      std::array<short, num_columns> columns_;
+      /// Used column of each field of the element lines (-1 if not used)
+      std::vector<short> fields_columns_;
 
       std::unique_ptr<Beamline> beamline_;
       std::unique_ptr<Beamline> raw_beamline_;
@@ -85,7 +139,6 @@ namespace hector {
       std::string ip_name_;
       float min_s_;
 
-      static std::regex rgx_typ_, rgx_hdr_, rgx_elm_hdr_;
       static std::regex rgx_drift_name_, rgx_ip_name_, rgx_monitor_name_;
       static std::regex rgx_quadrup_name_;
       static std::regex rgx_sect_dipole_name_, rgx_rect_dipole_name_;
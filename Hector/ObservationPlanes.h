@@ -0,0 +1,56 @@
+#ifndef Hector_ObservationPlanes_h
+#define Hector_ObservationPlanes_h
+
+#include <string>
+#include <vector>
+
+namespace hector {
+  class Beamline;
+  /// Ordered collection of the longitudinal positions where the particles kinematics is to be read out
+  /// \note Planes may be virtual (any s-coordinate, even inside an element) or attached to beamline elements
+  class ObservationPlanes {
+  public:
+    /// A readout plane
+    struct Plane {
+      std::string name;  ///< Human-readable plane name
+      double s;          ///< Plane s-coordinate (m)
+    };
+    typedef std::vector<Plane>::const_iterator const_iterator;
+
+  public:
+    ObservationPlanes() = default;
+
+    /// Register a plane at a given s-coordinate (m)
+    /// \return Index of the new plane in the s-ordered collection
+    size_t add(const std::string& name, double s);
+    /// Register an unnamed plane at a given s-coordinate (m)
+    size_t add(double s);
+    /// Register a plane at the entrance of each beamline element matching a regular expression
+    /// \return Number of planes added
+    size_t addElements(const Beamline&, const std::string& regex);
+    /// Remove all planes
+    void clear();
+
+    /// Number of planes
+    size_t size() const { return planes_.size(); }
+    /// Is the collection empty?
+    bool empty() const { return planes_.empty(); }
+    /// i-th plane, in increasing s-coordinate
+    const Plane& operator[](size_t i) const { return planes_[i]; }
+    /// Index of a plane from its name
+    size_t index(const std::string& name) const;
+    /// s-coordinates of all planes, in increasing order (m)
+    const std::vector<double>& positions() const { return positions_; }
+
+    /// Iterator to the first plane
+    const_iterator begin() const { return planes_.begin(); }
+    /// Iterator past the last plane
+    const_iterator end() const { return planes_.end(); }
+
+  private:
+    std::vector<Plane> planes_;
+    std::vector<double> positions_;
+  };
+}  // namespace hector
+
+#endif
@@ -13,7 +13,7 @@ namespace hector {
   class Parameters {
   public:
     /// Retrieve this (unique) singleton
-    static std::shared_ptr<Parameters> get();
+    static const std::shared_ptr<Parameters>& get();
     /// Build a new set of parameters
     Parameters();
 
@@ -2,17 +2,17 @@
 #define Hector_Particle_h
 
 #include "Hector/Utils/StateVector.h"
+#include "Hector/Utils/Trajectory.h"
 
 #include <vector>
-#include <map>
 #include <iosfwd>
 
 namespace hector {
   /// Generic particle model inserted in a beam
   class Particle {
   public:
-    /// Particle trajectory holder ; map of state vectors indexed to the s-position
-    typedef std::map<double, StateVector> PositionsMap;
+    /// Particle trajectory holder ; collection of state vectors ordered in s-position
+    typedef Trajectory PositionsMap;
     /// Pair of s-position and state vector defining the particle kinematics
     class Position : private std::pair<double, StateVector> {
     public:
@@ -43,13 +43,17 @@ namespace hector {
     /// \param[in] charge Electric charge (in units of e)
     /// \param[in] pdgid PDG id
     Particle(const LorentzVector& mom, int charge = 999, int pdgid = 2212);
-    ~Particle();
 
     /// Build a Particle object from a mass and electric charge
     static Particle fromMassCharge(double mass, int charge);
 
     /// Clear all state vectors (but the initial one)
     void clear() { positions_.erase(++begin(), end()); }
+    /// Restart the particle from a new initial state vector/s-position couple, keeping the memory allocated
+    /// for its trajectory
+    void reset(const StateVector& sv0, double s0 = 0.);
+    /// Pre-allocate the memory for a given number of trajectory positions
+    void reserve(size_t num_positions) { positions_.reserve(num_positions); }
     /// Add a new s-position/state vector couple to the particle's trajectory
     /// \param[in] stopped Has the particle been stopped in the process?
     void addPosition(double s, const StateVector& vec, bool stopped = false) { addPosition(Position(s, vec), stopped); }
@@ -92,7 +96,10 @@ namespace hector {
     /// Last state vector associated to the particle
     const StateVector lastStateVector() const { return positions_.rbegin()->second; }
 
+    /// Full trajectory of the particle
     PositionsMap& positions() { return positions_; }
+    /// Full trajectory of the particle
+    const PositionsMap& positions() const { return positions_; }
     /// Iterator to the first s-position/state vector couple of the particle's trajectory
     PositionsMap::iterator begin() { return positions_.begin(); }
     /// Iterator to the last s-position/state vector couple of the particle's trajectory
@@ -0,0 +1,118 @@
+#ifndef Hector_ParticleBatch_h
+#define Hector_ParticleBatch_h
+
+#include "Hector/Particle.h"
+#include "Hector/Utils/AlignedAllocator.h"
+
+#include <vector>
+
+namespace hector {
+  /// A collection of particles stored as a structure of arrays, suited for vectorised propagation
+  /// \note Only the current kinematics of each particle is stored (no trajectory)
+  class ParticleBatch {
+  public:
+    /// Propagation status of a particle
+    enum class Status : unsigned char {
+      alive,    ///< Particle still in the beamline acceptance
+      stopped,  ///< Particle stopped by an element aperture
+      invalid   ///< Propagation failed for this particle (e.g. unphysical kinematics)
+    };
+    /// A cache line-aligned column of values
+    template <typename T>
+    using Column = std::vector<T, AlignedAllocator<T> >;
+
+  public:
+    /// Build a batch of blank particles
+    explicit ParticleBatch(size_t num_particles = 0);
+    /// Build a batch from the initial kinematics of a collection of particles
+    explicit ParticleBatch(const Particles&);
+
+    /// Number of particles in the batch
+    size_t size() const { return x_.size(); }
+    /// Is the batch empty?
+    bool empty() const { return x_.empty(); }
+    /// Change the number of particles in the batch
+    void resize(size_t num_particles);
+    /// Pre-allocate the memory for a given number of particles
+    void reserve(size_t num_particles);
+    /// Remove all particles from the batch
+    void clear();
+
+    /// Add a new particle to the batch
+    /// \param[in] sv Particle state vector (including its mass)
+    /// \param[in] charge Particle electric charge (e)
+    /// \param[in] s Longitudinal position of the particle (m)
+    void add(const StateVector& sv, int charge, double s = 0.);
+    /// Add the initial kinematics of a particle to the batch
+    void add(const Particle&);
+
+    /// Retrieve the state vector of one particle
+    StateVector stateVector(size_t i) const;
+    /// Set the state vector of one particle
+    void setStateVector(size_t i, const StateVector&);
+    /// Build a particle object from its current kinematics in the batch
+    Particle particle(size_t i) const;
+
+    /// Build a sub-batch from a list of particles indices
+    ParticleBatch select(const std::vector<size_t>& indices) const;
+    /// Overwrite a list of particles with the content of a sub-batch
+    /// \param[in] indices Particles to be overwritten (one index per particle of the sub-batch)
+    /// \param[in] sub Sub-batch (e.g. as produced by select)
+    void assign(const std::vector<size_t>& indices, const ParticleBatch& sub);
+
+    /// Column of values for one of the state vector components
+    double* component(StateVector::Components comp);
+    /// Column of values for one of the state vector components
+    const double* component(StateVector::Components comp) const;
+
+    /// Horizontal positions (m)
+    double* x() { return x_.data(); }
+    /// Horizontal positions (m)
+    const double* x() const { return x_.data(); }
+    /// Horizontal angles (rad)
+    double* tx() { return tx_.data(); }
+    /// Horizontal angles (rad)
+    const double* tx() const { return tx_.data(); }
+    /// Vertical positions (m)
+    double* y() { return y_.data(); }
+    /// Vertical positions (m)
+    const double* y() const { return y_.data(); }
+    /// Vertical angles (rad)
+    double* ty() { return ty_.data(); }
+    /// Vertical angles (rad)
+    const double* ty() const { return ty_.data(); }
+    /// Energies (GeV)
+    double* energy() { return energy_.data(); }
+    /// Energies (GeV)
+    const double* energy() const { return energy_.data(); }
+    /// Kicks
+    double* kick() { return kick_.data(); }
+    /// Kicks
+    const double* kick() const { return kick_.data(); }
+    /// Masses (GeV)
+    double* mass() { return mass_.data(); }
+    /// Masses (GeV)
+    const double* mass() const { return mass_.data(); }
+    /// Electric charges (e)
+    int* charge() { return charge_.data(); }
+    /// Electric charges (e)
+    const int* charge() const { return charge_.data(); }
+    /// Longitudinal positions (m)
+    double* s() { return s_.data(); }
+    /// Longitudinal positions (m)
+    const double* s() const { return s_.data(); }
+    /// Propagation statuses
+    Status* status() { return status_.data(); }
+    /// Propagation statuses
+    const Status* status() const { return status_.data(); }
+
+  private:
+    Column<double> x_, tx_, y_, ty_, energy_, kick_;
+    Column<double> mass_;
+    Column<int> charge_;
+    Column<double> s_;
+    Column<Status> status_;
+  };
+}  // namespace hector
+
+#endif
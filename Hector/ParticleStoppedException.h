@@ -23,12 +23,18 @@ namespace hector {
         message_ << " at " << elem->name() << " (" << elem->type() << ")";
       message_ << ".\n";
     }
+    /// Message feeder operator, preserving the exception type when thrown
+    template <typename T>
+    inline friend const ParticleStoppedException& operator<<(const ParticleStoppedException& exc, T var) {
+      static_cast<const Exception&>(exc) << var;
+      return exc;
+    }
     /// Retrieve the beamline element that stopped the particle
     const element::ElementPtr& stoppingElement() const { return elem_; }
 
   private:
     /// Beamline element that stopped the particle
-    const element::ElementPtr& elem_;
+    element::ElementPtr elem_;
   };
 }  // namespace hector
 
@@ -0,0 +1,89 @@
+#ifndef Hector_Pipeline_h
+#define Hector_Pipeline_h
+
+#include "Hector/Particle.h"
+#include "Hector/PropagationContext.h"
+#include "Hector/PropagationResult.h"
+#include "Hector/Propagator.h"
+
+#include "Hector/Utils/StreamingPipeline.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace hector {
+  class Beamline;
+  /// Streaming runtime chaining the generation, the propagation and the bookkeeping of events
+  /// \note Events are produced by a source in a dedicated thread, propagated by a pool of workers sharing one
+  ///  compiled view of the beamline, and handed to a sink in the calling thread (see StreamingPipeline for the
+  ///  back-pressure between the stages). Typical sources wrap an io::LHE parser (through its nextEvent method), a
+  ///  Pythia8Generator, or a particle gun.
+  class Pipeline {
+  public:
+    /// A generated event, and the outcome of the propagation of each of its particles
+    struct Event {
+      uint64_t number;                         ///< Event number, in the source ordering
+      Particles particles;                     ///< Particles, with their trajectories once propagated
+      std::vector<PropagationResult> results;  ///< Propagation outcome for each particle
+    };
+    /// Producer of events
+    /// \return False once the source is exhausted
+    typedef std::function<bool(Particles&)> Source;
+    /// Consumer of propagated events
+    typedef std::function<void(Event&)> Sink;
+
+  public:
+    /// Build a pipeline for a given beamline
+    /// \param[in] bl A sequenced beamline (see Beamline::sequencedBeamline), shared read-only by all workers
+    /// \param[in] s_max Maximal s-coordinate to be reached (m)
+    /// \param[in] ctx Run parameters snapshot
+    Pipeline(const Beamline* bl, double s_max, const PropagationContext& ctx = PropagationContext::fromParameters());
+
+    /// Set the number of propagation workers (0 to use all hardware threads)
+    Pipeline& setNumWorkers(unsigned short num) {
+      runtime_.setNumWorkers(num);
+      return *this;
+    }
+    /// Set the number of events transferred at once between the stages
+    Pipeline& setBatchSize(size_t num) {
+      runtime_.setBatchSize(num);
+      return *this;
+    }
+    /// Set the maximal number of batches waiting between two stages
+    Pipeline& setQueueSize(size_t num) {
+      runtime_.setQueueSize(num);
+      return *this;
+    }
+    /// Hand the events to the sink in the source ordering?
+    /// \note Otherwise, events are consumed as soon as they are propagated
+    Pipeline& setOrdered(bool ordered) {
+      runtime_.setOrdered(ordered);
+      return *this;
+    }
+    /// Set the maximal number of events to be produced (0 for no limit)
+    Pipeline& setMaxEvents(uint64_t num) {
+      runtime_.setMaxEvents(num);
+      return *this;
+    }
+    /// Set the policy for the recording of the particles trajectory
+    Pipeline& setRecording(Propagator::Recording rec) {
+      recording_ = rec;
+      return *this;
+    }
+
+    /// Process all events from a source
+    /// \note The first exception raised in any of the stages aborts the processing, and is rethrown
+    /// \return Number of events processed
+    uint64_t run(const Source&, const Sink&) const;
+
+  private:
+    const Beamline* beamline_;  // NOT owning
+    double s_max_;
+    PropagationContext context_;
+    Propagator::Recording recording_;
+    StreamingPipeline<Event> runtime_;
+  };
+}  // namespace hector
+
+#endif
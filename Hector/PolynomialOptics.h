@@ -0,0 +1,122 @@
+#ifndef Hector_PolynomialOptics_h
+#define Hector_PolynomialOptics_h
+
+#include <array>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace hector {
+  class Propagator;
+  /// Parametrised transport from the interaction point to a set of observation planes
+  /// \note At fixed momentum loss \f$ \xi \f$, the transport through the beamline elements is linear in the transverse
+  ///  coordinates, and does not mix the horizontal and vertical planes. The map to each observation plane is hence
+  ///  fitted as \f$ x = x_0(\xi) + v_x(\xi)\,x^* + L_x(\xi)\,\theta_x^* \f$ (and its three equivalents for
+  ///  \f$ \theta_x \f$, \f$ y \f$, \f$ \theta_y \f$), with each optical function a polynomial in \f$ \xi \f$.
+  class PolynomialOptics {
+  public:
+    /// Particle kinematics at the interaction point
+    struct Input {
+      double x;   ///< Horizontal position (m)
+      double tx;  ///< Horizontal angle (rad)
+      double y;   ///< Vertical position (m)
+      double ty;  ///< Vertical angle (rad)
+      double xi;  ///< Momentum loss
+    };
+    /// Particle kinematics at an observation plane
+    struct Output {
+      double x;   ///< Horizontal position (m)
+      double tx;  ///< Horizontal angle (rad)
+      double y;   ///< Vertical position (m)
+      double ty;  ///< Vertical angle (rad)
+    };
+    /// Phase space sampled for the fit (and hence validity range of the parametrisation)
+    struct Ranges {
+      double x;       ///< Half-width of the horizontal position distribution (m)
+      double tx;      ///< Half-width of the horizontal angular distribution (rad)
+      double y;       ///< Half-width of the vertical position distribution (m)
+      double ty;      ///< Half-width of the vertical angular distribution (rad)
+      double xi_min;  ///< Lowest momentum loss
+      double xi_max;  ///< Highest momentum loss
+    };
+    /// Optical functions at an observation plane, for a given momentum loss
+    struct OpticalFunctions {
+      double x0;   ///< Horizontal position of a particle emitted on-axis (m)
+      double v_x;  ///< Horizontal magnification
+      double L_x;  ///< Horizontal effective length (m)
+      double D_x;  ///< Horizontal dispersion, \f$ (x_0(\xi)-x_0(0))/\xi \f$ (m)
+      double y0;   ///< Vertical position of a particle emitted on-axis (m)
+      double v_y;  ///< Vertical magnification
+      double L_y;  ///< Vertical effective length (m)
+      double D_y;  ///< Vertical dispersion, \f$ (y_0(\xi)-y_0(0))/\xi \f$ (m)
+    };
+    /// Fitted parametrisation for one observation plane
+    struct Plane {
+      std::string name;            ///< Human-readable plane name
+      double s;                    ///< Plane s-coordinate (m)
+      std::array<double, 4> rms;   ///< Fit residuals RMS, for each output coordinate
+      std::vector<double> coeffs;  ///< Polynomial coefficients, grouped by output coordinate and optical function
+    };
+
+  public:
+    /// Build an empty parametrisation
+    /// \param[in] degree Degree of the optical functions polynomials in \f$ \xi \f$
+    explicit PolynomialOptics(unsigned short degree = 4);
+    /// Read a parametrisation from an external file
+    explicit PolynomialOptics(const std::string& filename);
+
+    /// Add an observation plane to be parametrised
+    /// \note The plane is expected to lie in a drift, where the particles trajectory is a straight line
+    void addPlane(const std::string& name, double s);
+    /// Fit the parametrisation for all observation planes
+    /// \param[in] prop Propagator through the beamline to be parametrised
+    /// \param[in] ranges Phase space to be sampled
+    /// \param[in] num_samples Number of particles to propagate
+    /// \param[in] seed Random number generator seed
+    /// \param[in] num_threads Number of worker threads for the propagation (0 to use all hardware threads)
+    void fit(const Propagator& prop,
+             const Ranges& ranges,
+             size_t num_samples = 10000,
+             unsigned long seed = 42,
+             unsigned short num_threads = 0);
+    /// Write the parametrisation to an external file
+    void write(const std::string& filename) const;
+
+    /// Degree of the optical functions polynomials in \f$ \xi \f$
+    unsigned short degree() const { return degree_; }
+    /// Phase space sampled for the fit
+    const Ranges& ranges() const { return ranges_; }
+    /// Number of observation planes
+    size_t numPlanes() const { return planes_.size(); }
+    /// Parametrisation for one observation plane
+    const Plane& plane(size_t i) const { return planes_.at(i); }
+    /// Index of an observation plane from its name
+    size_t planeIndex(const std::string& name) const;
+
+    /// Kinematics at an observation plane for a given kinematics at the interaction point
+    /// \note The validity range of the parametrisation is not checked
+    Output evaluate(size_t plane, const Input& in) const;
+    /// Optical functions at an observation plane for a given momentum loss
+    OpticalFunctions opticalFunctions(size_t plane, double xi) const;
+
+  private:
+    /// Number of optical functions per output coordinate (offset, magnification, effective length)
+    static constexpr size_t num_functions = 3;
+    /// Number of coefficients per observation plane
+    size_t numCoefficients() const { return 4 * num_functions * (degree_ + 1); }
+    /// Value of one optical function (and optionally its derivative) at a given normalised momentum loss
+    double function(const Plane&, size_t output, size_t func, double t, double* deriv = nullptr) const;
+
+    unsigned short degree_;
+    Ranges ranges_;
+    /// Centre and inverse half-width of the momentum loss range, for its normalisation to [-1, 1]
+    double xi_mid_, xi_inv_half_;
+    std::vector<Plane> planes_;
+    static constexpr const char* magic = "HectorPolynomialOptics";
+    static constexpr unsigned short version = 1;
+  };
+  /// Human-readable printout of the optical functions
+  std::ostream& operator<<(std::ostream&, const PolynomialOptics::OpticalFunctions&);
+}  // namespace hector
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef Hector_PropagationContext_h
+#define Hector_PropagationContext_h
+
+#include <cstddef>
+
+namespace hector {
+  /// Immutable snapshot of the run parameters entering the particles propagation
+  /// \note Unlike the global Parameters object, a context is a plain value: it can be captured once by a propagator
+  ///  (or a plan, a table, ...) and shared by concurrent threads, with no synchronisation or reference counting.
+  ///  Several contexts (e.g. for beamlines at different energies) can hence coexist in one process.
+  struct PropagationContext {
+    /// Extract the current run parameters from the global Parameters object
+    static PropagationContext fromParameters();
+
+    double beam_energy;      ///< Energy of the primary particles (GeV)
+    double beam_mass;        ///< Mass of the primary particles (GeV)
+    int beam_charge;         ///< Electric charge of the primary particles (e)
+    bool relative_energy;    ///< Use the relative energy loss in the path computation?
+    bool enable_dipoles;     ///< Account for the dipoles bending?
+    bool enable_kickers;     ///< Account for the kickers?
+    bool compute_apertures;  ///< Account for the acceptance of each element?
+
+    bool operator==(const PropagationContext&) const;
+    bool operator!=(const PropagationContext& oth) const { return !(*this == oth); }
+    /// Hash value of all parameters, for the indexing of memoised quantities
+    size_t hash() const;
+  };
+}  // namespace hector
+
+#endif
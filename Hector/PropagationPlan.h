@@ -0,0 +1,168 @@
+#ifndef Hector_PropagationPlan_h
+#define Hector_PropagationPlan_h
+
+#include "Hector/Elements/ElementBaseFwd.h"
+#include "Hector/Elements/ElementType.h"
+#include "Hector/PropagationContext.h"
+#include "Hector/Apertures/ApertureTable.h"
+#include "Hector/Utils/AlignedAllocator.h"
+#include "Hector/Utils/Matrix6.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hector {
+  class Beamline;
+  /// A compiled, immutable view of a sequenced beamline, ready for propagation
+  /// \note The plan is a snapshot of the beamline content at the time of its construction ; it must be rebuilt
+  ///  whenever any of the beamline elements is modified.
+  class PropagationPlan {
+  public:
+    /// Algorithm to be used for the computation of an element transfer matrix
+    enum class Kernel : unsigned char {
+      drift,                 ///< Simple drift (also for markers, collimators, ...)
+      sectorDipole,          ///< Sector-type dipole
+      rectangularDipole,     ///< Rectangular-type dipole
+      horizontalQuadrupole,  ///< Horizontal-type quadrupole
+      verticalQuadrupole,    ///< Vertical-type quadrupole
+      horizontalKicker,      ///< Horizontal-type kicker
+      verticalKicker,        ///< Vertical-type kicker
+      generic                ///< Any other element (its own transfer matrix computation is used)
+    };
+    /// Flattened properties of a beamline element
+    struct alignas(64) Record {
+      Kernel kernel;            ///< Transfer matrix computation algorithm
+      element::Type type;       ///< Element type
+      aperture::Type aperture;  ///< Aperture type (anInvalidAperture if not restricted ; see apertures for its shape)
+      bool checkpoint;          ///< Kinematics is to be recorded at the entrance and exit of the element?
+      unsigned int name;        ///< Index of the element name in the names table
+      double s;                 ///< Longitudinal position of the element entrance (m)
+      double length;            ///< Element length (m)
+      double k;                 ///< Nominal magnetic strength
+    };
+    /// A run of consecutive elements collapsed into a single transfer map
+    struct Segment {
+      size_t first;    ///< Index of the first element of the run
+      size_t last;     ///< Index of the last element of the run
+      double s_out;    ///< Longitudinal position at the exit of the run (m)
+      Matrix6 matrix;  ///< Composite transfer matrix of all elements in the run
+    };
+    /// Ordered collection of collapsed runs of elements
+    typedef std::vector<Segment> Segments;
+    /// Contiguous collection of element records
+    typedef std::vector<Record, AlignedAllocator<Record> > Records;
+    typedef Records::const_iterator const_iterator;
+
+  public:
+    /// Compile the sequence of elements to be crossed in a beamline
+    /// \param[in] bl A sequenced beamline (see Beamline::sequencedBeamline)
+    /// \param[in] s_max Maximal s-coordinate to be reached (m)
+    PropagationPlan(const Beamline* bl, double s_max);
+
+    /// Maximal s-coordinate to be reached (m)
+    double maxS() const { return s_max_; }
+    /// Number of elements in the original beamline
+    size_t beamlineSize() const { return beamline_size_; }
+
+    /// Number of elements to be crossed
+    size_t size() const { return records_.size(); }
+    /// Retrieve the properties of one element
+    const Record& operator[](size_t i) const { return records_[i]; }
+    /// Iterator to the first element record
+    const_iterator begin() const { return records_.begin(); }
+    /// Iterator to the last element record
+    const_iterator end() const { return records_.end(); }
+
+    /// Compute the transfer matrix for one element
+    /// \param[in] i Element index
+    /// \param[in] length Length of the element portion to be crossed (m)
+    /// \param[in] eloss Particle energy loss (GeV)
+    /// \param[in] mp Particle mass (GeV)
+    /// \param[in] qp Particle charge (e)
+    /// \param[in] ctx Run parameters snapshot
+    Matrix6 matrix(size_t i, double length, double eloss, double mp, int qp, const PropagationContext& ctx) const;
+
+    /// Name of an element
+    const std::string& name(const Record& rec) const { return names_[rec.name]; }
+    /// Original beamline element associated to a record
+    const element::ElementPtr& element(size_t i) const { return elements_[i]; }
+    /// Pre-computed aperture shapes, indexed as the element records
+    const aperture::ApertureTable& apertures() const { return apertures_; }
+
+    /// Enable or disable the propagation through collapsed runs of elements (see segments)
+    void setFusion(bool fusion) { fusion_ = fusion; }
+    /// Are runs of elements collapsed into single transfer maps for the propagation?
+    bool fusion() const { return fusion_; }
+    /// Request the particles kinematics to be recorded around a given s-coordinate (m)
+    /// \note The element containing this position is kept apart from any collapsed run
+    void addObservationPoint(double s);
+    /// List of s-coordinates where the particles kinematics is to be recorded (m)
+    const std::vector<double>& observationPoints() const { return observations_; }
+
+    /// Collapse all runs of consecutive elements between two checkpoints into single transfer maps
+    /// \note Only the positions at the boundaries of the aperture-restricted elements, of the elements holding
+    ///  an observation point, and at the end of the plan are kept. The result is computed once per initial
+    ///  s-coordinate, energy loss, mass, charge and run parameters, and is shared among all particles.
+    /// \param[in] first_s Initial s-coordinate of the particles (m)
+    /// \param[in] eloss Particle energy loss (GeV)
+    /// \param[in] mp Particle mass (GeV)
+    /// \param[in] qp Particle charge (e)
+    /// \param[in] ctx Run parameters snapshot
+    std::shared_ptr<const Segments> segments(
+        double first_s, double eloss, double mp, int qp, const PropagationContext& ctx) const;
+    /// Build the collapsed runs of elements for one set of particle properties, without any memoisation
+    /// \note See segments for the parameters definition
+    Segments fuse(double first_s, double eloss, double mp, int qp, const PropagationContext& ctx) const;
+
+  private:
+
+    /// Memoisation of the collapsed runs of elements
+    /// \note Only the capacity is kept when copied ; the whole content is flushed once the capacity is reached
+    class SegmentsCache {
+    public:
+      explicit SegmentsCache(size_t capacity = 256) : capacity_(capacity) {}
+      SegmentsCache(const SegmentsCache& rhs) : SegmentsCache(rhs.capacity_) {}
+      SegmentsCache& operator=(const SegmentsCache&);
+
+      /// Indexing parameters for a set of collapsed runs
+      struct Key {
+        double first_s, eloss, mp;
+        int qp;
+        PropagationContext ctx;
+        bool operator==(const Key&) const;
+      };
+      /// Retrieve a set of collapsed runs (null if not yet computed)
+      std::shared_ptr<const Segments> find(const Key&) const;
+      /// Store a set of collapsed runs
+      void insert(const Key&, const std::shared_ptr<const Segments>&);
+      /// Remove all sets of collapsed runs
+      void clear();
+
+    private:
+      /// Hashing algorithm for the indexing parameters
+      struct KeyHash {
+        size_t operator()(const Key&) const;
+      };
+      size_t capacity_;
+      mutable std::mutex mutex_;
+      std::unordered_map<Key, std::shared_ptr<const Segments>, KeyHash> segments_;
+    };
+
+    double s_max_;
+    size_t beamline_size_;
+    Records records_;
+    aperture::ApertureTable apertures_;
+    /// Names table
+    std::vector<std::string> names_;
+    /// Original elements (for the "generic" kernel and the error reporting)
+    element::Elements elements_;
+    bool fusion_;
+    std::vector<double> observations_;
+    mutable SegmentsCache segments_cache_;
+  };
+}  // namespace hector
+
+#endif
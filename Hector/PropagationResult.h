@@ -0,0 +1,73 @@
+#ifndef Hector_PropagationResult_h
+#define Hector_PropagationResult_h
+
+#include "Hector/Elements/ElementBaseFwd.h"
+#include "Hector/Utils/StateVector.h"
+
+#include <string>
+#include <iosfwd>
+
+namespace hector {
+  /// Outcome of the propagation of one particle
+  class PropagationResult {
+  public:
+    /// Final status of the propagation
+    enum class Status {
+      success,  ///< Particle reached the requested s-coordinate
+      stopped,  ///< Particle stopped by an element aperture
+      failed    ///< Propagation failed (e.g. unphysical kinematics)
+    };
+
+    /// Index returned when no element stopped the particle
+    static constexpr size_t invalid_index = (size_t)-1;
+
+  public:
+    /// Build a propagation outcome
+    /// \param[in] status Final status of the propagation
+    /// \param[in] elem Beamline element that stopped the particle (if any)
+    /// \param[in] message Human-readable description of the failure (if any)
+    explicit PropagationResult(Status status = Status::success,
+                               const element::ElementPtr& elem = nullptr,
+                               const std::string& message = "")
+        : status_(status), elem_(elem), elem_index_(invalid_index), last_s_(-1.), message_(message) {}
+    /// Build a propagation outcome with the particle kinematics at its last position
+    /// \param[in] status Final status of the propagation
+    /// \param[in] last_s Last s-coordinate reached by the particle (m)
+    /// \param[in] sv Particle state vector at its last position (or where it was stopped)
+    /// \param[in] elem Beamline element that stopped the particle (if any)
+    /// \param[in] elem_index Index of the stopping element in the sequence of elements crossed (if any)
+    PropagationResult(Status status,
+                      double last_s,
+                      const StateVector& sv,
+                      const element::ElementPtr& elem = nullptr,
+                      size_t elem_index = invalid_index)
+        : status_(status), elem_(elem), elem_index_(elem_index), last_s_(last_s), sv_(sv) {}
+
+    /// Final status of the propagation
+    Status status() const { return status_; }
+    /// Has the particle reached the requested s-coordinate?
+    bool success() const { return status_ == Status::success; }
+    /// Beamline element that stopped the particle (if any)
+    const element::ElementPtr& stoppingElement() const { return elem_; }
+    /// Index of the stopping element in the beamline (or in the plan) crossed, if any
+    size_t stoppingElementIndex() const { return elem_index_; }
+    /// Last s-coordinate reached by the particle (m), or the position where it was stopped
+    double lastS() const { return last_s_; }
+    /// Particle state vector at its last position, or where it was stopped
+    const StateVector& stateVector() const { return sv_; }
+    /// Human-readable description of the failure (if any)
+    const std::string& message() const { return message_; }
+
+  private:
+    Status status_;
+    element::ElementPtr elem_;
+    size_t elem_index_;
+    double last_s_;
+    StateVector sv_;
+    std::string message_;
+  };
+  /// Human-readable printout of a propagation status
+  std::ostream& operator<<(std::ostream&, const PropagationResult::Status&);
+}  // namespace hector
+
+#endif
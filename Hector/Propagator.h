@@ -1,32 +1,165 @@
 #ifndef Hector_Propagator_h
 #define Hector_Propagator_h
 
+#include "Hector/HitTable.h"
+#include "Hector/ObservationPlanes.h"
 #include "Hector/Particle.h"
+#include "Hector/PropagationResult.h"
+#include "Hector/PropagationPlan.h"
+
+#include <iosfwd>
 #include <memory>
+#include <vector>
 
 namespace hector {
   class Beamline;
+  class ParticleBatch;
+  class TransferMapTable;
+  class Executor;
   namespace element {
     class ElementBase;
   }
   /// Main object to propagate particles through a beamline
   class Propagator {
+  public:
+    /// Policy for the recording of the particles trajectory
+    enum class Recording {
+      full,               ///< State vectors at each element exit
+      observationPlanes,  ///< State vectors at the registered observation planes only
+      finalState          ///< Final state vector (or the one at the stopping point) only
+    };
+
   public:
     /// Construct the object for a given beamline
-    Propagator(const Beamline* bl) : beamline_(bl) {}
+    /// \param[in] bl Beamline to propagate the particles through
+    /// \param[in] ctx Run parameters snapshot (by default, the current state of the global run parameters)
+    Propagator(const Beamline* bl, const PropagationContext& ctx = PropagationContext::fromParameters())
+        : beamline_(bl), context_(ctx), recording_(Recording::full) {}
     ~Propagator() {}
 
     const Beamline* beamline() const { return beamline_; }
 
+    /// Set the run parameters snapshot used for all propagations
+    void setContext(const PropagationContext& ctx) { context_ = ctx; }
+    /// Run parameters snapshot used for all propagations
+    /// \note Modifications of the global run parameters after the propagator construction are not accounted for
+    const PropagationContext& context() const { return context_; }
+
+    /// Set the policy for the recording of the particles trajectory
+    /// \note The initial position of the particles is always kept
+    void setRecording(Recording rec) { recording_ = rec; }
+    /// Policy for the recording of the particles trajectory
+    Recording recording() const { return recording_; }
+    /// Register an s-coordinate (m) where the particles kinematics is to be recorded
+    /// \note The kinematics is computed exactly at this position, even inside an element
+    void addObservationPlane(double s) { planes_.add(s); }
+    /// Registry of the planes where the particles kinematics is to be recorded (by name, element or s-coordinate)
+    ObservationPlanes& observationPlanes() { return planes_; }
+    /// Registry of the planes where the particles kinematics is to be recorded
+    const ObservationPlanes& observationPlanes() const { return planes_; }
+
     /// Propagate a particle up to a given position ; maps all state vectors to the intermediate s-coordinates
     void propagate(Particle&, double) const;
-    /// Check whether the particle has stopped inside a part of the beamline
+    /// Propagate a particle through a compiled sequence of elements ; maps all intermediate state vectors
+    /// \note Yields results identical to the beamline-based propagation up to the plan maximal s-coordinate.
+    ///  If the plan collapses runs of elements (see PropagationPlan::setFusion), only the state vectors at the
+    ///  boundaries of these runs are mapped.
+    void propagate(Particle&, const PropagationPlan&) const;
+    /// Propagate a particle using the cumulative transfer maps tabulated in momentum loss
+    /// \note Only the state vectors at the table checkpoints are mapped. Particles out of the table validity range
+    ///  (momentum loss, mass, charge, initial s-coordinate or run parameters) are propagated through the plan.
+    void propagate(Particle&, const TransferMapTable&) const;
+    /// Propagate a particle up to a given position, without raising an exception if it is stopped by an aperture
+    /// \return Outcome of the propagation, with the index of the stopping element in the beamline (if any)
+    PropagationResult track(Particle&, double s_max) const;
+    /// Propagate a particle through a compiled sequence of elements, without raising an exception if it is stopped
+    /// \return Outcome of the propagation, with the index of the stopping element in the plan (if any)
+    PropagationResult track(Particle&, const PropagationPlan&) const;
+    /// Propagate a particle using the cumulative transfer maps tabulated in momentum loss, without raising an
+    /// exception if it is stopped
+    /// \return Outcome of the propagation, with the index of the stopping element in the plan (if any)
+    PropagationResult track(Particle&, const TransferMapTable&) const;
+    /// Propagate a particle, and check whether it is stopped by an aperture inside a part of the beamline
+    /// \param[in] s_max Maximal s-coordinate to be reached (m), or the full beamline if negative
+    /// \note The particle trajectory is replaced by the one of this propagation (see track)
     bool stopped(Particle&, double s_max = -1.) const;
 
     /// Propagate a list of particle up to a given position ; maps all state vectors to the intermediate s-coordinates
     void propagate(Particles&, double s_max) const;
+    /// Propagate a list of particles up to a given position, using a pool of worker threads
+    /// \param[in] num_threads Number of worker threads (0 to use all hardware threads)
+    /// \return Outcome of the propagation for each particle, in the same ordering as the input list
+    std::vector<PropagationResult> propagate(Particles&, double s_max, unsigned short num_threads) const;
+    /// Propagate a list of particles up to a given position, using an existing pool of worker threads
+    /// \return Outcome of the propagation for each particle, in the same ordering as the input list
+    std::vector<PropagationResult> propagate(Particles&, double s_max, Executor&) const;
+    /// Propagate a list of particle through a compiled sequence of elements
+    void propagate(Particles&, const PropagationPlan&) const;
+    /// Propagate a list of particles once up to a given position, and collect their kinematics at all observation
+    /// planes
+    /// \note Whatever the recording policy, the particles trajectories only hold their kinematics at the planes
+    HitTable readout(Particles&, double s_max, Executor&) const;
+    /// Propagate a list of particles once through a compiled sequence of elements, and collect their kinematics at
+    /// all observation planes
+    /// \note Whatever the recording policy, the particles trajectories only hold their kinematics at the planes
+    HitTable readout(Particles&, const PropagationPlan&, Executor&) const;
+    /// Propagate a particle through a compiled sequence of elements, and collect its kinematics at all observation
+    /// planes
+    /// \param[out] hits Kinematics at each observation plane, in increasing s-coordinate
+    /// \note Whatever the recording policy, the particle trajectory only holds its kinematics at the planes
+    PropagationResult readout(Particle&, const PropagationPlan&, HitTable::Hit* hits) const;
+    /// Propagate a list of particles using the cumulative transfer maps tabulated in momentum loss
+    void propagate(Particles&, const TransferMapTable&) const;
+    /// Propagate a batch of particles through a compiled sequence of elements ; only the final kinematics is kept
+    /// \note Particles sharing the same energy loss, mass, charge and initial s-coordinate are transported together,
+    ///  through the collapsed runs of elements if the plan enables it (see PropagationPlan::setFusion).
+    ///  Particles stopped by an aperture are flagged in the batch statuses, and keep their kinematics and
+    ///  s-coordinate at the stopping point.
+    void propagate(ParticleBatch&, const PropagationPlan&) const;
 
   private:
+    /// Propagate a particle up to a given position ; failures other than aperture losses are raised
+    PropagationResult transport(Particle&, double s_max) const;
+    /// Propagate a particle through a compiled sequence ; failures other than aperture losses are raised
+    PropagationResult transport(Particle&, const PropagationPlan&) const;
+    /// Propagate a particle using tabulated transfer maps ; failures other than aperture losses are raised
+    PropagationResult transport(Particle&, const TransferMapTable&) const;
+    /// Propagate a particle through the collapsed runs of elements of a compiled sequence
+    PropagationResult propagateSegments(Particle&, const PropagationPlan&, double energy_loss) const;
+    /// Transport a state vector from the entrance of one element of a compiled sequence to a given s-coordinate
+    /// \param[in] first Index of the first element crossed
+    /// \param[in] last Index of the last element that may be crossed
+    Vector6 transportWithin(const PropagationPlan&,
+                            size_t first,
+                            size_t last,
+                            const Vector6& in,
+                            double s,
+                            double energy_loss,
+                            double mp,
+                            int qp) const;
+    /// Check whether a particle is stopped by the aperture of one element of a compiled sequence
+    /// \param[in] in State vector at the element entrance
+    /// \param[in] out State vector at the element exit
+    /// \param[out] result Outcome of the propagation if the particle is stopped
+    /// \return Has the particle been stopped?
+    bool checkAperture(const PropagationPlan&,
+                       size_t i,
+                       const StateVector& in,
+                       const StateVector& out,
+                       PropagationResult& result) const;
+    /// Store the positions of a particle crossing a part of the beamline, according to the recording policy
+    /// \param[in] at Exact state vector at any s-coordinate between the two positions
+    template <typename F>
+    void record(Particle&, const Particle::Position& in, const Particle::Position& out, F at) const;
+    /// Store the final position of a particle, according to the recording policy
+    PropagationResult finalise(Particle&, const PropagationResult&) const;
+    /// Match the trajectory of a particle recorded at the observation planes with the planes, and fill its hits
+    void fillHits(const Particle&, const PropagationResult&, HitTable::Hit* hits) const;
+    /// Propagate a list of particles with the observation planes recording policy, and fill the hits table
+    template <typename F>
+    HitTable readout(Particles&, Executor&, F track) const;
+    /// Raise the exception associated to a particle stopped in the course of its propagation
+    void raise(const PropagationResult&) const;
     /// Extract a particle position at the exit of an element once it enters it
     Particle::Position propagateThrough(const Particle::Position& ini_pos,
                                         const std::shared_ptr<element::ElementBase> ele,
@@ -34,7 +167,12 @@ namespace hector {
                                         int qp) const;
 
     const Beamline* beamline_;  // NOT owning
+    PropagationContext context_;
+    Recording recording_;
+    ObservationPlanes planes_;
   };
+  /// Human-readable printout of a trajectory recording policy
+  std::ostream& operator<<(std::ostream&, const Propagator::Recording&);
 }  // namespace hector
 
 #endif
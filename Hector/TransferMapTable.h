@@ -0,0 +1,126 @@
+#ifndef Hector_TransferMapTable_h
+#define Hector_TransferMapTable_h
+
+#include "Hector/PropagationPlan.h"
+
+#include <iosfwd>
+
+namespace hector {
+  class Executor;
+  class Particle;
+  /// Cumulative transfer maps to each checkpoint of a propagation plan, tabulated on a grid of momentum losses
+  /// \note The energy loss being the only particle property entering the elements transfer matrices, the maps
+  ///  for any \f$ \xi \f$ within the grid are interpolated instead of being computed element by element.
+  ///  The table is built for the primary particles mass and charge, starting at the first element of the plan.
+  class TransferMapTable {
+  public:
+    /// Interpolation algorithm between two grid nodes
+    enum class Interpolation {
+      linear,  ///< Linear interpolation between the two neighbouring nodes
+      cubic    ///< Cubic (Catmull-Rom) interpolation using the four neighbouring nodes
+    };
+    /// Comparison of the interpolated maps with the exact ones
+    struct Accuracy {
+      size_t num_samples;    ///< Number of momentum losses probed
+      double max_abs_diff;   ///< Largest absolute difference between two matrix coefficients
+      double max_rel_diff;   ///< Largest relative difference between two (non-null) matrix coefficients
+      double worst_xi;       ///< Momentum loss at which the largest absolute difference is found
+      size_t worst_segment;  ///< Checkpoint at which the largest absolute difference is found
+    };
+
+  public:
+    /// Tabulate the cumulative transfer maps of a plan
+    /// \param[in] plan Compiled sequence of elements (its checkpoints are the ones used for the tabulation)
+    /// \param[in] xi_min Lowest momentum loss in the grid
+    /// \param[in] xi_max Highest momentum loss in the grid
+    /// \param[in] xi_step Spacing between two grid nodes
+    /// \param[in] exec Pool of worker threads for the grid nodes computation
+    /// \param[in] ctx Run parameters snapshot (by default, the current state of the global run parameters)
+    TransferMapTable(const PropagationPlan& plan,
+                     double xi_min,
+                     double xi_max,
+                     double xi_step,
+                     Executor& exec,
+                     const PropagationContext& ctx = PropagationContext::fromParameters());
+    /// Tabulate the cumulative transfer maps of a plan
+    /// \param[in] num_threads Number of worker threads for the grid nodes computation (0 to use all hardware threads)
+    TransferMapTable(const PropagationPlan& plan,
+                     double xi_min,
+                     double xi_max,
+                     double xi_step,
+                     unsigned short num_threads = 0,
+                     const PropagationContext& ctx = PropagationContext::fromParameters());
+
+    /// Compiled sequence of elements the table is built for
+    const PropagationPlan& plan() const { return plan_; }
+    /// Run parameters the table is built for
+    const PropagationContext& context() const { return context_; }
+    /// Lowest momentum loss in the grid
+    double xiMin() const { return xi_min_; }
+    /// Highest momentum loss in the grid
+    double xiMax() const { return xi_min_ + (num_nodes_ - 1) * xi_step_; }
+    /// Spacing between two grid nodes
+    double xiStep() const { return xi_step_; }
+    /// Number of grid nodes
+    size_t numNodes() const { return num_nodes_; }
+    /// Initial s-coordinate of the particles (m)
+    double firstS() const { return first_s_; }
+    /// Mass of the particles (GeV)
+    double mass() const { return mass_; }
+    /// Charge of the particles (e)
+    int charge() const { return charge_; }
+
+    /// Set the interpolation algorithm between two grid nodes
+    void setInterpolation(Interpolation interp) { interp_ = interp; }
+    /// Interpolation algorithm between two grid nodes
+    Interpolation interpolation() const { return interp_; }
+
+    /// Number of checkpoints (boundaries of the collapsed runs of elements, see PropagationPlan::segments)
+    size_t size() const { return segments_.size(); }
+    /// Properties of the collapsed run of elements leading to one checkpoint
+    /// \note The transfer matrix is the one of the first grid node
+    const PropagationPlan::Segment& segment(size_t i) const { return segments_[i]; }
+    /// Can a particle be propagated with the tabulated maps?
+    /// \note The run parameters must not have changed since the tabulation
+    bool covers(const Particle&, const PropagationContext&) const;
+    /// Interpolated cumulative transfer map from the first element of the plan to one checkpoint
+    /// \param[in] i Checkpoint index
+    /// \param[in] xi Particle momentum loss (within the grid limits)
+    Matrix6 map(size_t i, double xi) const;
+    /// Exact cumulative transfer maps from the first element of the plan to all checkpoints
+    /// \param[in] xi Particle momentum loss
+    std::vector<Matrix6> exactMaps(double xi) const;
+
+    /// Compare the interpolated maps with the exact ones, half-way between grid nodes
+    /// \param[in] num_samples Number of momentum losses to probe (spread over the whole grid)
+    Accuracy accuracy(size_t num_samples = 100) const;
+
+  private:
+    /// Define the grid of momentum losses, without any tabulation
+    TransferMapTable(
+        const PropagationPlan& plan, double xi_min, double xi_max, double xi_step, const PropagationContext& ctx);
+    /// Tabulate the maps at all grid nodes
+    void build(Executor& exec);
+    /// Energy loss as expected by the transfer matrices computation, for a given momentum loss
+    double energyLoss(double xi) const;
+    /// Tabulated map to checkpoint i for grid node j
+    const Matrix6& node(size_t i, size_t j) const { return maps_[i * num_nodes_ + j]; }
+
+    const PropagationPlan& plan_;  // NOT owning
+    PropagationContext context_;
+    double xi_min_, xi_step_;
+    size_t num_nodes_;
+    double first_s_, mass_;
+    int charge_;
+    Interpolation interp_;
+    PropagationPlan::Segments segments_;
+    /// Cumulative maps, grouped by checkpoint
+    std::vector<Matrix6> maps_;
+  };
+  /// Human-readable printout of an interpolation algorithm
+  std::ostream& operator<<(std::ostream&, const TransferMapTable::Interpolation&);
+  /// Human-readable printout of an interpolation accuracy report
+  std::ostream& operator<<(std::ostream&, const TransferMapTable::Accuracy&);
+}  // namespace hector
+
+#endif
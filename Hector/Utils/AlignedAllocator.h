@@ -0,0 +1,46 @@
+#ifndef Hector_Utils_AlignedAllocator_h
+#define Hector_Utils_AlignedAllocator_h
+
+#include <cstdlib>
+#include <new>
+
+namespace hector {
+  /// A standard-compliant allocator returning memory blocks aligned on a given boundary
+  /// \note Required for over-aligned types (e.g. cache line-aligned records) in C++14 containers
+  template <typename T, size_t Alignment = 64>
+  class AlignedAllocator {
+  public:
+    typedef T value_type;
+    template <typename U>
+    struct rebind {
+      typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() noexcept {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /// Allocate an aligned block for n objects
+    T* allocate(size_t n) {
+      if (n == 0)
+        return nullptr;
+      void* ptr = nullptr;
+      if (posix_memalign(&ptr, Alignment, n * sizeof(T)) != 0)
+        throw std::bad_alloc();
+      return static_cast<T*>(ptr);
+    }
+    /// Release an aligned block
+    void deallocate(T* ptr, size_t) noexcept { free(ptr); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+      return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+      return false;
+    }
+  };
+}  // namespace hector
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef Hector_Utils_BatchKernels_h
+#define Hector_Utils_BatchKernels_h
+
+#include "Hector/Apertures/ApertureTable.h"
+#include "Hector/Utils/Matrix6.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hector {
+  /// Vectorised helpers for the propagation of particles batches
+  namespace kernel {
+    /// Apply a transfer matrix to a set of state vectors stored in columns
+    /// \param[in] mat Transfer matrix
+    /// \param[inout] cols Six columns of state vector components (in the StateVector::Components ordering)
+    /// \param[in] n Number of state vectors to be transformed
+    /// \note Components are summed in the same order as for the algebraic matrix-vector product, so that the
+    ///  result is identical to the one of the scalar propagation
+    void applyMatrix(const Matrix6& mat, double* const cols[6], size_t n);
+    /// Test a set of transverse positions against one aperture
+    /// \param[in] aper Pre-computed aperture shape
+    /// \param[in] x Column of horizontal positions (m)
+    /// \param[in] y Column of vertical positions (m)
+    /// \param[in] n Number of positions to be tested
+    /// \param[out] mask Survival bitmask of (n+63)/64 words, with bit k%64 of word k/64 set if the k-th position is
+    ///  contained in the aperture (unused bits of the last word are cleared)
+    void apertureMask(const aperture::ApertureTable::Entry& aper,
+                      const double* x,
+                      const double* y,
+                      size_t n,
+                      uint64_t* mask);
+    /// Name of the instructions set used for the vectorised operations
+    const char* instructionSet();
+  }  // namespace kernel
+}  // namespace hector
+
+#endif
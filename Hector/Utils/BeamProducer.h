@@ -2,10 +2,13 @@
 #define Hector_Utils_BeamProducer
 
 #include "Hector/Particle.h"
+#include "Hector/ParticleBatch.h"
 #include "Hector/Parameters.h"
+#include "Hector/Utils/Random.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
-#include <random>
 
 namespace hector {
   /// Generator for beam of particles
@@ -35,9 +38,18 @@ namespace hector {
       /// Number of particles to generate to perform a full scan
       unsigned short numScanParticles() const { return num_part_; }
       /// Generate a new particle
-      virtual Particle shoot() = 0;
+      Particle shoot();
+      /// Generate the next particles of the scan, appended to a batch
+      void shootN(size_t n, ParticleBatch& batch);
 
     protected:
+      /// Initial kinematics of the k-th particle of the scan
+      virtual StateVector stateVector(unsigned short k) const = 0;
+      /// Value of a scanned parameter for the k-th particle of the scan
+      float scanValue(const params_t& lim, unsigned short k) const {
+        return lim.first + k * (lim.second - lim.first) / (num_part_ - 1);
+      }
+
       /// Number of particles to generate to perform a full scan
       unsigned short num_part_;
       /// Number of particles already generated in the scan
@@ -64,7 +76,9 @@ namespace hector {
       /// \param[in] s_ini initial s position
       Xscanner(unsigned short num_part, float e_ini, float x_min, float x_max, float y = 0., float s_ini = 0.)
           : LinearScanner(num_part, x_min, x_max, y, y, e_ini, e_ini, s_ini) {}
-      Particle shoot() override;
+
+    protected:
+      StateVector stateVector(unsigned short k) const override;
     };
 
     /// Beam of particles to scan the optics following the y axis
@@ -79,7 +93,9 @@ namespace hector {
       /// \param[in] s_ini initial s position
       Yscanner(unsigned short num_part, float e_ini, float y_min, float y_max, float x = 0., float s_ini = 0.)
           : LinearScanner(num_part, y_min, y_max, x, x, e_ini, e_ini, s_ini) {}
-      Particle shoot() override;
+
+    protected:
+      StateVector stateVector(unsigned short k) const override;
     };
 
     /// Beam of particles to scan the optics with respect to the x angle
@@ -94,7 +110,9 @@ namespace hector {
       /// \param[in] s_ini initial s position
       TXscanner(unsigned short num_part, float e_ini, float tx_min, float tx_max, float ty = 0., float s_ini = 0.)
           : LinearScanner(num_part, tx_min, tx_max, ty, ty, e_ini, e_ini, s_ini) {}
-      Particle shoot() override;
+
+    protected:
+      StateVector stateVector(unsigned short k) const override;
     };
 
     /// Beam of particles to scan the optics with respect to the y angle
@@ -109,7 +127,9 @@ namespace hector {
       /// \param[in] s_ini initial s position
       TYscanner(unsigned short num_part, float e_ini, float ty_min, float ty_max, float tx = 0., float s_ini = 0.)
           : LinearScanner(num_part, ty_min, ty_max, tx, tx, e_ini, e_ini, s_ini) {}
-      Particle shoot() override;
+
+    protected:
+      StateVector stateVector(unsigned short k) const override;
     };
     /// Beam of particles to scan the optics with respect to the longitudinal momentum loss
     class Xiscanner : public LinearScanner {
@@ -122,10 +142,37 @@ namespace hector {
       /// \param[in] y vertical particle position
       /// \param[in] s_ini initial s position
       Xiscanner(unsigned short num_part, float xi_min, float xi_max, float x = 0., float y = 0., float s_ini = 0.);
-      Particle shoot() override;
+
+    protected:
+      StateVector stateVector(unsigned short k) const override;
     };
 
+    namespace rnd {
+      /// Flat distribution between two limits
+      struct Uniform {
+        static double sample(random::Stream& rng, double min, double max) { return rng.uniform(min, max); }
+        /// Convert two consecutive uniform draws into two values, as two successive sample calls would
+        static void samplePair(double u1, double u2, const params_t& p1, const params_t& p2, double& v1, double& v2) {
+          v1 = (double)p1.first + ((double)p1.second - p1.first) * u1;
+          v2 = (double)p2.first + ((double)p2.second - p2.first) * u2;
+        }
+      };
+      /// Normal distribution of given mean and standard deviation
+      struct Gaussian {
+        static double sample(random::Stream& rng, double mean, double sigma) { return rng.gaussian(mean, sigma); }
+        /// Convert two consecutive uniform draws into two values, as two successive sample calls would
+        static void samplePair(double u1, double u2, const params_t& p1, const params_t& p2, double& v1, double& v2) {
+          const double radius = std::sqrt(-2. * std::log(u1)), phi = 2. * M_PI * u2;
+          v1 = p1.first + p1.second * radius * std::cos(phi);
+          v2 = p2.first + p2.second * (radius * std::sin(phi));
+        }
+      };
+    }  // namespace rnd
+
     /// A generic templated particle gun
+    /// \note Each particle is generated from its own counter-based random stream (see random::Stream), identified
+    ///  by the gun seed, an event number and the particle index in the event: its kinematics does not depend on the
+    ///  generation order, on the number of threads, nor on the sharding of the production.
     template <class T>
     class ParticleGun {
     public:
@@ -138,20 +185,31 @@ namespace hector {
             tx_(parameters(0., 0.)),
             ty_(parameters(0., 0.)),
             mass_(Parameters::get()->beamParticlesMass()),
-            charge_(Parameters::get()->beamParticlesCharge()) {
-        rngs_[0] = T(s_.first, s_.second);
-        rngs_[1] = T(x_.first, x_.second);
-        rngs_[2] = T(y_.first, y_.second);
-        rngs_[3] = T(tx_.first, tx_.second);
-        rngs_[4] = T(ty_.first, ty_.second);
-        rngs_[5] = T(e_.first, e_.second);
-      }
+            charge_(Parameters::get()->beamParticlesCharge()),
+            seed_(0),
+            num_shot_(0) {}
 
-      /// Generate one particle according to the templated distribution
+      /// Set the seed of the random streams
+      void setSeed(uint64_t seed) { seed_ = seed; }
+      /// Seed of the random streams
+      uint64_t seed() const { return seed_; }
+
+      /// Generate the next particle according to the templated distribution
+      /// \note The n-th particle shot is identical to the one generated by shoot(0, n)
       Particle shoot() {
+        const uint64_t num = num_shot_++;
+        return shoot(num >> 32, (uint32_t)num);
+      }
+      /// Generate one particle of one event according to the templated distribution
+      /// \note This generation is stateless, and can hence be called concurrently from multiple threads
+      /// \param[in] event Event number
+      /// \param[in] index Particle index in the event
+      Particle shoot(uint64_t event, uint32_t index) const {
+        random::Stream rng(seed_, event, index);
         StateVector vec;
-        const float s = rngs_[0](gen_), x = rngs_[1](gen_), y = rngs_[2](gen_), tx = rngs_[3](gen_),
-                    ty = rngs_[4](gen_), e = rngs_[5](gen_);
+        const float s = T::sample(rng, s_.first, s_.second), x = T::sample(rng, x_.first, x_.second),
+                    y = T::sample(rng, y_.first, y_.second), tx = T::sample(rng, tx_.first, tx_.second),
+                    ty = T::sample(rng, ty_.first, ty_.second), e = T::sample(rng, e_.first, e_.second);
         vec.setPosition(TwoVector(x, y));
         vec.setAngles(TwoVector(tx, ty));
         vec.setM(mass_);
@@ -161,6 +219,55 @@ namespace hector {
         p.setCharge(charge_);
         return p;
       }
+      /// Generate the next particles, appended to a batch
+      /// \note The generated particles are identical to the ones of n successive shoot() calls
+      void shootN(size_t n, ParticleBatch& batch) {
+        while (n > 0) {
+          // split the production at the event boundaries of the sequential numbering
+          const uint32_t index = (uint32_t)num_shot_;
+          const size_t num = (size_t)std::min<uint64_t>(n, (1ull << 32) - index);
+          shootN(num_shot_ >> 32, index, num, batch);
+          num_shot_ += num;
+          n -= num;
+        }
+      }
+      /// Generate consecutive particles of one event, appended to a batch
+      /// \note The generated particles are identical to the ones of shoot(event, first + i) calls, but the random
+      ///  draws are vectorised over the particles, and no per-particle object is allocated
+      /// \param[in] event Event number
+      /// \param[in] first Index of the first particle in the event
+      /// \param[in] n Number of particles to generate
+      /// \param[out] batch Collection of particles to be filled
+      void shootN(uint64_t event, uint32_t first, size_t n, ParticleBatch& batch) const {
+        const size_t offset = batch.size();
+        batch.resize(offset + n);
+        double *s = batch.s() + offset, *x = batch.x() + offset, *y = batch.y() + offset, *tx = batch.tx() + offset,
+               *ty = batch.ty() + offset, *e = batch.energy() + offset;
+        std::fill(batch.kick() + offset, batch.kick() + offset + n, 1.);
+        std::fill(batch.mass() + offset, batch.mass() + offset + n, mass_);
+        std::fill(batch.charge() + offset, batch.charge() + offset + n, (int)charge_);
+        // uniform draws by chunks of particles, converted pairwise into the (s, x), (y, tx), and (ty, e) values
+        static constexpr size_t chunk = 256;
+        double unif[6][chunk];
+        double* const cols[6] = {unif[0], unif[1], unif[2], unif[3], unif[4], unif[5]};
+        for (size_t begin = 0; begin < n; begin += chunk) {
+          const size_t num = std::min(chunk, n - begin);
+          random::Stream::uniformColumns(seed_, event, first + (uint32_t)begin, num, 6, cols);
+          for (size_t i = 0; i < num; ++i) {
+            double v1, v2;
+            // values rounded to single precision, as for the single particle generation
+            T::samplePair(unif[0][i], unif[1][i], s_, x_, v1, v2);
+            s[begin + i] = (float)v1;
+            x[begin + i] = (float)v2;
+            T::samplePair(unif[2][i], unif[3][i], y_, tx_, v1, v2);
+            y[begin + i] = (float)v1;
+            tx[begin + i] = (float)v2;
+            T::samplePair(unif[4][i], unif[5][i], ty_, e_, v1, v2);
+            ty[begin + i] = (float)v1;
+            e[begin + i] = (float)v2;
+          }
+        }
+      }
 
       //----- Full beam information
 
@@ -213,22 +320,14 @@ namespace hector {
       /// Translate lower and upper limits into parameters to give to the random generator
       params_t parameters(float lim1, float lim2) { return params_t(lim1, lim2); }
 
-      std::array<T, 6> rngs_;
-      std::default_random_engine gen_;
       params_t e_, s_;
       params_t x_, y_;
       params_t tx_, ty_;
       float mass_, charge_;
+      uint64_t seed_;
+      /// Number of particles generated through the sequential interface
+      uint64_t num_shot_;
     };
-
-    namespace rnd {
-      struct Uniform : std::uniform_real_distribution<double> {
-        explicit Uniform(double min = 0., double max = 1.) : std::uniform_real_distribution<double>(min, max) {}
-      };
-      struct Gaussian : std::normal_distribution<double> {
-        explicit Gaussian(double mean = 0., double stddev = 1.) : std::normal_distribution<double>(mean, stddev) {}
-      };
-    }  // namespace rnd
     /// Beam of particles with flat s, x, y, Tx, Ty and energy distributions
     typedef ParticleGun<rnd::Uniform> FlatParticleGun;
     /// Beam of particles with gaussian s, x, y, Tx, Ty and energy distributions
@@ -0,0 +1,131 @@
+#ifndef Hector_Utils_BoundedQueue_h
+#define Hector_Utils_BoundedQueue_h
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace hector {
+  /// Fixed-capacity, lock-free multi-producer/multi-consumer queue
+  /// \note Each slot carries a sequence number telling whether it is ready to be written or read (D. Vyukov's
+  ///  bounded MPMC queue), so that producers and consumers only contend on their own position counter.
+  ///  Blocking operations back off while the queue is full (respectively empty), until it is closed.
+  template <typename T>
+  class BoundedQueue {
+  public:
+    /// Build a queue
+    /// \param[in] capacity Minimal number of elements held (rounded up to the next power of two)
+    explicit BoundedQueue(size_t capacity) : mask_(roundUp(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+      for (size_t i = 0; i <= mask_; ++i)
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+      enqueue_pos_.store(0, std::memory_order_relaxed);
+      dequeue_pos_.store(0, std::memory_order_relaxed);
+      closed_.store(false, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /// Maximal number of elements held
+    size_t capacity() const { return mask_ + 1; }
+
+    /// Add an element if the queue is not full
+    bool tryPush(T& val) {
+      Cell* cell;
+      size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+      while (true) {
+        cell = &cells_[pos & mask_];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+        if (diff == 0) {
+          if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        } else if (diff < 0)
+          return false;  // full
+        else
+          pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+      cell->data = std::move(val);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+    /// Retrieve an element if the queue is not empty
+    bool tryPop(T& val) {
+      Cell* cell;
+      size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+      while (true) {
+        cell = &cells_[pos & mask_];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+        if (diff == 0) {
+          if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        } else if (diff < 0)
+          return false;  // empty
+        else
+          pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+      val = std::move(cell->data);
+      cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Add an element, waiting for a free slot if the queue is full
+    /// \return False if the queue was closed before the element could be added
+    bool push(T& val) {
+      for (unsigned int attempt = 0; !tryPush(val); ++attempt) {
+        if (closed())
+          return false;
+        backoff(attempt);
+      }
+      return true;
+    }
+    /// Retrieve an element, waiting for one to be available if the queue is empty
+    /// \return False if the queue is closed and drained
+    bool pop(T& val) {
+      for (unsigned int attempt = 0; !tryPop(val); ++attempt) {
+        // the queue may have been filled right before its closure
+        if (closed())
+          return tryPop(val);
+        backoff(attempt);
+      }
+      return true;
+    }
+
+    /// Forbid any further addition, and release all waiting producers and consumers
+    /// \note For all elements to be consumed, the queue is to be closed once all producers are done
+    void close() { closed_.store(true, std::memory_order_release); }
+    /// Has the queue been closed?
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      T data;
+    };
+    static size_t roundUp(size_t num) {
+      size_t cap = 2;
+      while (cap < num)
+        cap <<= 1;
+      return cap;
+    }
+    /// Wait before the next attempt: yield first, then sleep for increasing durations
+    static void backoff(unsigned int attempt) {
+      if (attempt < 64)
+        std::this_thread::yield();
+      else
+        std::this_thread::sleep_for(std::chrono::microseconds(std::min(attempt - 63, 1000u)));
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    /// Producers and consumers positions, on separate cache lines
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+    alignas(64) std::atomic<bool> closed_;
+  };
+}  // namespace hector
+
+#endif
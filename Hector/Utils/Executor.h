@@ -0,0 +1,70 @@
+#ifndef Hector_Utils_Executor_h
+#define Hector_Utils_Executor_h
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hector {
+  /// A pool of worker threads sharing ranges of work through a work-stealing scheduler
+  /// \note Each worker processes the ranges of its own queue first, then steals from the other workers' queues
+  class Executor {
+  public:
+    /// Operation to be performed on a range of indices [begin, end)
+    typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+  public:
+    /// Build a pool of workers
+    /// \param[in] num_threads Number of worker threads (0 to use all hardware threads)
+    explicit Executor(unsigned short num_threads = 0);
+    ~Executor();
+
+    /// Number of worker threads
+    size_t size() const { return std::max<size_t>(threads_.size(), 1); }
+
+    /// Process all indices in [0, num) in parallel, and wait for the completion of all ranges
+    /// \param[in] num Number of indices to process
+    /// \param[in] grain Maximal number of indices per range (0 for an automatic choice)
+    /// \param[in] func Operation to be performed on each range
+    /// \note The first exception raised in any of the ranges is rethrown once all ranges are processed
+    void parallelFor(size_t num, size_t grain, const RangeFunction& func);
+
+  private:
+    /// A range of indices to be processed
+    struct Task {
+      size_t begin, end;
+      const RangeFunction* func;
+    };
+    /// Queue of tasks associated to one worker
+    struct Queue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+    /// Main loop of one worker
+    void work(size_t id);
+    /// Retrieve a task from the worker own queue, or steal one from another queue
+    bool next(size_t id, Task& task);
+    /// Process one task and update the job completion
+    void run(const Task& task);
+
+    std::vector<std::thread> threads_;
+    std::vector<std::unique_ptr<Queue> > queues_;
+    /// Serialise the submission of concurrent jobs
+    std::mutex submit_mutex_;
+    std::mutex job_mutex_;
+    std::condition_variable job_cv_, done_cv_;
+    unsigned long long job_id_;
+    bool stop_;
+    std::atomic<size_t> remaining_;
+    std::exception_ptr exception_;
+  };
+}  // namespace hector
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef Hector_Utils_Hash_h
+#define Hector_Utils_Hash_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace hector {
+  /// Incremental 64-bit FNV-1a hash of a sequence of bytes
+  /// \note Unlike std::hash, the value is stable across compilers and runs, and can hence be persisted (e.g. to
+  ///  identify the content of a cache file). Values are hashed through their in-memory representation.
+  class Hash {
+  public:
+    Hash() : value_(offset_basis) {}
+
+    /// Add a sequence of bytes to the hash
+    Hash& add(const void* data, size_t size) {
+      const auto* bytes = static_cast<const unsigned char*>(data);
+      for (size_t i = 0; i < size; ++i)
+        value_ = (value_ ^ bytes[i]) * prime;
+      return *this;
+    }
+    /// Add a large sequence of bytes to the hash, eight at a time
+    /// \note Several times faster than add() for large buffers (e.g. a whole file content), but yielding another value
+    Hash& addBlock(const void* data, size_t size) {
+      const auto* bytes = static_cast<const unsigned char*>(data);
+      const size_t num_words = size / sizeof(uint64_t);
+      for (size_t i = 0; i < num_words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        value_ = (value_ ^ word) * prime;
+      }
+      return add(bytes + num_words * sizeof(uint64_t), size % sizeof(uint64_t));
+    }
+    /// Add an arithmetic or enumerated value to the hash
+    template <typename T>
+    Hash& add(const T& val) {
+      static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only plain values can be hashed.");
+      return add(&val, sizeof(T));
+    }
+    /// Add a string (and its length) to the hash
+    Hash& add(const std::string& str) {
+      add(str.size());
+      return add(str.data(), str.size());
+    }
+    /// Current hash value
+    uint64_t value() const { return value_; }
+
+  private:
+    static constexpr uint64_t offset_basis = 0xcbf29ce484222325ull;
+    static constexpr uint64_t prime = 0x100000001b3ull;
+    uint64_t value_;
+  };
+}  // namespace hector
+
+#endif
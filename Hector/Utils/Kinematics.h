@@ -3,8 +3,16 @@
 
 namespace hector {
   class Particle;
+  namespace random {
+    class Stream;
+  }
   /// Let the particle emit a photon
+  /// \note The azimuthal angle is drawn from a per-thread random stream, with a reserved key distinct from the
+  ///  default particle guns seed ; use the overload below for a reproducible generation
   void emitGamma(Particle& part_in, double e_gamma, double q2_gamma, double phi_min, double phi_max);
+  /// Let the particle emit a photon, with its azimuthal angle drawn from a given random stream
+  void emitGamma(
+      Particle& part_in, double e_gamma, double q2_gamma, double phi_min, double phi_max, random::Stream& rng);
   /// Convert a particle energy to its momentum loss
   double e_to_xi(double energy, double e0 = -1.);
   /// Convert a particle momentum loss to its energy
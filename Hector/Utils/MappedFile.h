@@ -0,0 +1,35 @@
+#ifndef Hector_Utils_MappedFile_h
+#define Hector_Utils_MappedFile_h
+
+#include <cstddef>
+#include <string>
+
+namespace hector {
+  /// Read-only memory mapping of a whole file
+  /// \note The file content is paged in on demand by the operating system, and can be accessed without any copy
+  class MappedFile {
+  public:
+    /// Map a file into memory
+    explicit MappedFile(const std::string& path);
+    MappedFile(MappedFile&&);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /// Path to the mapped file
+    const std::string& path() const { return path_; }
+    /// Beginning of the file content
+    const char* data() const { return data_; }
+    /// File size (in bytes)
+    size_t size() const { return size_; }
+    /// Is the file empty?
+    bool empty() const { return size_ == 0; }
+
+  private:
+    std::string path_;
+    const char* data_;
+    size_t size_;
+  };
+}  // namespace hector
+
+#endif
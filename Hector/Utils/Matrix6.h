@@ -0,0 +1,122 @@
+#ifndef Hector_Utils_Matrix6_h
+#define Hector_Utils_Matrix6_h
+
+#include "Hector/Utils/Algebra.h"
+
+#include <iosfwd>
+
+namespace hector {
+  /// Fixed-size, stack-allocated 6-vector of double-precision floats
+  /// \note Components are indexed from 0, in the StateVector::Components ordering
+  class Vector6 {
+  public:
+    /// Build a null vector
+    constexpr Vector6() : v_{} {}
+    /// Build a vector from its six components
+    constexpr Vector6(double v0, double v1, double v2, double v3, double v4, double v5) : v_{v0, v1, v2, v3, v4, v5} {}
+    /// Build a 6-vector from an equivalent (6-dimensional) algebraic vector
+    explicit Vector6(const Vector&);
+
+    /// Equivalent algebraic vector
+    Vector toVector() const;
+
+    /// i-th component of the vector
+    constexpr double& operator[](size_t i) { return v_[i]; }
+    /// i-th component of the vector
+    constexpr const double& operator[](size_t i) const { return v_[i]; }
+    /// Pointer to the six components
+    constexpr const double* data() const { return v_; }
+
+    bool operator==(const Vector6& rhs) const;
+    bool operator!=(const Vector6& rhs) const { return !(*this == rhs); }
+
+    /// Component-wise sum of two vectors
+    constexpr Vector6 operator+(const Vector6& rhs) const {
+      Vector6 out;
+      for (size_t i = 0; i < 6; ++i)
+        out.v_[i] = v_[i] + rhs.v_[i];
+      return out;
+    }
+    /// Component-wise difference of two vectors
+    constexpr Vector6 operator-(const Vector6& rhs) const {
+      Vector6 out;
+      for (size_t i = 0; i < 6; ++i)
+        out.v_[i] = v_[i] - rhs.v_[i];
+      return out;
+    }
+
+  private:
+    double v_[6];
+  };
+
+  /// Fixed-size, stack-allocated 6x6 matrix of double-precision floats
+  /// \note Coefficients are indexed from 0 and stored row-major
+  class Matrix6 {
+  public:
+    /// Build a null matrix
+    constexpr Matrix6() : m_{} {}
+    /// Build a 6x6 matrix from an equivalent (6x6) algebraic matrix
+    explicit Matrix6(const Matrix&);
+
+    /// Identity matrix
+    static constexpr Matrix6 identity() {
+      Matrix6 out;
+      for (size_t i = 0; i < 6; ++i)
+        out.m_[i * 7] = 1.;
+      return out;
+    }
+    /// Transfer matrix of a drift of a given length
+    static constexpr Matrix6 drift(double length) {
+      Matrix6 out = identity();
+      out(0, 1) = length;
+      out(2, 3) = length;
+      return out;
+    }
+
+    /// Equivalent algebraic matrix
+    Matrix toMatrix() const;
+
+    /// Coefficient at row i and column j
+    constexpr double& operator()(size_t i, size_t j) { return m_[i * 6 + j]; }
+    /// Coefficient at row i and column j
+    constexpr const double& operator()(size_t i, size_t j) const { return m_[i * 6 + j]; }
+    /// Pointer to the 36 (row-major) coefficients
+    constexpr const double* data() const { return m_; }
+
+    bool operator==(const Matrix6& rhs) const;
+    bool operator!=(const Matrix6& rhs) const { return !(*this == rhs); }
+
+    /// Matrix product
+    /// \note Terms are summed in the same order as for the algebraic matrices product, for identical roundings
+    constexpr Matrix6 operator*(const Matrix6& rhs) const {
+      Matrix6 out;
+      for (size_t i = 0; i < 6; ++i)
+        for (size_t j = 0; j < 6; ++j)
+          out.m_[i * 6 + j] = row(i, rhs.m_ + j, 6);
+      return out;
+    }
+    /// Application of the matrix to a 6-vector
+    /// \note Terms are summed in the same order as for the algebraic matrix-vector product, for identical roundings
+    constexpr Vector6 operator*(const Vector6& vec) const {
+      const double* v = vec.data();
+      return Vector6(row(0, v, 1), row(1, v, 1), row(2, v, 1), row(3, v, 1), row(4, v, 1), row(5, v, 1));
+    }
+
+  private:
+    /// Scalar product of the i-th row with a (strided) column
+    constexpr double row(size_t i, const double* col, size_t stride) const {
+      const double* r = m_ + i * 6;
+      return 0. + r[0] * col[0] + r[1] * col[stride] + r[2] * col[2 * stride] + r[3] * col[3 * stride] +
+             r[4] * col[4 * stride] + r[5] * col[5 * stride];
+    }
+
+    double m_[36];
+  };
+
+  /// Human-readable printout of a 6-vector
+  std::ostream& operator<<(std::ostream&, const Vector6&);
+  /// Human-readable printout of a 6x6 matrix
+  std::ostream& operator<<(std::ostream&, const Matrix6&);
+}  // namespace hector
+
+#endif
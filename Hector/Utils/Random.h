@@ -0,0 +1,113 @@
+#ifndef Hector_Utils_Random_h
+#define Hector_Utils_Random_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hector {
+  /// Counter-based random number generation
+  /// \note Each random number is a pure function of a key (the global seed) and of a counter (the stream
+  ///  identifiers and the position within the stream). The sequence drawn for a given particle of a given event is
+  ///  hence independent of the order in which events and particles are generated, of the number of threads, and of
+  ///  the way the production is sharded.
+  namespace random {
+    /// Philox4x32-10 block function (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11)
+    class Philox {
+    public:
+      typedef std::array<uint32_t, 4> Counter;
+      typedef std::array<uint32_t, 2> Key;
+      /// Compute the random block associated to a counter and a key
+      static Counter generate(Counter ctr, Key key) {
+        for (unsigned short i = 0; i < 10; ++i) {
+          const uint64_t prod0 = (uint64_t)mul0 * ctr[0], prod1 = (uint64_t)mul1 * ctr[2];
+          ctr = Counter{{(uint32_t)(prod1 >> 32) ^ ctr[1] ^ key[0],
+                         (uint32_t)prod1,
+                         (uint32_t)(prod0 >> 32) ^ ctr[3] ^ key[1],
+                         (uint32_t)prod0}};
+          key[0] += weyl0;
+          key[1] += weyl1;
+        }
+        return ctr;
+      }
+
+      static constexpr uint32_t mul0 = 0xd2511f53, mul1 = 0xcd9e8d57;
+      static constexpr uint32_t weyl0 = 0x9e3779b9, weyl1 = 0xbb67ae85;
+    };
+
+    /// Reproducible stream of random numbers, identified by a seed, a stream, and a sub-stream index
+    /// \note Typically, the stream index is the event number and the sub-stream index the particle number within
+    ///  the event. Each sub-stream holds up to \f$ 2^{34} \f$ 32-bit random words.
+    ///  The object fulfills the UniformRandomBitGenerator requirements, and can hence feed the standard library
+    ///  distributions (although their algorithms, and hence their output, are implementation-defined).
+    class Stream {
+    public:
+      typedef uint64_t result_type;
+
+    public:
+      /// Build a stream
+      /// \param[in] seed Global seed of the production
+      /// \param[in] stream Stream index (e.g. event number)
+      /// \param[in] substream Sub-stream index (e.g. particle number in the event)
+      explicit Stream(uint64_t seed = 0, uint64_t stream = 0, uint32_t substream = 0)
+          : key_{{(uint32_t)seed, (uint32_t)(seed >> 32)}},
+            ctr_{{0, substream, (uint32_t)stream, (uint32_t)(stream >> 32)}},
+            num_used_(4),
+            has_spare_(false) {}
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+      /// Draw 64 random bits
+      result_type operator()() {
+        const uint64_t high = next();
+        return (high << 32) | next();
+      }
+      /// Move to a given position (in 32-bit words) in the sub-stream
+      void seek(uint64_t pos);
+      /// Draw a uniformly distributed number in ]0, 1[
+      double uniform() { return toUniform((*this)()); }
+      /// Draw a uniformly distributed number in ]min, max[
+      double uniform(double min, double max) { return min + (max - min) * uniform(); }
+      /// Draw a normally distributed number (Box-Muller transformation)
+      double gaussian(double mean = 0., double sigma = 1.);
+
+      /// Draw the first uniform numbers of a range of consecutive sub-streams at once
+      /// \note The Philox rounds are evaluated for many sub-streams in parallel, in a vectorisable way
+      /// \param[in] seed Global seed of the production
+      /// \param[in] stream Stream index
+      /// \param[in] first Index of the first sub-stream
+      /// \param[in] n Number of sub-streams
+      /// \param[in] num_draws Number of uniform draws per sub-stream
+      /// \param[out] out num_draws columns of n values, with out[j][i] identical to the j-th uniform() draw of
+      ///  Stream(seed, stream, first + i)
+      static void uniformColumns(
+          uint64_t seed, uint64_t stream, uint32_t first, size_t n, unsigned short num_draws, double* const* out);
+
+    private:
+      /// \f$ 2^{-53} \f$, resolution of the uniform draws
+      static constexpr double inv_2_53 = 1.1102230246251565404e-16;
+      /// Convert 64 random bits into a uniformly distributed number in ]0, 1[
+      static double toUniform(uint64_t bits) { return ((bits >> 11) + 0.5) * inv_2_53; }
+      /// Draw the next 32-bit random word
+      uint32_t next() {
+        if (num_used_ == 4) {
+          block_ = Philox::generate(ctr_, key_);
+          ++ctr_[0];
+          num_used_ = 0;
+        }
+        return block_[num_used_++];
+      }
+
+      Philox::Key key_;
+      /// Counter of the next block, with the block index in its first word
+      Philox::Counter ctr_;
+      Philox::Counter block_;
+      unsigned short num_used_;
+      bool has_spare_;
+      double spare_;
+    };
+  }  // namespace random
+}  // namespace hector
+
+#endif
@@ -1,11 +1,11 @@
 #ifndef Hector_Utils_StateVector_h
 #define Hector_Utils_StateVector_h
 
-#include "Hector/Utils/Algebra.h"
+#include "Hector/Utils/Matrix6.h"
 
 namespace hector {
   /// Six-dimensional state vector associated to a particle at a given s
-  class StateVector : private Vector {
+  class StateVector {
   public:
     /// Human-readable enumeration of the 6 state vector coordinates
     enum Components { X = 0, TX = 1, Y = 2, TY = 3, E = 4, K = 5 };
@@ -18,6 +18,10 @@ namespace hector {
     /// \param[in] vec A 6-component vector
     /// \param[in] mass Particle mass (GeV)
     StateVector(const Vector& vec, double mass);
+    /// Build a state using a 6-component vector and a particle mass
+    /// \param[in] vec A 6-component vector
+    /// \param[in] mass Particle mass (GeV)
+    StateVector(const Vector6& vec, double mass) : vec_(vec), m_(mass) {}
     /// Build a state using a particle kinematics and position
     /// \param[in] mom Four-momentum of the particle (GeV)
     /// \param[in] pos x-y position of the particle (m)
@@ -27,20 +31,20 @@ namespace hector {
     ~StateVector() {}
 
     /// Get the 6-vector associated to this state
-    const Vector& vector() const { return *this; }
+    const Vector6& vector() const { return vec_; }
 
     /// Set the particle energy (in GeV)
-    void setEnergy(double energy) { (*this)[E] = energy; }
+    void setEnergy(double energy) { vec_[E] = energy; }
     /// Particle energy (in GeV)
-    double energy() const { return (*this)[E]; }
+    double energy() const { return vec_[E]; }
     /// Set the energy loss \f$ \xi \f$
     void setXi(double xi);
     /// Energy loss \f$ \xi \f$
     double xi() const;
     /// Set the particle kick
-    void setKick(double kick) { (*this)[K] = kick; }
+    void setKick(double kick) { vec_[K] = kick; }
     /// Particle kick
-    double kick() const { return (*this)[K]; }
+    double kick() const { return vec_[K]; }
 
     /// Fill the components of a state according to the particle position
     void setPosition(double x, double y);
@@ -49,13 +53,13 @@ namespace hector {
     /// x-y position of a particle (in m)
     TwoVector position() const;
     /// Set the horizontal position (in m)
-    void setX(double x) { (*this)[X] = x; }
+    void setX(double x) { vec_[X] = x; }
     /// Horizontal position (in m)
-    double x() const { return (*this)[X]; }
+    double x() const { return vec_[X]; }
     /// Set the vertical position (in m)
-    void setY(double y) { (*this)[Y] = y; }
+    void setY(double y) { vec_[Y] = y; }
     /// Vertical position (in m)
-    double y() const { return (*this)[Y]; }
+    double y() const { return vec_[Y]; }
 
     /// Fill the components of a state according to the particle x'-y' angles (in rad)
     void setAngles(double tx, double ty);
@@ -64,11 +68,11 @@ namespace hector {
     /// x'-y' polar angles of a particles (in rad)
     TwoVector angles() const;
     /// Set the horizontal angle (in rad)
-    void setTx(double tx) { (*this)[TX] = tx; }
+    void setTx(double tx) { vec_[TX] = tx; }
     /// Horizontal angle (in rad)
     double Tx() const { return angles().x(); }
     /// Set the vertical angle (in rad)
-    void setTy(double ty) { (*this)[TY] = ty; }
+    void setTy(double ty) { vec_[TY] = ty; }
     /// Vertical angle (in rad)
     double Ty() const { return angles().y(); }
 
@@ -84,6 +88,7 @@ namespace hector {
     double m() const { return m_; }
 
   private:
+    Vector6 vec_;
     double m_;
   };
   /// Human-readable printout of the state vector
@@ -0,0 +1,212 @@
+#ifndef Hector_Utils_StreamingPipeline_h
+#define Hector_Utils_StreamingPipeline_h
+
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/BoundedQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hector {
+  /// Streaming runtime chaining the production, the processing and the consumption of events of any type
+  /// \note Events are produced by a source in a dedicated thread, processed by a pool of workers, and handed to a
+  ///  sink in the calling thread. The stages are connected by bounded lock-free queues of event batches: a slow stage
+  ///  applies back-pressure to the upstream ones. The source waits for the sink whenever more than (queue size +
+  ///  number of workers) batches are in flight (including the ones held back to restore the ordering), so that the
+  ///  memory in use does not depend on the sample size.
+  template <typename T>
+  class StreamingPipeline {
+  public:
+    /// Producer of events, filling a default-constructed event
+    /// \return False once the source is exhausted
+    typedef std::function<bool(T&)> Source;
+    /// Operation performed by one worker on each event
+    typedef std::function<void(T&)> Process;
+    /// Builder of the operation of one worker, called once in its own thread
+    typedef std::function<Process()> ProcessBuilder;
+    /// Consumer of processed events
+    typedef std::function<void(T&)> Sink;
+
+  public:
+    StreamingPipeline()
+        : num_workers_(std::max(std::thread::hardware_concurrency(), 1u)),
+          batch_size_(16),
+          queue_size_(64),
+          ordered_(false),
+          max_events_(0) {}
+
+    /// Set the number of processing workers (0 to use all hardware threads)
+    StreamingPipeline& setNumWorkers(unsigned short num) {
+      num_workers_ = (num > 0) ? num : std::max(std::thread::hardware_concurrency(), 1u);
+      return *this;
+    }
+    /// Set the number of events transferred at once between the stages
+    StreamingPipeline& setBatchSize(size_t num) {
+      if (num == 0)
+        throw H_ERROR << "Invalid events batch size: " << num << ".";
+      batch_size_ = num;
+      return *this;
+    }
+    /// Set the maximal number of batches waiting between two stages
+    StreamingPipeline& setQueueSize(size_t num) {
+      if (num == 0)
+        throw H_ERROR << "Invalid queue size: " << num << ".";
+      queue_size_ = num;
+      return *this;
+    }
+    /// Hand the events to the sink in the source ordering?
+    /// \note Otherwise, events are consumed as soon as they are processed
+    StreamingPipeline& setOrdered(bool ordered) {
+      ordered_ = ordered;
+      return *this;
+    }
+    /// Set the maximal number of events to be produced (0 for no limit)
+    StreamingPipeline& setMaxEvents(uint64_t num) {
+      max_events_ = num;
+      return *this;
+    }
+
+    /// Process all events from a source
+    /// \note The first exception raised in any of the stages aborts the processing, and is rethrown
+    /// \return Number of events consumed
+    uint64_t run(const Source& source, const ProcessBuilder& process, const Sink& sink) const {
+      BoundedQueue<Batch> input(queue_size_), output(queue_size_);
+
+      // credits for the batches in flight, including the ones held back by the sink to restore the ordering
+      const uint64_t max_in_flight = queue_size_ + num_workers_;
+      std::mutex credit_mutex;
+      std::condition_variable credit_released;
+      uint64_t num_released = 0;
+
+      // first failure in any stage, aborting all others
+      std::mutex error_mutex;
+      std::exception_ptr error;
+      const auto abort = [&]() {
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+        input.close();
+        output.close();
+        std::lock_guard<std::mutex> lock(credit_mutex);
+        credit_released.notify_all();
+      };
+
+      // source stage
+      std::thread producer([&]() {
+        try {
+          uint64_t num_events = 0;
+          for (uint64_t index = 0; !input.closed(); ++index) {
+            {  // wait for the sink to be handed enough batches
+              std::unique_lock<std::mutex> lock(credit_mutex);
+              credit_released.wait(lock, [&]() { return index < num_released + max_in_flight || input.closed(); });
+            }
+            Batch batch{index, {}};
+            batch.events.reserve(batch_size_);
+            while (batch.events.size() < batch_size_ && (max_events_ == 0 || num_events < max_events_)) {
+              T evt{};
+              if (!source(evt))
+                break;
+              batch.events.emplace_back(std::move(evt));
+              ++num_events;
+            }
+            const bool last = batch.events.size() < batch_size_;
+            if (!batch.events.empty() && !input.push(batch))
+              break;
+            if (last)
+              break;
+          }
+          input.close();
+        } catch (...) {
+          abort();
+        }
+      });
+
+      // processing stage
+      std::atomic<unsigned short> num_running(num_workers_);
+      std::vector<std::thread> workers;
+      for (unsigned short i = 0; i < num_workers_; ++i)
+        workers.emplace_back([&]() {
+          try {
+            const auto proc = process();
+            Batch batch;
+            while (input.pop(batch)) {
+              for (auto& evt : batch.events)
+                proc(evt);
+              if (!output.push(batch))
+                break;
+            }
+          } catch (...) {
+            abort();
+          }
+          // the last worker done releases the sink
+          if (--num_running == 0)
+            output.close();
+        });
+
+      // consumption stage, in the calling thread
+      uint64_t num_consumed = 0;
+      const auto consume = [&](Batch& batch) {
+        for (auto& evt : batch.events)
+          sink(evt);
+        num_consumed += batch.events.size();
+        {
+          std::lock_guard<std::mutex> lock(credit_mutex);
+          ++num_released;
+        }
+        credit_released.notify_one();
+      };
+      try {
+        std::map<uint64_t, Batch> pending;
+        uint64_t next_index = 0;
+        Batch batch;
+        while (output.pop(batch)) {
+          if (!ordered_) {
+            consume(batch);
+            continue;
+          }
+          // hold the batches received out of order
+          pending.emplace(batch.index, std::move(batch));
+          for (auto it = pending.find(next_index); it != pending.end(); it = pending.find(++next_index)) {
+            consume(it->second);
+            pending.erase(it);
+          }
+        }
+      } catch (...) {
+        abort();
+      }
+
+      producer.join();
+      for (auto& thr : workers)
+        thr.join();
+      if (error)
+        std::rethrow_exception(error);
+      return num_consumed;
+    }
+
+  private:
+    /// A group of consecutive events transferred between two stages
+    struct Batch {
+      uint64_t index;
+      std::vector<T> events;
+    };
+
+    unsigned short num_workers_;
+    size_t batch_size_;
+    size_t queue_size_;
+    bool ordered_;
+    uint64_t max_events_;
+  };
+}  // namespace hector
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef Hector_Utils_Trajectory_h
+#define Hector_Utils_Trajectory_h
+
+#include "Hector/Utils/StateVector.h"
+
+#include <atomic>
+#include <vector>
+
+namespace hector {
+  /// Contiguous collection of state vectors along a particle path, ordered in s-coordinate
+  /// \note Positions are expected to be appended in increasing s, at a constant cost ; out-of-order insertions are
+  ///  supported at a linear cost. As for an associative container, an already existing s-coordinate is never
+  ///  overwritten.
+  class Trajectory {
+  public:
+    /// A pair of longitudinal position/state vector
+    typedef std::pair<double, StateVector> value_type;
+    typedef std::vector<value_type> Container;
+    typedef Container::iterator iterator;
+    typedef Container::const_iterator const_iterator;
+    typedef Container::reverse_iterator reverse_iterator;
+    typedef Container::const_reverse_iterator const_reverse_iterator;
+
+  public:
+    Trajectory() : hint_(0) {}
+    Trajectory(const Trajectory& rhs) : points_(rhs.points_), hint_(0) {}
+    Trajectory(Trajectory&& rhs) noexcept : points_(std::move(rhs.points_)), hint_(0) {}
+    Trajectory& operator=(const Trajectory&);
+    Trajectory& operator=(Trajectory&&) noexcept;
+
+    /// Number of positions in the trajectory
+    size_t size() const { return points_.size(); }
+    /// Is the trajectory empty?
+    bool empty() const { return points_.empty(); }
+    /// Pre-allocate the memory for a given number of positions
+    void reserve(size_t num_points) { points_.reserve(num_points); }
+    /// Number of positions the trajectory can hold without any reallocation
+    size_t capacity() const { return points_.capacity(); }
+    /// Remove all positions (the allocated memory is kept for a later reuse)
+    void clear();
+
+    /// Add a new position to the trajectory
+    /// \return Iterator to the position at this s-coordinate, and whether it was inserted
+    std::pair<iterator, bool> insert(const value_type&);
+    /// Remove a range of positions
+    iterator erase(const_iterator first, const_iterator last);
+
+    /// i-th position along the trajectory
+    const value_type& operator[](size_t i) const { return points_[i]; }
+    /// Position at a given s-coordinate (end if not found)
+    iterator find(double s);
+    /// Position at a given s-coordinate (end if not found)
+    const_iterator find(double s) const;
+    /// First position at or after a given s-coordinate
+    const_iterator lower_bound(double s) const;
+    /// First position strictly after a given s-coordinate
+    const_iterator upper_bound(double s) const;
+    /// Index of the last position at or before a given s-coordinate (size() if none)
+    /// \note The previous result is used as a starting point, for a constant-time lookup in sequential accesses
+    size_t locate(double s) const;
+
+    /// Iterator to the first position of the trajectory
+    iterator begin() { return points_.begin(); }
+    /// Iterator past the last position of the trajectory
+    iterator end() { return points_.end(); }
+    /// Iterator to the first position of the trajectory
+    const_iterator begin() const { return points_.begin(); }
+    /// Iterator past the last position of the trajectory
+    const_iterator end() const { return points_.end(); }
+    /// Reverse iterator to the last position of the trajectory
+    reverse_iterator rbegin() { return points_.rbegin(); }
+    /// Reverse iterator before the first position of the trajectory
+    reverse_iterator rend() { return points_.rend(); }
+    /// Reverse iterator to the last position of the trajectory
+    const_reverse_iterator rbegin() const { return points_.rbegin(); }
+    /// Reverse iterator before the first position of the trajectory
+    const_reverse_iterator rend() const { return points_.rend(); }
+
+  private:
+    Container points_;
+    /// Index of the last position located
+    mutable std::atomic<size_t> hint_;
+  };
+}  // namespace hector
+
+#endif
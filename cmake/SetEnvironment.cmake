@@ -32,6 +32,10 @@ else()
   find_path(CLHEP_INCLUDE CLHEP)
 endif()
 
+#----- threading support for the parallel propagation
+
+find_package(Threads REQUIRED)
+
 #----- Pythia 8 for physics samples generation and/or LHE files parsing
 
 if(LXPLUS)
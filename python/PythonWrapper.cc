@@ -86,6 +86,9 @@ namespace {
     return out;
   }
   //--- helper python <-> C++ converters
+  struct matrix6_to_python {
+    static PyObject* convert(const hector::Matrix6& mat) { return py::incref(py::object(mat.toMatrix()).ptr()); }
+  };
   template <class T, class U>
   py::dict to_python_dict(std::map<T, U>& map) {
     py::dict dictionary;
@@ -115,7 +118,10 @@ namespace {
     return list;
   }
   py::dict particle_positions(hector::Particle& part) {
-    return to_python_dict<double, hector::StateVector>(part.positions());
+    py::dict dictionary;
+    for (const auto& pos : part.positions())
+      dictionary[pos.first] = pos.second;
+    return dictionary;
   }
   py::list beamline_elements(hector::Beamline& bl) {
     return to_python_list<std::shared_ptr<hector::element::ElementBase> >(bl.elements());
@@ -159,9 +165,11 @@ namespace {
         return n();
       return hector::element::ElementBase::clone();
     }
-    hector::Matrix matrix(double eloss, double mp, int qp) const override {
-      if (py::override m = this->get_override("matrix"))
-        return m(eloss, mp, qp);
+    hector::Matrix6 matrix(double eloss, double mp, int qp) const override {
+      if (py::override m = this->get_override("matrix")) {
+        const hector::Matrix mat = m(eloss, mp, qp);
+        return hector::Matrix6(mat);
+      }
       return hector::element::ElementBase::matrix(eloss, mp, qp);
     }
   };
@@ -241,6 +249,8 @@ BOOST_PYTHON_MODULE(pyhector) {
       .add_property("inverse", &invert_matrix, "The inversed matrix (when possible)")
       .add_property("trace", &hector::Matrix::trace, "Matrix trace")
       .add_property("determinant", &hector::Matrix::determinant, "Matrix determinant");
+  // fixed-size transfer matrices are exposed as generic matrices
+  py::to_python_converter<hector::Matrix6, matrix6_to_python>();
 
   //----- EXCEPTIONS
 
@@ -272,7 +282,7 @@ BOOST_PYTHON_MODULE(pyhector) {
   //----- RUN PARAMETERS
 
   py::class_<hector::Parameters, std::shared_ptr<hector::Parameters>, boost::noncopyable>("Parameters", py::init<>())
-      .def("get", &hector::Parameters::get)
+      .def("get", &hector::Parameters::get, py::return_value_policy<py::copy_const_reference>())
       .staticmethod("get")
       .add_property("beamEnergy",
                     &hector::Parameters::beamEnergy,
@@ -345,7 +355,10 @@ BOOST_PYTHON_MODULE(pyhector) {
   //----- BEAM PRODUCERS
 
   py::class_<hector::beam::GaussianParticleGun>("GaussianParticleGun")
-      .def("shoot", &hector::beam::GaussianParticleGun::shoot, "Shoot a single particle")
+      .def("shoot",
+           static_cast<hector::Particle (hector::beam::GaussianParticleGun::*)()>(
+               &hector::beam::GaussianParticleGun::shoot),
+           "Shoot a single particle")
       .add_property("mass",
                     &hector::beam::GaussianParticleGun::particleMass,
                     &hector::beam::GaussianParticleGun::setParticleMass,
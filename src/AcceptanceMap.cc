@@ -0,0 +1,352 @@
+#include "Hector/AcceptanceMap.h"
+#include "Hector/Beamline.h"
+#include "Hector/Exception.h"
+#include "Hector/ParticleBatch.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/Propagator.h"
+
+#include "Hector/Apertures/ApertureBase.h"
+#include "Hector/Elements/ElementBase.h"
+#include "Hector/Utils/Executor.h"
+#include "Hector/Utils/Hash.h"
+#include "Hector/Utils/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace hector {
+  namespace {
+    /// "HAMP" (Hector acceptance map)
+    constexpr uint32_t magic_number = 0x504d4148;
+    constexpr uint32_t version = 1;
+    /// Number of kinematic variables
+    constexpr size_t num_variables = 6;
+
+    template <typename T>
+    void write(std::ofstream& file, const T& val) {
+      file.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+    template <typename T>
+    T read(std::istream& file) {
+      T val;
+      file.read(reinterpret_cast<char*>(&val), sizeof(T));
+      return val;
+    }
+  }  // namespace
+
+  //----- acceptance map
+
+  int AcceptanceMap::Axis::bin(double val) const {
+    if (val < min || val > max)
+      return -1;
+    return std::min((int)((val - min) / binWidth()), (int)num_bins - 1);
+  }
+
+  double AcceptanceMap::Cell::error() const {
+    if (num_generated == 0)
+      return 0.;
+    const double acc = acceptance();
+    return std::sqrt(acc * (1. - acc) / num_generated);
+  }
+
+  AcceptanceMap::AcceptanceMap(uint64_t key, const std::vector<Axis>& axes) : key_(key), axes_(axes) {
+    size_t num_cells = axes_.empty() ? 0 : 1;
+    for (const auto& ax : axes_)
+      num_cells *= ax.num_bins;
+    cells_.assign(num_cells, Cell{0, 0});
+  }
+
+  std::string AcceptanceMap::readHeader(std::istream& file, uint64_t& key, std::vector<Axis>& axes) {
+    if (read<uint32_t>(file) != magic_number || !file)
+      return "invalid magic number";
+    const auto file_version = read<uint32_t>(file);
+    if (file_version != version)
+      return "unsupported version " + std::to_string(file_version);
+    key = read<uint64_t>(file);
+    const auto num_axes = read<uint32_t>(file);
+    if (!file || num_axes > num_variables)
+      return "invalid number of axes";
+    axes.clear();
+    uint64_t num_cells = 1;
+    for (uint32_t i = 0; i < num_axes; ++i) {
+      Axis ax;
+      ax.variable = (Variable)read<uint8_t>(file);
+      ax.num_bins = read<uint32_t>(file);
+      ax.min = read<double>(file);
+      ax.max = read<double>(file);
+      if (!file || (size_t)ax.variable >= num_variables || ax.num_bins == 0 || !(ax.max > ax.min))
+        return "invalid binning for axis " + std::to_string(i);
+      num_cells *= ax.num_bins;
+      if (num_cells > std::numeric_limits<uint32_t>::max())
+        return "too many cells";
+      axes.emplace_back(ax);
+    }
+    if (read<uint64_t>(file) != num_cells || !file)
+      return "inconsistent number of cells";
+    return std::string();
+  }
+
+  std::string AcceptanceMap::check(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::in);
+    if (!file.is_open())
+      return "impossible to open the file";
+    uint64_t key;
+    std::vector<Axis> axes;
+    const auto reason = readHeader(file, key, axes);
+    if (!reason.empty())
+      return reason;
+    // the cells counts fill the rest of the file
+    const auto cells_begin = file.tellg();
+    file.seekg(0, std::ios::end);
+    if ((uint64_t)(file.tellg() - cells_begin) != AcceptanceMap(key, axes).numCells() * sizeof(Cell))
+      return "truncated or oversized cells table";
+    return std::string();
+  }
+
+  AcceptanceMap AcceptanceMap::load(const std::string& path) {
+    const auto reason = check(path);
+    if (!reason.empty())
+      throw H_ERROR << "Invalid acceptance map file \"" << path << "\": " << reason << "!";
+    std::ifstream file(path, std::ios::binary | std::ios::in);
+    uint64_t key;
+    std::vector<Axis> axes;
+    readHeader(file, key, axes);
+    AcceptanceMap map(key, axes);
+    file.read(reinterpret_cast<char*>(map.cells_.data()), map.numCells() * sizeof(Cell));
+    if (!file)
+      throw H_ERROR << "Failed to read the acceptance map from \"" << path << "\"!";
+    return map;
+  }
+
+  void AcceptanceMap::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::out);
+    if (!file.is_open())
+      throw H_ERROR << "Impossible to open file \"" << path << "\" for writing!";
+    write(file, magic_number);
+    write(file, version);
+    write(file, key_);
+    write(file, (uint32_t)axes_.size());
+    for (const auto& ax : axes_) {
+      write(file, (uint8_t)ax.variable);
+      write(file, (uint32_t)ax.num_bins);
+      write(file, ax.min);
+      write(file, ax.max);
+    }
+    write(file, (uint64_t)cells_.size());
+    file.write(reinterpret_cast<const char*>(cells_.data()), cells_.size() * sizeof(Cell));
+    if (!file)
+      throw H_ERROR << "Failed to write the acceptance map into \"" << path << "\"!";
+  }
+
+  int AcceptanceMap::axis(Variable var) const {
+    for (size_t i = 0; i < axes_.size(); ++i)
+      if (axes_[i].variable == var)
+        return i;
+    return -1;
+  }
+
+  size_t AcceptanceMap::cellIndex(const std::vector<unsigned int>& bins) const {
+    if (bins.size() != axes_.size())
+      throw H_ERROR << "Expecting " << axes_.size() << " bin indices, got " << bins.size() << ".";
+    size_t idx = 0;
+    for (size_t i = 0; i < axes_.size(); ++i) {
+      if (bins[i] >= axes_[i].num_bins)
+        throw H_ERROR << "Invalid bin index " << bins[i] << " for the " << axes_[i].variable << " axis.";
+      idx = idx * axes_[i].num_bins + bins[i];
+    }
+    return idx;
+  }
+
+  std::vector<unsigned int> AcceptanceMap::cellBins(size_t i) const {
+    std::vector<unsigned int> bins(axes_.size());
+    for (size_t j = axes_.size(); j > 0; --j) {
+      bins[j - 1] = i % axes_[j - 1].num_bins;
+      i /= axes_[j - 1].num_bins;
+    }
+    return bins;
+  }
+
+  double AcceptanceMap::acceptance(const std::vector<double>& point) const {
+    if (point.size() != axes_.size())
+      throw H_ERROR << "Expecting " << axes_.size() << " coordinates, got " << point.size() << ".";
+    size_t idx = 0;
+    for (size_t i = 0; i < axes_.size(); ++i) {
+      const int bin = axes_[i].bin(point[i]);
+      if (bin < 0)
+        return 0.;
+      idx = idx * axes_[i].num_bins + bin;
+    }
+    return cells_[idx].acceptance();
+  }
+
+  double AcceptanceMap::interpolate(const std::vector<double>& point) const {
+    if (point.size() != axes_.size())
+      throw H_ERROR << "Expecting " << axes_.size() << " coordinates, got " << point.size() << ".";
+    // lower neighbouring cell centre and relative distance to it, along each axis
+    unsigned int low[num_variables];
+    double frac[num_variables];
+    for (size_t i = 0; i < axes_.size(); ++i) {
+      const auto& ax = axes_[i];
+      if (point[i] < ax.min || point[i] > ax.max)
+        return 0.;
+      const double pos = (point[i] - ax.min) / ax.binWidth() - 0.5;
+      low[i] = (unsigned int)std::min(std::max(std::floor(pos), 0.), ax.num_bins - 1.);
+      frac[i] = (low[i] + 1 < ax.num_bins) ? std::min(std::max(pos - low[i], 0.), 1.) : 0.;
+    }
+    // weighted sum over all corners of the enclosing hypercube
+    double acc = 0.;
+    for (unsigned int corner = 0; corner < (1u << axes_.size()); ++corner) {
+      double weight = 1.;
+      size_t idx = 0;
+      for (size_t i = 0; i < axes_.size(); ++i) {
+        const bool up = (corner >> i) & 1;
+        weight *= up ? frac[i] : 1. - frac[i];
+        idx = idx * axes_[i].num_bins + low[i] + (up && frac[i] > 0.);
+      }
+      if (weight > 0.)
+        acc += weight * cells_[idx].acceptance();
+    }
+    return acc;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const AcceptanceMap::Variable& var) {
+    switch (var) {
+      case AcceptanceMap::Variable::xi:
+        return os << "xi";
+      case AcceptanceMap::Variable::t:
+        return os << "|t|";
+      case AcceptanceMap::Variable::phi:
+        return os << "phi";
+      case AcceptanceMap::Variable::vertexX:
+        return os << "vertex x";
+      case AcceptanceMap::Variable::vertexY:
+        return os << "vertex y";
+      case AcceptanceMap::Variable::crossingAngle:
+        return os << "crossing angle";
+    }
+    return os;
+  }
+
+  //----- acceptance map builder
+
+  AcceptanceMapBuilder::AcceptanceMapBuilder(const Beamline* bl, double s, const PropagationContext& ctx)
+      : beamline_(bl), s_(s), context_(ctx), num_per_cell_(1000), num_xi_steps_(10), seed_(0) {}
+
+  AcceptanceMapBuilder& AcceptanceMapBuilder::addAxis(AcceptanceMap::Variable var,
+                                                      unsigned int num_bins,
+                                                      double min,
+                                                      double max) {
+    if (num_bins == 0 || !(max > min))
+      throw H_ERROR << "Invalid binning for the " << var << " axis: " << num_bins << " bins in [" << min << ", " << max
+                    << "].";
+    for (const auto& ax : axes_)
+      if (ax.variable == var)
+        throw H_ERROR << "The " << var << " axis is already defined.";
+    axes_.emplace_back(AcceptanceMap::Axis{var, num_bins, min, max});
+    return *this;
+  }
+
+  uint64_t AcceptanceMapBuilder::key() const {
+    Hash hash;
+    // beamline content
+    for (const auto& elem : beamline_->elements()) {
+      hash.add(elem->type()).add(elem->name()).add(elem->s()).add(elem->length()).add(elem->magneticStrength());
+      hash.add(elem->x()).add(elem->y()).add(elem->Tx()).add(elem->Ty());
+      const auto* aper = elem->aperture();
+      if (!aper) {
+        hash.add(aperture::anInvalidAperture);
+        continue;
+      }
+      hash.add(aper->type()).add(aper->x()).add(aper->y());
+      for (const auto& par : aper->parameters())
+        hash.add(par);
+    }
+    // run parameters
+    hash.add(context_.beam_energy).add(context_.beam_mass).add(context_.beam_charge);
+    hash.add(context_.relative_energy).add(context_.enable_dipoles).add(context_.enable_kickers);
+    hash.add(context_.compute_apertures);
+    // generation settings
+    hash.add(s_);
+    for (const auto& ax : axes_)
+      hash.add(ax.variable).add(ax.num_bins).add(ax.min).add(ax.max);
+    hash.add(num_per_cell_).add(num_xi_steps_).add(seed_);
+    return hash.value();
+  }
+
+  AcceptanceMap AcceptanceMapBuilder::build(Executor& exec) const {
+    if (axes_.empty())
+      throw H_ERROR << "No kinematic variable binned for the acceptance map.";
+    if (num_per_cell_ == 0 || num_xi_steps_ == 0)
+      throw H_ERROR << "Invalid number of particles (" << num_per_cell_ << ") or momentum loss steps ("
+                    << num_xi_steps_ << ") per cell.";
+
+    AcceptanceMap map(key(), axes_);
+    PropagationPlan plan(beamline_, s_);
+    plan.setFusion(true);
+    const Propagator prop(beamline_, context_);
+    const double mass = context_.beam_mass;
+    const double s_ini = beamline_->interactionPoint() ? beamline_->interactionPoint()->s() : 0.;
+
+    exec.parallelFor(map.numCells(), 1, [&](size_t begin, size_t end) {
+      ParticleBatch batch;
+      batch.reserve(num_per_cell_);
+      for (size_t c = begin; c < end; ++c) {
+        const auto bins = map.cellBins(c);
+        batch.clear();
+        for (unsigned int k = 0; k < num_per_cell_; ++k) {
+          random::Stream rng(seed_, c, k);
+          double vals[num_variables] = {0., 0., 0., 0., 0., 0.};
+          for (size_t i = 0; i < axes_.size(); ++i) {
+            const auto& ax = axes_[i];
+            // momentum loss evenly stepped (and particles grouped by step), other variables uniformly drawn
+            const double pos = (ax.variable == AcceptanceMap::Variable::xi)
+                                   ? ((k * num_xi_steps_ / num_per_cell_) + 0.5) / num_xi_steps_
+                                   : rng.uniform();
+            vals[(size_t)ax.variable] = ax.min + (bins[i] + pos) * ax.binWidth();
+          }
+          const double xi = vals[(size_t)AcceptanceMap::Variable::xi], t = vals[(size_t)AcceptanceMap::Variable::t],
+                       phi = vals[(size_t)AcceptanceMap::Variable::phi];
+          const double energy = (1. - xi) * context_.beam_energy;
+          if (!(xi < 1.) || energy <= mass)
+            continue;
+          const double t_min = mass * mass * xi * xi / (1. - xi);
+          if (t < t_min)
+            continue;
+          const double theta = std::sqrt(t - t_min) / std::sqrt(energy * energy - mass * mass);
+          batch.add(StateVector(Vector6(vals[(size_t)AcceptanceMap::Variable::vertexX],
+                                        theta * std::cos(phi) + vals[(size_t)AcceptanceMap::Variable::crossingAngle],
+                                        vals[(size_t)AcceptanceMap::Variable::vertexY],
+                                        theta * std::sin(phi),
+                                        energy,
+                                        1.),
+                                mass),
+                    context_.beam_charge,
+                    s_ini);
+        }
+        prop.propagate(batch, plan);
+        auto& cell = map.cell(c);
+        cell.num_generated = batch.size();
+        cell.num_accepted = std::count(batch.status(), batch.status() + batch.size(), ParticleBatch::Status::alive);
+      }
+    });
+    return map;
+  }
+
+  AcceptanceMap AcceptanceMapBuilder::build(const std::string& path, Executor& exec) const {
+    if (std::ifstream(path).good()) {
+      const auto reason = AcceptanceMap::check(path);
+      if (reason.empty()) {
+        auto map = AcceptanceMap::load(path);
+        if (map.key() == key())
+          return map;
+        H_INFO << "Acceptance map stored in \"" << path << "\" is outdated. Rebuilding it.";
+      } else
+        H_WARNING << "Invalid acceptance map stored in \"" << path << "\" (" << reason << "). Rebuilding it.";
+    }
+    auto map = build(exec);
+    map.save(path);
+    return map;
+  }
+}  // namespace hector
@@ -0,0 +1,61 @@
+#include "Hector/Apertures/ApertureTable.h"
+#include "Hector/Apertures/ApertureBase.h"
+
+#include "Hector/Beamline.h"
+
+#include <limits>
+
+namespace hector {
+  namespace aperture {
+    namespace {
+      /// Inverse of a semi-axis, infinite for a closed (zero) one, consistently with Elliptic::contains
+      double inverse(double val) { return (val != 0.) ? 1. / val : std::numeric_limits<double>::infinity(); }
+    }  // namespace
+
+    ApertureTable::ApertureTable(const Beamline* bl) {
+      if (!bl)
+        return;
+      entries_.reserve(bl->elements().size());
+      for (const auto& elem : bl->elements())
+        add(elem->aperture());
+    }
+
+    void ApertureTable::add(const ApertureBase* aper) { entries_.emplace_back(Entry::fromAperture(aper)); }
+
+    ApertureTable::Entry ApertureTable::Entry::fromAperture(const ApertureBase* aper) {
+      const double inf = std::numeric_limits<double>::infinity();
+      Entry entry{anInvalidAperture, false, 0., 0., inf, inf, 0., 0.};
+      if (!aper)
+        return entry;
+      entry.type = aper->type();
+      entry.x0 = aper->x();
+      entry.y0 = aper->y();
+      switch (entry.type) {
+        case aRectangularAperture:
+          entry.half_x = aper->p(0);
+          entry.half_y = aper->p(1);
+          break;
+        case anEllipticAperture:
+          entry.inv_a = inverse(aper->p(0));
+          entry.inv_b = inverse(aper->p(1));
+          break;
+        case aCircularAperture:
+          entry.inv_a = entry.inv_b = inverse(aper->p(0));
+          break;
+        case aRectEllipticAperture:
+        case aRectCircularAperture:
+          entry.half_x = aper->p(0);
+          entry.half_y = aper->p(1);
+          entry.inv_a = inverse(aper->p(2));
+          entry.inv_b = inverse(aper->p(3));
+          break;
+        case anInvalidAperture:
+        case aRaceTrackAperture:
+        case anOctagonalAperture:
+          return entry;  // no shape implemented for these apertures yet
+      }
+      entry.restricted = true;
+      return entry;
+    }
+  }  // namespace aperture
+}  // namespace hector
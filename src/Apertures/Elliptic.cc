@@ -8,6 +8,8 @@ namespace hector {
     Elliptic::~Elliptic() {}
 
     bool Elliptic::contains(const TwoVector& pos) const {
+      if (p(0) == 0. || p(1) == 0.)  // a zero semi-axis closes the aperture
+        return false;
       const TwoVector vec((pos.x() - pos_.x()) / p(0), (pos.y() - pos_.y()) / p(1));
       return (vec.mag2() < 1.);
     }
@@ -9,6 +9,8 @@ namespace hector {
     RectElliptic::~RectElliptic() {}
 
     bool RectElliptic::contains(const TwoVector& pos) const {
+      if (p(2) == 0. || p(3) == 0.)  // a zero semi-axis closes the aperture
+        return false;
       const TwoVector vec1(pos - pos_), vec2(vec1.x() / p(2), vec1.y() / p(3));
       return ((fabs(vec1.x()) < p(0)) && (fabs(vec1.y()) < p(1))  // rectangular part
               && (vec2.mag2() < 1.));                             // elliptic part
@@ -1,4 +1,5 @@
 #include "Hector/Beamline.h"
+#include "Hector/BeamlineBuilder.h"
 #include "Hector/Exception.h"
 #include "Hector/Particle.h"
 
@@ -143,7 +144,7 @@ namespace hector {
     return *elements_.end();
   }
 
-  element::Elements Beamline::find(const std::string& regex) {
+  element::Elements Beamline::find(const std::string& regex) const {
     try {
       std::regex rgx_search(regex);
       std::cmatch m;
@@ -158,7 +159,7 @@ namespace hector {
   }
 
   Matrix Beamline::matrix(double eloss, double mp, int qp) const {
-    Matrix out = DiagonalMatrix(6, 1);
+    Matrix6 out = Matrix6::identity();
 
     for (const auto& elem : elements_) {
       const auto& mat = elem->matrix(eloss, mp, qp);
@@ -167,7 +168,7 @@ namespace hector {
       out = out * mat;
     }
 
-    return out;
+    return out.toMatrix();
   }
 
   double Beamline::length() const {
@@ -208,42 +209,32 @@ namespace hector {
   }
 
   std::unique_ptr<Beamline> Beamline::sequencedBeamline(const Beamline* beamline) {
-    // add the drifts between optical elements
-    double pos = 0.;
     // brand new beamline to populate
     std::unique_ptr<Beamline> tmp(new Beamline(*beamline, false));
-
-    // convert all empty spaces into drifts
-    for (const auto& elemPtr : *beamline) {
-      // skip the markers
-      if (elemPtr->type() == element::aMarker && elemPtr->name() != beamline->interactionPoint()->name())
-        continue;
-      // add a drift whenever there is a gap in s
-      const double drift_length = elemPtr->s() - pos;
-      try {
-        if (drift_length > 0.)
-          tmp->add(std::make_shared<element::Drift>(format("drift:%.4E", pos).c_str(), pos, drift_length));
-        tmp->add(elemPtr);
-      } catch (const Exception& e) {
-        e.dump(std::cerr);
-      }
-      pos = elemPtr->s() + elemPtr->length();
-    }
-    // add the last drift
-    const double drift_length = tmp->length() - pos;
-    if (drift_length > 0) {
-      try {
-        tmp->add(std::make_shared<element::Drift>(format("drift:%.4E", pos).c_str(), pos, drift_length));
-      } catch (const Exception& e) {
-        e.dump(std::cerr);
+    // convert all empty spaces into drifts while building
+    BeamlineBuilder builder(*tmp, true);
+    builder.reserve(beamline->elements().size());
+    const std::string& ip_name = beamline->interactionPoint()->name();
+    try {
+      for (const auto& elemPtr : *beamline) {
+        // skip the markers
+        if (elemPtr->type() == element::aMarker && elemPtr->name() != ip_name)
+          continue;
+        builder.add(elemPtr);
       }
+      builder.build();
+    } catch (const Exception& e) {
+      e.dump(std::cerr);
     }
 
     return tmp;
   }
 
   void Beamline::setElements(const Beamline& moth_bl) {
+    BeamlineBuilder builder(*this);
+    builder.reserve(moth_bl.elements().size());
     for (const auto& elem : moth_bl)
-      add(elem);
+      builder.add(elem);
+    builder.build();
   }
 }  // namespace hector
@@ -0,0 +1,149 @@
+#include "Hector/BeamlineBuilder.h"
+#include "Hector/Beamline.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/String.h"
+
+#include "Hector/Elements/Drift.h"
+
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+
+namespace hector {
+  namespace {
+    /// Longitudinal extent of a built element, possibly enclosing the next ones
+    struct Extent {
+      double s;      ///< Entrance of the element (m)
+      double end;    ///< Exit of the element (m)
+      size_t index;  ///< Index of the element in the built list
+      bool operator<(const Extent& oth) const {
+        if (s != oth.s)
+          return s < oth.s;
+        if (end != oth.end)
+          return end < oth.end;
+        return index < oth.index;
+      }
+    };
+  }  // namespace
+
+  BeamlineBuilder::BeamlineBuilder(Beamline& beamline, bool sequence) : beamline_(beamline), sequence_(sequence) {}
+
+  void BeamlineBuilder::reserve(size_t num_elements) { elements_.reserve(num_elements); }
+
+  void BeamlineBuilder::add(const element::ElementPtr& elem) {
+    const double new_size = elem->s() + elem->length();
+    if (new_size > beamline_.maxLength() && beamline_.maxLength() < 0.)
+      throw H_ERROR << "Element " << elem->name() << " is too far away for this beamline!\n"
+                    << "\tBeamline length: " << beamline_.maxLength() << " m, this element: " << new_size << " m.";
+    elements_.emplace_back(elem);
+  }
+
+  void BeamlineBuilder::build() {
+    // single sort of all elements according to their s-position
+    std::stable_sort(elements_.begin(),
+                     elements_.end(),
+                     [](const element::ElementPtr& lhs, const element::ElementPtr& rhs) {
+                       return lhs->s() < rhs->s();
+                     });
+
+    element::Elements built;
+    built.reserve(sequence_ ? 2 * elements_.size() + 1 : elements_.size());
+    std::unordered_set<std::string> names;
+    names.reserve(built.capacity());
+    // elements with a non-zero length not yet passed by the sweep
+    std::set<Extent> enclosing;
+
+    const auto append = [&built, &enclosing](const element::ElementPtr& elem) {
+      built.emplace_back(elem);
+      if (elem->length() > 0.)
+        enclosing.insert(Extent{elem->s(), elem->s() + elem->length(), built.size() - 1});
+    };
+    const auto insert = [&](const element::ElementPtr& elem) {
+      // first check if the element is already present in the beamline
+      if (!names.insert(elem->name()).second)
+        return;
+
+      // look for the first element enclosing this one
+      element::ElementPtr prev_elem = nullptr;
+      auto it = enclosing.begin();
+      while (it != enclosing.end() && it->s <= elem->s()) {
+        if (it->end <= elem->s()) {  // will never enclose any further element
+          it = enclosing.erase(it);
+          continue;
+        }
+        if (it->s == elem->s() && elem->length() == 0) {
+          ++it;
+          continue;
+        }
+        prev_elem = built.at(it->index);
+        break;
+      }
+      if (!prev_elem) {
+        append(elem);
+        return;
+      }
+
+      if (!Parameters::get()->correctBeamlineOverlaps())
+        throw H_ERROR << "Elements overlap with \"" << prev_elem->name() << "\" "
+                      << "detected while adding \"" << elem->name() << "\"!";
+
+      // from that point on, an overlap is detected
+      // reduce or separate that element in two sub-parts
+
+      H_DEBUG << elem->name() << " (" << elem->type() << ") is inside " << prev_elem->name() << " ("
+              << prev_elem->type() << ")\n\t"
+              << "Hector will fix the overlap by splitting the earlier.";
+      enclosing.erase(it);
+      const double prev_length = prev_elem->length();
+
+      element::ElementPtr next_elem = nullptr;
+      // check if one needs to add an extra piece to the previous element
+      if (elem->s() + elem->length() < prev_elem->s() + prev_elem->length()) {
+        const std::string prev_name = prev_elem->name();
+        names.erase(prev_name);
+        prev_elem->setName(format("%s/1", prev_name.c_str()));
+        next_elem = prev_elem->clone();
+        next_elem->setName(format("%s/2", prev_name.c_str()));
+        next_elem->setS(elem->s() + elem->length());
+        next_elem->setLength(prev_length - elem->length());
+        next_elem->setBeta(elem->beta());
+        next_elem->setDispersion(elem->dispersion());
+        next_elem->setRelativePosition(elem->relativePosition());
+        next_elem->setParentElement(prev_elem);
+        names.insert(prev_elem->name());
+        names.insert(next_elem->name());
+      }
+
+      prev_elem->setLength(elem->s() - prev_elem->s());
+
+      append(elem);
+      if (next_elem != nullptr)
+        append(next_elem);
+    };
+
+    double pos = 0.;
+    for (const auto& elem : elements_) {
+      // add a drift whenever there is a gap in s
+      const double drift_length = elem->s() - pos;
+      if (sequence_ && drift_length > 0.)
+        insert(std::make_shared<element::Drift>(format("drift:%.4E", pos), pos, drift_length));
+      insert(elem);
+      pos = elem->s() + elem->length();
+    }
+    elements_.clear();
+
+    // split parts may have been moved after the next elements
+    std::stable_sort(built.begin(), built.end(), [](const element::ElementPtr& lhs, const element::ElementPtr& rhs) {
+      if (lhs->s() != rhs->s())
+        return lhs->s() < rhs->s();
+      return lhs->s() + lhs->length() < rhs->s() + rhs->length();
+    });
+    beamline_.elements().swap(built);
+
+    // add the last drift
+    const double drift_length = beamline_.length() - pos;
+    if (sequence_ && drift_length > 0.)
+      beamline_.add(std::make_shared<element::Drift>(format("drift:%.4E", pos), pos, drift_length));
+  }
+}  // namespace hector
@@ -7,66 +7,82 @@
 
 namespace hector {
   namespace element {
-    Matrix SectorDipole::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 SectorDipole::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
 
-      if (Parameters::get()->enableDipoles() == false)
-        return mat;
+    Matrix6 SectorDipole::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      if (!ctx.enable_dipoles)
+        return Drift::genericMatrix(length_);
+
+      return genericMatrix(length_, fieldStrength(eloss, mp, qp, ctx), ctx.relative_energy, ctx.beam_energy, name_);
+    }
+
+    Matrix6 SectorDipole::genericMatrix(
+        double length, double ke, bool relative_energy, double beam_energy, const std::string& name) {
+      Matrix6 mat = Drift::genericMatrix(length);
 
-      const double ke = fieldStrength(eloss, mp, qp);
       if (ke == 0.) {  // simple drift matrix
-        H_DEBUG << "Sector dipole " << name_ << " has no effect. Treating it as a drift.";
+        H_DEBUG << "Sector dipole " << name << " has no effect. Treating it as a drift.";
         return mat;
       }
 
       const double radius = 1. / ke;
-      const double theta = length_ * ke, s_theta = sin(theta), c_theta = cos(theta);
-      const double inv_energy = 1. / Parameters::get()->beamEnergy();
+      const double theta = length * ke, s_theta = sin(theta), c_theta = cos(theta);
+      const double inv_energy = 1. / beam_energy;
 
+      mat(0, 0) = c_theta;
+      mat(0, 1) = s_theta * radius;
+      mat(1, 0) = s_theta * (-ke);
       mat(1, 1) = c_theta;
-      mat(1, 2) = s_theta * radius;
-      mat(2, 1) = s_theta * (-ke);
-      mat(2, 2) = c_theta;
-      if (Parameters::get()->useRelativeEnergy()) {
+      if (relative_energy) {
         const double simp = 2. * radius * pow(sin(theta * 0.5), 2) * inv_energy;
         // numerically stable version of ( r/E₀ )*( 1-cos θ )
-        mat(1, 5) = simp;
-        mat(2, 5) = s_theta * inv_energy;
+        mat(0, 4) = simp;
+        mat(1, 4) = s_theta * inv_energy;
       }
       return mat;
     }
 
-    Matrix RectangularDipole::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 RectangularDipole::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
 
-      if (Parameters::get()->enableDipoles() == false)
-        return mat;
+    Matrix6 RectangularDipole::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      if (!ctx.enable_dipoles)
+        return Drift::genericMatrix(length_);
+
+      return genericMatrix(length_, fieldStrength(eloss, mp, qp, ctx), ctx.relative_energy, ctx.beam_energy, name_);
+    }
+
+    Matrix6 RectangularDipole::genericMatrix(
+        double length, double ke, bool relative_energy, double beam_energy, const std::string& name) {
+      Matrix6 mat = Drift::genericMatrix(length);
 
-      const double ke = fieldStrength(eloss, mp, qp);
       if (ke == 0.) {  // simple drift matrix
-        H_DEBUG << "Rectangular dipole " << name_ << " has no effect. Treating it as a drift.";
+        H_DEBUG << "Rectangular dipole " << name << " has no effect. Treating it as a drift.";
         return mat;
       }
 
       const double radius = 1. / ke;
-      const double theta = length_ * ke, s_theta = sin(theta), c_theta = cos(theta);
-      //std::cout << name_ << "|" << eloss << "|" << radius << "|" << ke << "|" << theta << "|" << s_theta << "|" << c_theta << std::endl;
-      const double inv_energy = 1. / Parameters::get()->beamEnergy();
+      const double theta = length * ke, s_theta = sin(theta), c_theta = cos(theta);
+      //std::cout << name << "|" << radius << "|" << ke << "|" << theta << "|" << s_theta << "|" << c_theta << std::endl;
+      const double inv_energy = 1. / beam_energy;
       // numerically stable version of ( r/E₀ )*( 1-cos θ )
       const double simp = 2. * radius * pow(sin(theta * 0.5), 2) * inv_energy;
 
+      mat(0, 0) = c_theta;
+      mat(0, 1) = s_theta * radius;
+      mat(1, 0) = s_theta * (-ke);
       mat(1, 1) = c_theta;
-      mat(1, 2) = s_theta * radius;
-      mat(2, 1) = s_theta * (-ke);
-      mat(2, 2) = c_theta;
-      mat(1, 5) = simp;
-      mat(2, 5) = s_theta * inv_energy;
-
-      if (Parameters::get()->useRelativeEnergy()) {
-        Matrix ef_matrix = DiagonalMatrix(6, 1);
+      mat(0, 4) = simp;
+      mat(1, 4) = s_theta * inv_energy;
+
+      if (relative_energy) {
+        Matrix6 ef_matrix = Matrix6::identity();
         const double t_theta_half_ke = ke * tan(theta * 0.5);
-        ef_matrix(2, 1) = +t_theta_half_ke;
-        ef_matrix(4, 3) = -t_theta_half_ke;
+        ef_matrix(1, 0) = +t_theta_half_ke;
+        ef_matrix(3, 2) = -t_theta_half_ke;
         return ef_matrix * mat * ef_matrix;
       }
 
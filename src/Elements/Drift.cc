@@ -7,13 +7,10 @@ namespace hector {
     Drift::Drift(const std::string& name, const Type& type, double spos, double length)
         : ElementBase(type, name, spos, length) {}
 
-    Matrix Drift::matrix(double, double, int) const { return genericMatrix(length_); }
+    Matrix6 Drift::matrix(double, double, int) const { return genericMatrix(length_); }
 
-    Matrix Drift::genericMatrix(double length) {
-      Matrix mat = DiagonalMatrix(6, 1);
-      mat(1, 2) = length;
-      mat(3, 4) = length;
-      return mat;
-    }
+    Matrix6 Drift::matrix(double, double, int, const PropagationContext&) const { return genericMatrix(length_); }
+
+    Matrix6 Drift::genericMatrix(double length) { return Matrix6::drift(length); }
   }  // namespace element
 }  // namespace hector
@@ -8,7 +8,12 @@
 namespace hector {
   namespace element {
     ElementBase::ElementBase(const Type& type, const std::string& name, double spos, double length)
-        : type_(type), name_(name), length_(length), magnetic_strength_(0.), s_(spos) {}
+        : type_(type),
+          name_(name),
+          length_(length),
+          magnetic_strength_(0.),
+          s_(spos),
+          matrices_id_(MatrixCache::newElementId()) {}
 
     ElementBase::ElementBase(ElementBase& rhs)
         : type_(rhs.type_),
@@ -21,7 +26,8 @@ namespace hector {
           s_(rhs.s_),
           beta_(rhs.beta_),
           disp_(rhs.disp_),
-          rel_pos_(rhs.rel_pos_) {}
+          rel_pos_(rhs.rel_pos_),
+          matrices_id_(MatrixCache::newElementId()) {}
 
     ElementBase::ElementBase(const ElementBase& rhs)
         : type_(rhs.type_),
@@ -34,7 +40,8 @@ namespace hector {
           s_(rhs.s_),
           beta_(rhs.beta_),
           disp_(rhs.disp_),
-          rel_pos_(rhs.rel_pos_) {}
+          rel_pos_(rhs.rel_pos_),
+          matrices_id_(MatrixCache::newElementId()) {}
 
     bool ElementBase::operator==(const ElementBase& rhs) const {
       if (type_ != rhs.type_)
@@ -58,6 +65,20 @@ namespace hector {
       return true;
     }
 
+    Matrix6 ElementBase::matrix(double eloss, double mp, int qp, const PropagationContext&) const {
+      return matrix(eloss, mp, qp);
+    }
+
+    Matrix6 ElementBase::cachedMatrix(double eloss, double mp, int qp) const {
+      return cachedMatrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
+
+    Matrix6 ElementBase::cachedMatrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      return MatrixCache::local().get(matrices_id_, eloss, mp, qp, ctx, [this, &ctx](double e, double m, int q) {
+        return this->matrix(e, m, q, ctx);
+      });
+    }
+
     void ElementBase::setAperture(const std::shared_ptr<aperture::ApertureBase>& apert) { aperture_ = apert; }
 
     void ElementBase::setAperture(aperture::ApertureBase* apert) {
@@ -65,17 +86,26 @@ namespace hector {
     }
 
     double ElementBase::fieldStrength(double e_loss, double mp, int qp) const {
+      return fieldStrength(e_loss, mp, qp, PropagationContext::fromParameters());
+    }
+
+    double ElementBase::fieldStrength(double e_loss, double mp, int qp, const PropagationContext& ctx) const {
+      return fieldStrength(magnetic_strength_, e_loss, mp, qp, ctx.beam_energy, ctx.beam_mass, ctx.beam_charge);
+    }
+
+    double ElementBase::fieldStrength(
+        double k, double e_loss, double mp, int qp, double beam_energy, double beam_mass, int beam_charge) {
       // only act on charged particles
       if (qp == 0)
         return 0.;
 
+      // not fatal, as only the particle being propagated is affected
       if (e_loss < 0.)
-        throw H_ERROR << "Invalid energy loss: " << e_loss << " GeV.";
+        throw H_WARNING << "Invalid energy loss: " << e_loss << " GeV.";
 
       double p_bal = 1.;
       if (e_loss > 0.) {
-        const double e_ini = Parameters::get()->beamEnergy(), mp0 = Parameters::get()->beamParticlesMass(),
-                     e_out = e_ini - e_loss;
+        const double e_ini = beam_energy, mp0 = beam_mass, e_out = e_ini - e_loss;
         const double p_ini = sqrt((e_ini - mp0) * (e_ini + mp0)),  // e_ini^2 - p_ini^2 = mp0^2
             p_out = sqrt((e_out - mp) * (e_out + mp));             // e_out^2 - p_out^2 = mp^2
 
@@ -86,7 +116,7 @@ namespace hector {
       }
 
       // reweight the field strength by the particle charge and momentum
-      return magnetic_strength_ * p_bal * (qp / Parameters::get()->beamParticlesCharge());
+      return k * p_bal * (qp / beam_charge);
     }
 
     const std::string ElementBase::typeName() const {
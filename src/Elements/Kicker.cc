@@ -1,36 +1,47 @@
 #include "Hector/Elements/Kicker.h"
 #include "Hector/Elements/Drift.h"
-#include "Hector/Parameters.h"
 
 namespace hector {
   namespace element {
-    Matrix HorizontalKicker::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 HorizontalKicker::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
 
-      if (!Parameters::get()->enableKickers())
-        return mat;
+    Matrix6 HorizontalKicker::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      if (!ctx.enable_kickers)
+        return Drift::genericMatrix(length_);
+
+      return genericMatrix(length_, -fieldStrength(eloss, mp, qp, ctx));
+    }
 
-      const double ke = -fieldStrength(eloss, mp, qp);
+    Matrix6 HorizontalKicker::genericMatrix(double length, double ke) {
+      Matrix6 mat = Drift::genericMatrix(length);
       if (ke == 0.)
         return mat;
 
-      mat(1, 6) = length_ * tan(ke) * 0.5;
-      mat(2, 6) = ke;
+      mat(0, 5) = length * tan(ke) * 0.5;
+      mat(1, 5) = ke;
       return mat;
     }
 
-    Matrix VerticalKicker::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 VerticalKicker::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
 
-      if (!Parameters::get()->enableKickers())
-        return mat;
+    Matrix6 VerticalKicker::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      if (!ctx.enable_kickers)
+        return Drift::genericMatrix(length_);
+
+      return genericMatrix(length_, -fieldStrength(eloss, mp, qp, ctx));
+    }
 
-      const double ke = -fieldStrength(eloss, mp, qp);
+    Matrix6 VerticalKicker::genericMatrix(double length, double ke) {
+      Matrix6 mat = Drift::genericMatrix(length);
       if (ke == 0.)
         return mat;
 
-      mat(3, 6) = length_ * tan(ke) * 0.5;
-      mat(4, 6) = ke;
+      mat(2, 5) = length * tan(ke) * 0.5;
+      mat(3, 5) = ke;
       return mat;
     }
   }  // namespace element
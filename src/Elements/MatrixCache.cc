@@ -0,0 +1,80 @@
+#include "Hector/Elements/MatrixCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+namespace hector {
+  namespace element {
+    MatrixCache::MatrixCache(size_t capacity)
+        : capacity_(capacity), requested_(2 * capacity + 1, 0), hits_(0), misses_(0) {}
+
+    MatrixCache& MatrixCache::local() {
+      thread_local MatrixCache cache;
+      return cache;
+    }
+
+    unsigned long long MatrixCache::newElementId() {
+      static std::atomic<unsigned long long> last_id(0);
+      return ++last_id;
+    }
+
+    void MatrixCache::clear() {
+      matrices_.clear();
+      index_.clear();
+      std::fill(requested_.begin(), requested_.end(), 0);
+    }
+
+    void MatrixCache::setCapacity(size_t capacity) {
+      capacity_ = capacity;
+      while (matrices_.size() > capacity_) {
+        index_.erase(matrices_.back().first);
+        matrices_.pop_back();
+      }
+      requested_.assign(2 * capacity_ + 1, 0);
+    }
+
+    void MatrixCache::resetCounters() {
+      hits_ = 0;
+      misses_ = 0;
+    }
+
+    bool MatrixCache::lookup(const Key& key, Matrix6& mat) {
+      const auto it = index_.find(key);
+      if (it == index_.end())
+        return false;
+      // move the matrix on top of the most recently used list
+      matrices_.splice(matrices_.begin(), matrices_, it->second);
+      mat = it->second->second;
+      return true;
+    }
+
+    void MatrixCache::insert(const Key& key, const Matrix6& mat) {
+      if (capacity_ == 0)
+        return;
+      // only store the matrices already requested once (a colliding key takes over the slot)
+      const size_t hash = KeyHash()(key);
+      auto& requested = requested_[hash % requested_.size()];
+      if (requested != hash) {
+        requested = hash;
+        return;
+      }
+      matrices_.emplace_front(key, mat);
+      index_[key] = matrices_.begin();
+      // drop the least recently used matrix if needed
+      if (matrices_.size() > capacity_) {
+        index_.erase(matrices_.back().first);
+        matrices_.pop_back();
+      }
+    }
+
+    size_t MatrixCache::KeyHash::operator()(const Key& key) const {
+      size_t seed = key.ctx.hash();
+      seed ^= std::hash<unsigned long long>()(key.elem_id) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= std::hash<double>()(key.eloss) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= std::hash<double>()(key.mp) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= std::hash<int>()(key.qp) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  }  // namespace element
+}  // namespace hector
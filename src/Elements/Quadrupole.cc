@@ -4,61 +4,76 @@
 
 namespace hector {
   namespace element {
-    Matrix HorizontalQuadrupole::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 HorizontalQuadrupole::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
+
+    Matrix6 HorizontalQuadrupole::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      return genericMatrix(length_, fieldStrength(eloss, mp, qp, ctx), name_);
+    }
 
-      const double ke = fieldStrength(eloss, mp, qp);  // should be negative
+    Matrix6 HorizontalQuadrupole::genericMatrix(double length, double ke, const std::string& name) {
+      Matrix6 mat = Drift::genericMatrix(length);
+
+      // ke should be negative
       if (ke > 0.)
-        throw H_ERROR << "Magnetic strength for horizontal quadrupole " << name_ << " should be negative!\n\t"
+        throw H_ERROR << "Magnetic strength for horizontal quadrupole " << name << " should be negative!\n\t"
                       << "Value = " << ke << ".";
       if (ke == 0.) {  // simple drift matrix
-        H_DEBUG << "Quadrupole " << name_ << " has no effect. Treating it as a drift.";
+        H_DEBUG << "Quadrupole " << name << " has no effect. Treating it as a drift.";
         return mat;
       }
 
       const double sq_k = sqrt(-ke), inv_sq_k = 1. / sq_k;
-      const double omega = sq_k * length_;
+      const double omega = sq_k * length;
       const double s_omega = sin(omega), c_omega = cos(omega), sh_omega = sinh(omega), ch_omega = cosh(omega);
 
       // Focussing Twiss matrix for the horizontal component
+      mat(0, 0) = c_omega;
+      mat(0, 1) = s_omega * inv_sq_k;
+      mat(1, 0) = s_omega * (-sq_k);
       mat(1, 1) = c_omega;
-      mat(1, 2) = s_omega * inv_sq_k;
-      mat(2, 1) = s_omega * (-sq_k);
-      mat(2, 2) = c_omega;
       // Defocussing Twiss matrix for the vertical component
+      mat(2, 2) = ch_omega;
+      mat(2, 3) = sh_omega * inv_sq_k;
+      mat(3, 2) = sh_omega * sq_k;
       mat(3, 3) = ch_omega;
-      mat(3, 4) = sh_omega * inv_sq_k;
-      mat(4, 3) = sh_omega * sq_k;
-      mat(4, 4) = ch_omega;
       return mat;
     }
 
-    Matrix VerticalQuadrupole::matrix(double eloss, double mp, int qp) const {
-      Matrix mat = Drift::genericMatrix(length_);
+    Matrix6 VerticalQuadrupole::matrix(double eloss, double mp, int qp) const {
+      return matrix(eloss, mp, qp, PropagationContext::fromParameters());
+    }
+
+    Matrix6 VerticalQuadrupole::matrix(double eloss, double mp, int qp, const PropagationContext& ctx) const {
+      return genericMatrix(length_, fieldStrength(eloss, mp, qp, ctx), name_);
+    }
+
+    Matrix6 VerticalQuadrupole::genericMatrix(double length, double ke, const std::string& name) {
+      Matrix6 mat = Drift::genericMatrix(length);
 
-      const double ke = fieldStrength(eloss, mp, qp);
       if (ke < 0.)
-        throw H_ERROR << "Magnetic strength for vertical quadrupole " << name_ << " should be positive!\n\t"
+        throw H_ERROR << "Magnetic strength for vertical quadrupole " << name << " should be positive!\n\t"
                       << "Value = " << ke << ".";
       if (ke == 0.) {  // simple drift matrix
-        H_DEBUG << "Quadrupole " << name_ << " has no effect. Treating it as a drift.";
+        H_DEBUG << "Quadrupole " << name << " has no effect. Treating it as a drift.";
         return mat;
       }
 
       const double sq_k = sqrt(ke), inv_sq_k = 1. / sq_k;
-      const double omega = sq_k * length_;
+      const double omega = sq_k * length;
       const double s_omega = sin(omega), c_omega = cos(omega), sh_omega = sinh(omega), ch_omega = cosh(omega);
 
       // Defocussing Twiss matrix for the horizontal component
+      mat(0, 0) = ch_omega;
+      mat(0, 1) = sh_omega * inv_sq_k;
+      mat(1, 0) = sh_omega * sq_k;
       mat(1, 1) = ch_omega;
-      mat(1, 2) = sh_omega * inv_sq_k;
-      mat(2, 1) = sh_omega * sq_k;
-      mat(2, 2) = ch_omega;
       // Focussing Twiss matrix for the vertical component
+      mat(2, 2) = c_omega;
+      mat(2, 3) = s_omega * inv_sq_k;
+      mat(3, 2) = s_omega * (-sq_k);
       mat(3, 3) = c_omega;
-      mat(3, 4) = s_omega * inv_sq_k;
-      mat(4, 3) = s_omega * (-sq_k);
-      mat(4, 4) = c_omega;
       return mat;
     }
   }  // namespace element
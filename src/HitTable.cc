@@ -0,0 +1,31 @@
+#include "Hector/HitTable.h"
+
+#include <iostream>
+
+namespace hector {
+  HitTable::HitTable(size_t num_particles, size_t num_planes)
+      : num_particles_(num_particles),
+        num_planes_(num_planes),
+        hits_(num_particles * num_planes, Hit{0., 0., 0., 0., Status::notReached}) {}
+
+  size_t HitTable::numReached(size_t plane) const {
+    size_t num = 0;
+    for (size_t i = 0; i < num_particles_; ++i)
+      num += (hits_[i * num_planes_ + plane].status == Status::reached);
+    return num;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const HitTable::Status& status) {
+    switch (status) {
+      case HitTable::Status::reached:
+        return os << "reached";
+      case HitTable::Status::stopped:
+        return os << "stopped";
+      case HitTable::Status::notReached:
+        return os << "not reached";
+      case HitTable::Status::failed:
+        return os << "failed";
+    }
+    return os;
+  }
+}  // namespace hector
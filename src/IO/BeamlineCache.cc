@@ -0,0 +1,137 @@
+#include "Hector/IO/BeamlineCache.h"
+#include "Hector/IO/HBLFileHandler.h"
+#include "Hector/IO/TwissHandler.h"
+#include "Hector/Beamline.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/Hash.h"
+#include "Hector/Utils/MappedFile.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hector {
+  namespace io {
+    namespace {
+      /// Version of the cache entries layout
+      constexpr uint32_t version = 2;
+
+      /// Header variable holding the identifier of a cache entry
+      const std::string key_variable = "hector:cache_key";
+
+      std::string keyString(uint64_t key) {
+        char str[17];
+        std::snprintf(str, sizeof(str), "%016llx", (unsigned long long)key);
+        return str;
+      }
+    }  // namespace
+
+    BeamlineCache::BeamlineCache(const std::string& directory) : directory_(directory) {
+      if (directory_.empty())
+        throw H_ERROR << "Invalid beamline cache directory.";
+      if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+        throw H_ERROR << "Impossible to create the beamline cache directory \"" << directory_
+                      << "\": " << std::strerror(errno) << ".";
+    }
+
+    uint64_t BeamlineCache::key(const std::string& filename, const std::string& ip_name, float max_s, float min_s) {
+      Hash hash;
+      hash.add(version);
+      {  // Twiss file content
+        const MappedFile file(filename);
+        hash.add(file.size()).addBlock(file.data(), file.size());
+      }
+      // parsing options
+      hash.add(ip_name).add(max_s).add(min_s);
+      hash.add(Parameters::get()->correctBeamlineOverlaps());
+      return hash.value();
+    }
+
+    std::string BeamlineCache::path(uint64_t key) const { return directory_ + "/" + keyString(key) + ".hbl"; }
+
+    BeamlineCache::Entry BeamlineCache::load(const std::string& filename,
+                                             const std::string& ip_name,
+                                             float max_s,
+                                             float min_s) const {
+      const uint64_t id = key(filename, ip_name, max_s, min_s);
+      const std::string entry_path = path(id);
+
+      Entry entry{nullptr, {}, {}, true};
+      if (retrieve(entry_path, id, entry)) {
+        Twiss::updateParameters(entry.header_floats);
+        H_DEBUG << "Beamline of \"" << filename << "\" retrieved from \"" << entry_path << "\".";
+        return entry;
+      }
+
+      // cache miss: parse the Twiss file and populate the cache
+      Twiss parser(filename, ip_name, max_s, min_s);
+      // the parsed elements are already sequenced, hence shared as they are
+      entry.beamline.reset(new Beamline(*parser.beamline(), false));
+      entry.beamline->elements() = parser.beamline()->elements();
+      entry.header_strings = parser.headerStrings();
+      entry.header_floats = parser.headerFloats();
+      entry.cached = false;
+      store(entry_path, id, entry);
+      return entry;
+    }
+
+    bool BeamlineCache::retrieve(const std::string& path, uint64_t key, Entry& entry) const {
+      if (!std::ifstream(path).good())
+        return false;
+      // the entry is mapped and validated once, then parsed in place
+      MappedFile file(path);
+      const auto failure = HBL::check(file);
+      if (!failure.empty()) {
+        H_WARNING << "Invalid beamline cache entry \"" << path << "\" (" << failure << "). Parsing the Twiss file.";
+        return false;
+      }
+      const HBL hbl(std::move(file));
+      entry.header_strings = hbl.headerStrings();
+      const auto it = entry.header_strings.find(key_variable);
+      if (it == entry.header_strings.end() || it->second != keyString(key)) {
+        H_WARNING << "Beamline cache entry \"" << path << "\" does not match its identifier. Parsing the Twiss file.";
+        return false;
+      }
+      entry.header_strings.erase(it);
+      entry.header_floats = hbl.headerFloats();
+      // the retrieved elements are already sequenced, hence shared as they are
+      entry.beamline.reset(new Beamline(*hbl.beamline(), false));
+      entry.beamline->elements() = hbl.beamline()->elements();
+      return true;
+    }
+
+    void BeamlineCache::store(const std::string& path, uint64_t key, const Entry& entry) const {
+      // unique temporary file for each writer, among all processes and threads
+      static std::atomic<unsigned long> num_written(0);
+      const std::string tmp_path =
+          path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(num_written++);
+      {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::out);
+        if (!file.is_open()) {
+          H_WARNING << "Impossible to open file \"" << tmp_path << "\" for writing. Beamline not cached.";
+          return;
+        }
+        auto header_strings = entry.header_strings;
+        header_strings[key_variable] = keyString(key);
+        HBL::write(entry.beamline.get(), file, header_strings, entry.header_floats);
+        if (!file) {
+          H_WARNING << "Failed to write the beamline cache entry into \"" << tmp_path << "\".";
+          file.close();
+          std::remove(tmp_path.c_str());
+          return;
+        }
+      }
+      // publish the complete entry at once
+      if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        H_WARNING << "Failed to store the beamline cache entry \"" << path << "\": " << std::strerror(errno) << ".";
+        std::remove(tmp_path.c_str());
+      }
+    }
+  }  // namespace io
+}  // namespace hector
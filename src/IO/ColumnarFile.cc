@@ -0,0 +1,256 @@
+#include "Hector/IO/ColumnarFile.h"
+#include "Hector/Exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace hector {
+  namespace io {
+    namespace {
+      /// "HCOL" (Hector columnar file)
+      constexpr uint32_t magic_number = 0x4c4f4348;
+      /// "CHNK"
+      constexpr uint32_t chunk_magic_number = 0x4b4e4843;
+      constexpr uint32_t format_version = 1;
+      /// Written in the native byte order, to detect files produced on a machine of different endianness
+      constexpr uint32_t byte_order_mark = 0x01020304;
+      /// Alignment of the chunks and columns (bytes)
+      constexpr size_t alignment = 64;
+      /// Size of the chunk header (magic number and number of particles), padded to the alignment
+      constexpr size_t chunk_header_size = alignment;
+
+      size_t align(size_t pos) { return (pos + alignment - 1) / alignment * alignment; }
+
+      /// Size (in bytes) of one value of a column
+      size_t columnWidth(size_t col) {
+        switch (col) {
+          case columnar::eventId:
+            return sizeof(uint64_t);
+          case columnar::pdgId:
+          case columnar::charge:
+            return sizeof(int32_t);
+          case columnar::status:
+            return sizeof(ParticleBatch::Status);
+          default:
+            if (col < columnar::status)
+              return sizeof(double);
+            return ((col - columnar::hits) % columnar::num_hit_columns == columnar::num_hit_columns - 1)
+                       ? sizeof(HitTable::Status)
+                       : sizeof(double);
+        }
+      }
+
+      /// Compute the position of all columns in a chunk
+      /// \return Total size of the chunk (bytes)
+      size_t chunkLayout(size_t num_particles, size_t num_planes, std::vector<size_t>& offsets) {
+        offsets.resize(columnar::hits + num_planes * columnar::num_hit_columns);
+        size_t pos = chunk_header_size;
+        for (size_t col = 0; col < offsets.size(); ++col) {
+          offsets[col] = pos;
+          pos = align(pos + num_particles * columnWidth(col));
+        }
+        return pos;
+      }
+
+      template <typename T>
+      void put(std::vector<char>& buf, const T& val) {
+        const auto* bytes = reinterpret_cast<const char*>(&val);
+        buf.insert(buf.end(), bytes, bytes + sizeof(T));
+      }
+
+      template <typename T>
+      T get(const char* data, size_t size, size_t& pos) {
+        if (pos + sizeof(T) > size)
+          throw H_ERROR << "Truncated columnar file header.";
+        T val;
+        std::memcpy(&val, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return val;
+      }
+
+      void writeAll(int fd, const char* data, size_t size, uint64_t offset, const std::string& path) {
+        while (size > 0) {
+          const ssize_t num = ::pwrite(fd, data, size, offset);
+          if (num < 0) {
+            if (errno == EINTR)
+              continue;
+            throw H_ERROR << "Failed to write into \"" << path << "\": " << std::strerror(errno) << ".";
+          }
+          data += num;
+          size -= num;
+          offset += num;
+        }
+      }
+    }  // namespace
+
+    //----- writer
+
+    ColumnarWriter::ColumnarWriter(const std::string& path, const ObservationPlanes& planes)
+        : path_(path), fd_(-1), num_planes_(planes.size()), offset_(0), num_particles_(0) {
+      fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd_ < 0)
+        throw H_ERROR << "Impossible to open file \"" << path << "\" for writing: " << std::strerror(errno) << ".";
+      std::vector<char> hdr;
+      put(hdr, magic_number);
+      put(hdr, format_version);
+      put(hdr, byte_order_mark);
+      put(hdr, (uint32_t)num_planes_);
+      for (const auto& plane : planes) {
+        put(hdr, plane.s);
+        put(hdr, (uint32_t)plane.name.size());
+        hdr.insert(hdr.end(), plane.name.begin(), plane.name.end());
+      }
+      hdr.resize(align(hdr.size()), 0);
+      writeAll(fd_, hdr.data(), hdr.size(), 0, path_);
+      offset_ = hdr.size();
+    }
+
+    ColumnarWriter::~ColumnarWriter() {
+      try {
+        close();
+      } catch (const Exception&) {
+      }
+    }
+
+    void ColumnarWriter::append(const ParticleBatch& batch,
+                                const HitTable* hits,
+                                const uint64_t* event_ids,
+                                const int32_t* pdg_ids) {
+      if (fd_ < 0)
+        throw H_ERROR << "File \"" << path_ << "\" is already closed.";
+      const size_t num = batch.size();
+      if (num == 0)
+        return;
+      if (hits && (hits->numParticles() != num || hits->numPlanes() != num_planes_))
+        throw H_ERROR << "Hits table (" << hits->numParticles() << " particles, " << hits->numPlanes()
+                      << " planes) does not match the chunk (" << num << " particles, " << num_planes_ << " planes).";
+
+      // serialise the chunk locally
+      std::vector<size_t> offsets;
+      std::vector<char> buf(chunkLayout(num, num_planes_, offsets), 0);
+      std::memcpy(buf.data(), &chunk_magic_number, sizeof(uint32_t));
+      const uint64_t num_parts = num;
+      std::memcpy(buf.data() + 8, &num_parts, sizeof(uint64_t));
+      const auto fill = [&buf, &offsets, num](size_t col, const void* src) {
+        std::memcpy(buf.data() + offsets[col], src, num * columnWidth(col));
+      };
+      if (event_ids)
+        fill(columnar::eventId, event_ids);
+      if (pdg_ids)
+        fill(columnar::pdgId, pdg_ids);
+      fill(columnar::charge, batch.charge());
+      fill(columnar::mass, batch.mass());
+      fill(columnar::s, batch.s());
+      for (unsigned short j = 0; j < 6; ++j)
+        fill(columnar::stateVector + j, batch.component((StateVector::Components)j));
+      fill(columnar::status, batch.status());
+      for (size_t p = 0; p < num_planes_; ++p) {
+        const size_t first = columnar::hits + p * columnar::num_hit_columns;
+        auto* x = reinterpret_cast<double*>(buf.data() + offsets[first]);
+        auto* y = reinterpret_cast<double*>(buf.data() + offsets[first + 1]);
+        auto* tx = reinterpret_cast<double*>(buf.data() + offsets[first + 2]);
+        auto* ty = reinterpret_cast<double*>(buf.data() + offsets[first + 3]);
+        auto* status = reinterpret_cast<HitTable::Status*>(buf.data() + offsets[first + 4]);
+        for (size_t i = 0; i < num; ++i) {
+          if (!hits) {
+            status[i] = HitTable::Status::notReached;
+            continue;
+          }
+          const auto& hit = (*hits)(i, p);
+          x[i] = hit.x;
+          y[i] = hit.y;
+          tx[i] = hit.tx;
+          ty[i] = hit.ty;
+          status[i] = hit.status;
+        }
+      }
+      // reserve the chunk position, and write it independently of the other threads
+      const uint64_t offset = offset_.fetch_add(buf.size());
+      writeAll(fd_, buf.data(), buf.size(), offset, path_);
+      num_particles_ += num;
+    }
+
+    void ColumnarWriter::close() {
+      if (fd_ < 0)
+        return;
+      const int fd = fd_;
+      fd_ = -1;
+      if (::close(fd) != 0)
+        throw H_ERROR << "Failed to close \"" << path_ << "\": " << std::strerror(errno) << ".";
+    }
+
+    //----- reader
+
+    ColumnarReader::ColumnarReader(const std::string& path) : file_(path), version_(0), num_particles_(0) {
+      const char* data = file_.data();
+      const size_t size = file_.size();
+      size_t pos = 0;
+      if (get<uint32_t>(data, size, pos) != magic_number)
+        throw H_ERROR << "Invalid magic number retrieved for file \"" << path << "\"!";
+      version_ = get<uint32_t>(data, size, pos);
+      if (version_ > format_version)
+        throw H_ERROR << "Columnar file version " << version_ << " is not (yet) supported! Currently peaking at "
+                      << format_version << ".";
+      if (get<uint32_t>(data, size, pos) != byte_order_mark)
+        throw H_ERROR << "File \"" << path << "\" was written with a different byte order.";
+      const auto num_planes = get<uint32_t>(data, size, pos);
+      for (uint32_t i = 0; i < num_planes; ++i) {
+        const auto s = get<double>(data, size, pos);
+        const auto len = get<uint32_t>(data, size, pos);
+        if (pos + len > size)
+          throw H_ERROR << "Truncated columnar file header.";
+        planes_.add(std::string(data + pos, len), s);
+        pos += len;
+      }
+      // index all chunks
+      for (pos = align(pos); pos < size;) {
+        if (pos + chunk_header_size > size || get<uint32_t>(data, size, pos) != chunk_magic_number)
+          throw H_ERROR << "Invalid chunk header retrieved at byte " << pos << " of file \"" << path << "\".";
+        pos += 4;
+        Chunk chunk;
+        chunk.data_ = data + pos - 8;
+        chunk.size_ = get<uint64_t>(data, size, pos);
+        const size_t chunk_size = chunkLayout(chunk.size_, num_planes, chunk.offsets_);
+        pos = (chunk.data_ - data) + chunk_size;
+        if (pos > size)
+          throw H_ERROR << "Truncated chunk retrieved in file \"" << path << "\".";
+        num_particles_ += chunk.size_;
+        chunks_.emplace_back(std::move(chunk));
+      }
+    }
+
+    void ColumnarReader::read(ParticleBatch& batch) const {
+      size_t offset = batch.size();
+      batch.resize(offset + num_particles_);
+      for (const auto& chunk : chunks_) {
+        const size_t num = chunk.size();
+        std::copy(chunk.charge(), chunk.charge() + num, batch.charge() + offset);
+        std::copy(chunk.mass(), chunk.mass() + num, batch.mass() + offset);
+        std::copy(chunk.s(), chunk.s() + num, batch.s() + offset);
+        for (unsigned short j = 0; j < 6; ++j) {
+          const auto comp = (StateVector::Components)j;
+          std::copy(chunk.component(comp), chunk.component(comp) + num, batch.component(comp) + offset);
+        }
+        std::copy(chunk.status(), chunk.status() + num, batch.status() + offset);
+        offset += num;
+      }
+    }
+
+    HitTable ColumnarReader::hits() const {
+      HitTable table(num_particles_, planes_.size());
+      size_t offset = 0;
+      for (const auto& chunk : chunks_) {
+        for (size_t p = 0; p < planes_.size(); ++p)
+          for (size_t i = 0; i < chunk.size(); ++i)
+            table(offset + i, p) = HitTable::Hit{
+                chunk.hitX(p)[i], chunk.hitY(p)[i], chunk.hitTx(p)[i], chunk.hitTy(p)[i], chunk.hitStatus(p)[i]};
+        offset += chunk.size();
+      }
+      return table;
+    }
+  }  // namespace io
+}  // namespace hector
@@ -8,6 +8,7 @@
 #include "Hector/Elements/Dipole.h"
 #include "Hector/Elements/Quadrupole.h"
 #include "Hector/Elements/Collimator.h"
+#include "Hector/Elements/Marker.h"
 
 #include "Hector/Apertures/Rectangular.h"
 #include "Hector/Apertures/Circular.h"
@@ -16,28 +17,139 @@
 
 #include "Hector/IO/HBLFileStructures.h"
 
+#include "Hector/Utils/Hash.h"
+#include "Hector/Utils/MappedFile.h"
+
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 
 namespace hector {
   namespace io {
+    namespace {
+      /// Build an element from its type and main properties (nullptr if the type is not supported)
+      element::ElementPtr makeElement(element::Type type, const std::string& name, double s, double length, double k) {
+        switch (type) {
+          case element::aMarker:
+            return std::make_shared<element::Marker>(name, s, length);
+          case element::aDrift:
+          case element::aMonitor:
+          case element::anInstrument:
+            return std::make_shared<element::Drift>(name, type, s, length);
+          case element::aRectangularDipole:
+            return std::make_shared<element::RectangularDipole>(name, s, length, k);
+          case element::aSectorDipole:
+            return std::make_shared<element::SectorDipole>(name, s, length, k);
+          case element::aVerticalQuadrupole:
+            return std::make_shared<element::VerticalQuadrupole>(name, s, length, k);
+          case element::anHorizontalQuadrupole:
+            return std::make_shared<element::HorizontalQuadrupole>(name, s, length, k);
+          case element::aVerticalKicker:
+            return std::make_shared<element::VerticalKicker>(name, s, length, k);
+          case element::anHorizontalKicker:
+            return std::make_shared<element::HorizontalKicker>(name, s, length, k);
+          case element::aRectangularCollimator:
+          case element::anEllipticalCollimator:
+          case element::aCircularCollimator:
+          case element::aCollimator: {
+            auto coll = std::make_shared<element::Collimator>(name, s, length);
+            coll->setType(type);
+            return coll;
+          }
+          default:
+            return nullptr;
+        }
+      }
+
+      /// Build an aperture from its type and shape parameters (nullptr if the type is not supported)
+      std::shared_ptr<aperture::ApertureBase> makeAperture(aperture::Type type,
+                                                           const double* par,
+                                                           const TwoVector& pos) {
+        std::shared_ptr<aperture::ApertureBase> apert;
+        switch (type) {
+          case aperture::aRectangularAperture:
+            apert = std::make_shared<aperture::Rectangular>(par[0], par[1], pos);
+            break;
+          case aperture::anEllipticAperture:
+          case aperture::aCircularAperture:
+            apert = std::make_shared<aperture::Elliptic>(par[0], par[1], pos);
+            break;
+          case aperture::aRectEllipticAperture:
+          case aperture::aRectCircularAperture:
+            apert = std::make_shared<aperture::RectElliptic>(par[0], par[1], par[2], par[3], pos);
+            break;
+          default:
+            return nullptr;
+        }
+        apert->setType(type);
+        return apert;
+      }
+
+      /// Table of NUL-terminated strings, each stored once
+      class StringsTable {
+      public:
+        /// Add a string to the table
+        /// \return Offset of the string in the table
+        uint32_t add(const std::string& str) {
+          const auto it = offsets_.find(str);
+          if (it != offsets_.end())
+            return it->second;
+          const uint32_t offset = data_.size();
+          data_.append(str).push_back('\0');
+          offsets_.emplace(str, offset);
+          return offset;
+        }
+        /// Content of the table, padded to a multiple of 8 bytes
+        const std::string& data() {
+          data_.resize((data_.size() + 7) / 8 * 8, '\0');
+          return data_;
+        }
+
+      private:
+        std::string data_;
+        std::unordered_map<std::string, uint32_t> offsets_;
+      };
+    }  // namespace
+
     HBL::HBL(const std::string& filename) : beamline_(new Beamline) { parse(filename); }
 
-    HBL::HBL(HBL& rhs) : beamline_(std::move(rhs.beamline_)) {}
+    HBL::HBL(MappedFile&& file) : beamline_(new Beamline) { parseV2(std::move(file)); }
+
+    HBL::HBL(HBL& rhs)
+        : file_(std::move(rhs.file_)),
+          beamline_(std::move(rhs.beamline_)),
+          header_str_(rhs.header_str_),
+          header_float_(rhs.header_float_) {}
 
     void HBL::parse(const std::string& filename) {
       std::ifstream file(filename, std::ios::binary | std::ios::in);
       if (!file.is_open())
         throw H_ERROR << "Impossible to open file \"" << filename << "\" for reading!";
 
+      // common part to all layouts
       HBLHeader hdr;
       file.read(reinterpret_cast<char*>(&hdr), sizeof(HBLHeader));
       if (hdr.magic != magic_number)
         throw H_ERROR << "Invalid magic number retrieved for file \"" << filename << "\"!";
+      file.close();
 
-      if (hdr.version > version)
+      if (hdr.version == version_v1)
+        parseV1(filename);
+      else if (hdr.version == version)
+        parseV2(filename);
+      else
         throw H_ERROR << "Version " << hdr.version << " is not (yet) supported! Currently peaking at " << version
                       << "!";
+    }
+
+    void HBL::parseV1(const std::string& filename) {
+      std::ifstream file(filename, std::ios::binary | std::ios::in);
+      if (!file.is_open())
+        throw H_ERROR << "Impossible to open file \"" << filename << "\" for reading!";
+
+      HBLHeader hdr;
+      file.read(reinterpret_cast<char*>(&hdr), sizeof(HBLHeader));
 
       HBLElement el;
       std::shared_ptr<element::ElementBase> elem;
@@ -118,7 +230,7 @@ namespace hector {
             elem->setAperture(std::make_shared<aperture::RectElliptic>(el.aperture_p1,
                                                                        el.aperture_p2,
                                                                        el.aperture_p3,
-                                                                       el.aperture_p3,
+                                                                       el.aperture_p4,
                                                                        TwoVector(el.aperture_x, el.aperture_y)));
             break;
           //case aperture::aRaceTrackAperture:
@@ -133,40 +245,221 @@ namespace hector {
         throw H_ERROR << "Expecting " << hdr.num_elements << " elements, retrieved " << beamline_->numElements() << "!";
     }
 
-    void HBL::write(const Beamline* bl, const std::string& filename) {
+    void HBL::parseV2(const std::string& filename) {
+      MappedFile file(filename);
+      const auto failure = check(file);
+      if (!failure.empty())
+        throw H_ERROR << "Invalid HBL file \"" << filename << "\": " << failure << ".";
+      parseV2(std::move(file));
+    }
+
+    void HBL::parseV2(MappedFile&& file) {
+      file_.reset(new MappedFile(std::move(file)));
+      const auto& hdr = header();
+
+      const auto* vars = reinterpret_cast<const HBLVariable*>(file_->data() + hdr.variables_offset);
+      const char* strings = file_->data() + hdr.strings_offset;
+      for (uint32_t i = 0; i < hdr.num_variables; ++i) {
+        if (vars[i].type == HBLVariable::string)
+          header_str_[strings + vars[i].name] = strings + vars[i].string_value;
+        else
+          header_float_[strings + vars[i].name] = vars[i].float_value;
+      }
+
+      // all element records, in their sequence ordering
+      element::Elements records;
+      records.reserve(hdr.num_records);
+      for (size_t i = 0; i < hdr.num_records; ++i) {
+        const auto& rec = record(i);
+        auto elem = makeElement((element::Type)rec.element_type,
+                                name(rec),
+                                rec.element_s,
+                                rec.element_length,
+                                rec.element_magnetic_strength);
+        if (!elem)
+          throw H_ERROR << "Invalid element type: " << rec.element_type << ".";
+        elem->setPosition(TwoVector(rec.element_x, rec.element_y));
+        elem->setAngles(TwoVector(rec.element_tx, rec.element_ty));
+        elem->setBeta(TwoVector(rec.beta_x, rec.beta_y));
+        elem->setDispersion(TwoVector(rec.dispersion_x, rec.dispersion_y));
+        elem->setRelativePosition(TwoVector(rec.relative_x, rec.relative_y));
+        if (rec.aperture_type != aperture::anInvalidAperture) {
+          auto apert = makeAperture(
+              (aperture::Type)rec.aperture_type, rec.aperture_p, TwoVector(rec.aperture_x, rec.aperture_y));
+          if (apert)
+            elem->setAperture(apert);
+          else
+            H_WARNING << "Aperture of type " << (aperture::Type)rec.aperture_type << " for element \"" << elem->name()
+                      << "\" cannot be built. Ignoring it.";
+        }
+        records.emplace_back(elem);
+      }
+      for (size_t i = 0; i < hdr.num_records; ++i)
+        if (record(i).parent_element >= 0)
+          records[i]->setParentElement(records[record(i).parent_element]);
+
+      // elements are stored in their sequence ordering
+      beamline_->setLength(hdr.max_length);
+      beamline_->elements().assign(records.begin(), records.begin() + hdr.num_elements);
+      if (hdr.interaction_point >= 0)
+        beamline_->setInteractionPoint(records[hdr.interaction_point]);
+    }
+
+    std::string HBL::check(const MappedFile& file) {
+      if (file.size() < sizeof(HBLHeaderV2))
+        return "truncated header";
+      const auto& hdr = *reinterpret_cast<const HBLHeaderV2*>(file.data());
+      if (hdr.magic != magic_number || hdr.version != version)
+        return "invalid magic number or version";
+      if (hdr.byte_order != byte_order)
+        return "written on a host of another byte order";
+      if (hdr.header_size != sizeof(HBLHeaderV2) || hdr.element_size != sizeof(HBLElementV2))
+        return "invalid header or element record size";
+      if (hdr.num_elements > hdr.num_records || hdr.num_records > hdr.num_elements + 1 ||
+          hdr.interaction_point >= (int32_t)hdr.num_records)
+        return "invalid number of elements";
+      // all tables are contiguous
+      if (hdr.elements_offset != hdr.header_size ||
+          hdr.variables_offset != hdr.elements_offset + (uint64_t)hdr.num_records * sizeof(HBLElementV2) ||
+          hdr.strings_offset != hdr.variables_offset + (uint64_t)hdr.num_variables * sizeof(HBLVariable) ||
+          hdr.strings_offset + hdr.strings_size != file.size() || hdr.strings_size % 8 != 0)
+        return "invalid tables layout";
+      if (hdr.strings_size == 0 || file.data()[file.size() - 1] != '\0')
+        return "invalid strings table";
+      if (Hash().addBlock(file.data() + hdr.elements_offset, file.size() - hdr.elements_offset).value() !=
+          hdr.checksum)
+        return "checksum mismatch";
+      // references between tables
+      const auto* recs = reinterpret_cast<const HBLElementV2*>(file.data() + hdr.elements_offset);
+      for (uint32_t i = 0; i < hdr.num_records; ++i)
+        if (recs[i].element_name >= hdr.strings_size || recs[i].parent_element >= (int32_t)hdr.num_records)
+          return "invalid element record";
+      const auto* vars = reinterpret_cast<const HBLVariable*>(file.data() + hdr.variables_offset);
+      for (uint32_t i = 0; i < hdr.num_variables; ++i)
+        if (vars[i].name >= hdr.strings_size || vars[i].string_value >= hdr.strings_size)
+          return "invalid header variable";
+      return std::string();
+    }
+
+    bool HBL::valid(const std::string& filename) {
+      if (!std::ifstream(filename).good())
+        return false;
+      return check(MappedFile(filename)).empty();
+    }
+
+    const HBLHeaderV2& HBL::header() const {
+      if (!file_)
+        throw H_ERROR << "Element records are only accessible in place for HBL files in the version 2 layout.";
+      return *reinterpret_cast<const HBLHeaderV2*>(file_->data());
+    }
+
+    size_t HBL::numRecords() const { return header().num_records; }
+
+    const HBLElementV2& HBL::record(size_t i) const {
+      return reinterpret_cast<const HBLElementV2*>(file_->data() + header().elements_offset)[i];
+    }
+
+    const char* HBL::name(const HBLElementV2& rec) const {
+      return file_->data() + header().strings_offset + rec.element_name;
+    }
+
+    void HBL::write(const Beamline* bl,
+                    const std::string& filename,
+                    const std::map<std::string, std::string>& header_strings,
+                    const std::map<std::string, float>& header_floats) {
       std::ofstream file(filename, std::ios::binary | std::ios::out);
-      {  // start by writing the file header
-        HBLHeader hdr;
-        hdr.magic = magic_number;
-        hdr.version = version;
-        hdr.num_elements = bl->numElements();
-        file.write(reinterpret_cast<char*>(&hdr), sizeof(HBLHeader));
+      if (!file.is_open())
+        throw H_ERROR << "Impossible to open file \"" << filename << "\" for writing!";
+      write(bl, file, header_strings, header_floats);
+      if (!file)
+        throw H_ERROR << "Failed to write the beamline into \"" << filename << "\"!";
+    }
+
+    void HBL::write(const Beamline* bl,
+                    std::ostream& os,
+                    const std::map<std::string, std::string>& header_strings,
+                    const std::map<std::string, float>& header_floats) {
+      StringsTable strings;
+
+      // elements records, and the interaction point if not part of the sequence
+      std::vector<const element::ElementBase*> elements;
+      std::unordered_map<const element::ElementBase*, int32_t> indices;
+      for (const auto& elem : *bl) {
+        indices.emplace(elem.get(), elements.size());
+        elements.emplace_back(elem.get());
       }
-      {  // then add all individual elements
-        for (const auto& elem : *bl) {
-          HBLElement el;
-          el.element_type = elem->type();
-          if (!elem->name().empty())
-            elem->name().copy(el.element_name, sizeof(el.element_name));
-          el.element_s = elem->s();
-          el.element_length = elem->length();
-          el.element_magnetic_strength = elem->magneticStrength();
-          if (elem->aperture()) {
-            el.aperture_type = elem->aperture()->type();
-            if (elem->aperture()->parameters().size() > 0)
-              el.aperture_p1 = elem->aperture()->p(0);
-            if (elem->aperture()->parameters().size() > 1)
-              el.aperture_p2 = elem->aperture()->p(1);
-            if (elem->aperture()->parameters().size() > 2)
-              el.aperture_p3 = elem->aperture()->p(2);
-            if (elem->aperture()->parameters().size() > 3)
-              el.aperture_p4 = elem->aperture()->p(3);
-            el.aperture_x = elem->aperture()->x();
-            el.aperture_y = elem->aperture()->y();
-          }
-          file.write(reinterpret_cast<char*>(&el), sizeof(HBLElement));
+      const auto* ip = bl->interactionPoint().get();
+      if (ip && indices.count(ip) == 0) {
+        indices.emplace(ip, elements.size());
+        elements.emplace_back(ip);
+      }
+      std::vector<HBLElementV2> records(elements.size());
+      for (size_t i = 0; i < elements.size(); ++i) {
+        const auto& elem = *elements[i];
+        auto& rec = records[i];
+        std::memset(&rec, 0, sizeof(HBLElementV2));
+        rec.element_type = elem.type();
+        rec.element_name = strings.add(elem.name());
+        const auto parent = indices.find(elem.parentElement());
+        rec.parent_element = (parent != indices.end()) ? parent->second : -1;
+        rec.element_s = elem.s();
+        rec.element_length = elem.length();
+        rec.element_magnetic_strength = elem.magneticStrength();
+        rec.element_x = elem.x();
+        rec.element_y = elem.y();
+        rec.element_tx = elem.Tx();
+        rec.element_ty = elem.Ty();
+        rec.beta_x = elem.beta().x();
+        rec.beta_y = elem.beta().y();
+        rec.dispersion_x = elem.dispersion().x();
+        rec.dispersion_y = elem.dispersion().y();
+        rec.relative_x = elem.relativePosition().x();
+        rec.relative_y = elem.relativePosition().y();
+        rec.aperture_type = aperture::anInvalidAperture;
+        if (const auto* apert = elem.aperture()) {
+          rec.aperture_type = apert->type();
+          rec.aperture_x = apert->x();
+          rec.aperture_y = apert->y();
+          for (size_t j = 0; j < std::min(apert->parameters().size(), (size_t)4); ++j)
+            rec.aperture_p[j] = apert->p(j);
         }
       }
+
+      // header variables
+      std::vector<HBLVariable> vars;
+      for (const auto& var : header_strings)
+        vars.emplace_back(HBLVariable{strings.add(var.first), HBLVariable::string, strings.add(var.second), 0, 0.});
+      for (const auto& var : header_floats)
+        vars.emplace_back(HBLVariable{strings.add(var.first), HBLVariable::floating, 0, 0, var.second});
+
+      const auto& strings_data = strings.data();
+      HBLHeaderV2 hdr;
+      std::memset(&hdr, 0, sizeof(HBLHeaderV2));
+      hdr.magic = magic_number;
+      hdr.version = version;
+      hdr.header_size = sizeof(HBLHeaderV2);
+      hdr.byte_order = byte_order;
+      hdr.element_size = sizeof(HBLElementV2);
+      hdr.num_elements = bl->elements().size();
+      hdr.num_records = records.size();
+      hdr.interaction_point = ip ? indices.at(ip) : -1;
+      hdr.num_variables = vars.size();
+      hdr.max_length = bl->maxLength();
+      hdr.elements_offset = sizeof(HBLHeaderV2);
+      hdr.variables_offset = hdr.elements_offset + records.size() * sizeof(HBLElementV2);
+      hdr.strings_offset = hdr.variables_offset + vars.size() * sizeof(HBLVariable);
+      hdr.strings_size = strings_data.size();
+      // all tables are 8-byte aligned: hashed in turn, as they are contiguous in the file
+      hdr.checksum = Hash()
+                         .addBlock(records.data(), records.size() * sizeof(HBLElementV2))
+                         .addBlock(vars.data(), vars.size() * sizeof(HBLVariable))
+                         .addBlock(strings_data.data(), strings_data.size())
+                         .value();
+
+      os.write(reinterpret_cast<const char*>(&hdr), sizeof(HBLHeaderV2));
+      os.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(HBLElementV2));
+      os.write(reinterpret_cast<const char*>(vars.data()), vars.size() * sizeof(HBLVariable));
+      os.write(strings_data.data(), strings_data.size());
     }
   }  // namespace io
 }  // namespace hector
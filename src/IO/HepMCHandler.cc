@@ -0,0 +1,149 @@
+#include "Hector/IO/HepMCHandler.h"
+
+#ifdef HEPMC
+#include "HepMC/Version.h"
+#ifdef HEPMC_VERSION_CODE  // HepMC v3+
+#define GOOD_HEPMC
+#include "HepMC/Attribute.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenParticle.h"
+#include "HepMC/ReaderAscii.h"
+#include "HepMC/WriterAscii.h"
+#endif
+#endif
+
+#ifndef GOOD_HEPMC
+#pragma message "No HepMC v3+ release was found on your system! Disabling HepMC events processing!"
+#endif
+
+#include "Hector/Exception.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/Propagator.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace hector {
+  namespace io {
+    HepMC::HepMC(const std::string& input, const std::string& output, const PropagationContext& ctx)
+        : input_(input),
+          output_(output),
+          context_(ctx),
+          arms_{{nullptr, 0., {}}, {nullptr, 0., {}}},
+          min_abs_eta_(0.),
+          charged_only_(true) {
+      runtime_.setOrdered(true);
+#ifndef GOOD_HEPMC
+      throw H_ERROR << "No HepMC v3+ release was found to process \"" << input << "\".";
+#endif
+    }
+
+    HepMC& HepMC::setBeamline(Arm arm, const Beamline* bl, double s_max, const ObservationPlanes& planes) {
+      arms_[(size_t)arm] = ArmSettings{bl, s_max, planes};
+      return *this;
+    }
+
+    int HepMC::charge(int pdg_id) {
+      // three times the charge of the d, u, s, c, b, t quarks
+      static const int quark_charge[] = {0, -1, 2, -1, 2, -1, 2};
+      const int id = std::abs(pdg_id), sign = (pdg_id > 0) ? +1 : -1;
+      if (id == 11 || id == 13 || id == 15)
+        return -sign;
+      if (id == 24 || id == 37)
+        return sign;
+      if (id > 1000000000)  // nuclei (10LZZZAAAI)
+        return sign * ((id / 10000) % 1000);
+      const int nq1 = (id / 1000) % 10, nq2 = (id / 100) % 10, nq3 = (id / 10) % 10;
+      if (id < 100 || id >= 10000000 || nq2 > 6 || nq3 > 6 || nq1 > 6)
+        return 0;
+      int charge3 = 0;
+      if (nq1 == 0)  // mesons: heavier down-type quarks come as antiquarks
+        charge3 = (nq2 == 3 || nq2 == 5) ? quark_charge[nq3] - quark_charge[nq2]
+                                         : quark_charge[nq2] - quark_charge[nq3];
+      else  // baryons
+        charge3 = quark_charge[nq1] + quark_charge[nq2] + quark_charge[nq3];
+      return sign * charge3 / 3;
+    }
+
+    uint64_t HepMC::run() const {
+#ifndef GOOD_HEPMC
+      return 0;
+#else
+      // compile the beamline of each arm once, for all workers
+      std::unique_ptr<PropagationPlan> plans[2];
+      for (size_t i = 0; i < 2; ++i)
+        if (arms_[i].beamline)
+          plans[i].reset(new PropagationPlan(arms_[i].beamline, arms_[i].s_max));
+      if (!plans[0] && !plans[1])
+        throw H_ERROR << "No beamline was set to propagate the particles of \"" << input_ << "\".";
+
+      ::HepMC::ReaderAscii reader(input_);
+      if (reader.failed())
+        throw H_ERROR << "Impossible to open file \"" << input_ << "\" for reading.";
+      ::HepMC::WriterAscii writer(output_);
+      if (writer.failed())
+        throw H_ERROR << "Impossible to open file \"" << output_ << "\" for writing.";
+
+      typedef std::unique_ptr<::HepMC::GenEvent> EventPtr;
+      const auto num_written = runtime_.run(
+          // read-ahead stage
+          [&reader](EventPtr& evt) {
+            evt.reset(new ::HepMC::GenEvent);
+            return reader.read_event(*evt) && !reader.failed();
+          },
+          // propagation stage, with a propagator and a hits buffer per arm for each worker
+          [this, &plans]() -> StreamingPipeline<EventPtr>::Process {
+            std::shared_ptr<Propagator> props[2];
+            std::vector<HitTable::Hit> hits[2];
+            for (size_t j = 0; j < 2; ++j) {
+              if (!plans[j])
+                continue;
+              props[j] = std::make_shared<Propagator>(arms_[j].beamline, context_);
+              props[j]->setRecording(Propagator::Recording::observationPlanes);
+              props[j]->observationPlanes() = arms_[j].planes;
+              hits[j].resize(arms_[j].planes.size());
+            }
+            return [this, &plans, props, hits](EventPtr& evt) mutable {
+              evt->set_units(::HepMC::Units::GEV, ::HepMC::Units::MM);
+              for (const auto& gen_part : evt->particles()) {
+                if (gen_part->status() != 1)  // final-state particles only
+                  continue;
+                const auto& mom = gen_part->momentum();
+                if (mom.pz() == 0. || std::fabs(mom.eta()) < min_abs_eta_)
+                  continue;
+                const int ch = charge(gen_part->pid());
+                if (charged_only_ && ch == 0)
+                  continue;
+                const size_t arm = (mom.pz() > 0.) ? 0 : 1;
+                if (!plans[arm])
+                  continue;
+                const double sign = (arm == 0) ? +1. : -1.;
+                Particle part(LorentzVector(sign * mom.px(), mom.py(), sign * mom.pz(), mom.e()), ch, gen_part->pid());
+                const auto result = props[arm]->readout(part, *plans[arm], hits[arm].data());
+                gen_part->add_attribute("hector_status", std::make_shared<::HepMC::IntAttribute>((int)result.status()));
+                const auto& planes = arms_[arm].planes;
+                for (size_t k = 0; k < planes.size(); ++k) {
+                  const auto& hit = hits[arm][k];
+                  if (hit.status != HitTable::Status::reached)
+                    continue;
+                  const std::string prefix = "hector_" + planes[k].name + "_";
+                  gen_part->add_attribute(prefix + "x", std::make_shared<::HepMC::DoubleAttribute>(hit.x));
+                  gen_part->add_attribute(prefix + "y", std::make_shared<::HepMC::DoubleAttribute>(hit.y));
+                  gen_part->add_attribute(prefix + "tx", std::make_shared<::HepMC::DoubleAttribute>(hit.tx));
+                  gen_part->add_attribute(prefix + "ty", std::make_shared<::HepMC::DoubleAttribute>(hit.ty));
+                }
+              }
+            };
+          },
+          // write-behind stage, in the calling thread, in the input ordering
+          [&writer](EventPtr& evt) { writer.write_event(*evt); });
+      if (writer.failed())
+        throw H_ERROR << "Failed to write into \"" << output_ << "\".";
+      writer.close();
+      reader.close();
+      return num_written;
+#endif
+    }
+  }  // namespace io
+}  // namespace hector
@@ -2,6 +2,7 @@
 #include "Hector/Exception.h"
 
 #include "Hector/Beamline.h"
+#include "Hector/BeamlineBuilder.h"
 
 #include "Hector/Elements/Quadrupole.h"
 #include "Hector/Elements/Dipole.h"
@@ -14,20 +15,77 @@
 #include "Hector/Apertures/Rectangular.h"
 #include "Hector/Apertures/RectElliptic.h"
 
+#include "Hector/Utils/MappedFile.h"
 #include "Hector/Utils/String.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 namespace hector {
-  /*  namespace pmap
-  {
-    //template class Unordered<io::Twiss::ValueType>;
-    template const std::string Unordered<io::Twiss::ValueType>::key( const size_t i ) const;
-  }*/
   namespace io {
-    std::regex Twiss::rgx_typ_("^\\%[0-9]{0,}(s|le)$");
-    std::regex Twiss::rgx_hdr_("^\\@ (\\w+) +\\%([0-9]+s|le) +\\\"?([^\"\\n]+)");
-    std::regex Twiss::rgx_elm_hdr_("^\\s{0,}([\\*\\$])(.+)");
+    namespace {
+      /// Names of the element fields used to build the beamline elements, in the Twiss::Column ordering
+      const char* const column_names[] = {
+          "name", "keyword", "s", "l", "k0l", "k1l", "hkick", "vkick", "x", "y", "betx", "bety", "dx", "dy", "apertype",
+          "aper_1", "aper_2", "aper_3", "aper_4"};
+
+      bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+      /// Extract the next line of a buffer, without its end-of-line character
+      bool nextLine(const char*& pos, const char* end, const char*& begin, const char*& line_end) {
+        if (pos >= end)
+          return false;
+        begin = pos;
+        const auto* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        line_end = eol ? eol : end;
+        pos = eol ? eol + 1 : end;
+        return true;
+      }
+
+      /// Extract the next blank-separated field of a line ; quoted strings may hold blanks
+      bool nextField(const char*& pos, const char* end, const char*& begin, const char*& field_end) {
+        while (pos < end && isBlank(*pos))
+          ++pos;
+        if (pos >= end)
+          return false;
+        begin = pos;
+        if (*pos == '"') {
+          const auto* quote = static_cast<const char*>(std::memchr(pos + 1, '"', end - pos - 1));
+          pos = quote ? quote + 1 : end;
+        } else
+          while (pos < end && !isBlank(*pos))
+            ++pos;
+        field_end = pos;
+        return true;
+      }
+
+      /// Strip the quotes surrounding a field
+      void unquote(const char*& begin, const char*& end) {
+        while (begin < end && *begin == '"')
+          ++begin;
+        while (end > begin && *(end - 1) == '"')
+          --end;
+      }
+
+      /// Convert a field into a floating-point value
+      float toFloat(const char* begin, const char* end, size_t line) {
+        char buf[64];
+        const size_t len = end - begin;
+        if (len == 0 || len >= sizeof(buf))
+          throw H_ERROR << "Invalid numerical value \"" << std::string(begin, end) << "\" at line " << line << ".";
+        std::memcpy(buf, begin, len);
+        buf[len] = '\0';
+        char* stop = nullptr;
+        const double val = std::strtod(buf, &stop);
+        if (stop != buf + len)
+          throw H_ERROR << "Invalid numerical value \"" << buf << "\" at line " << line << ".";
+        return (float)val;
+      }
+    }  // namespace
+
     std::regex Twiss::rgx_drift_name_("DRIFT\\_[0-9]+");
     std::regex Twiss::rgx_quadrup_name_("M[B,Q]\\w+\\d?\\.\\w?\\d[L,R]\\d(\\.B[1,2])?");
     std::regex Twiss::rgx_sect_dipole_name_("MB\\.[A-Z][0-9]{1,2}[L,R][0-9]\\.B[1,2]");
@@ -37,38 +95,22 @@ namespace hector {
     std::regex Twiss::rgx_rect_coll_name_("T[C,A].*\\.\\d[L,R]\\d\\.?(B[1-9])?");
 
     Twiss::Twiss(std::string filename, std::string ip_name, float max_s, float min_s)
-        : in_file_(filename), ip_name_(ip_name), min_s_(min_s) {
-      if (!in_file_.is_open())
-        throw H_ERROR << "Failed to open the Twiss file \"" << filename << "\"\n\tPlease check the path!";
-      parseHeader();
+        : ip_name_(ip_name), min_s_(min_s) {
+      const MappedFile file(filename);
+      const char *pos = file.data(), *end = file.data() + file.size();
+      parseHeader(pos, end);
 
       raw_beamline_ = std::unique_ptr<Beamline>(new Beamline(max_s - min_s));
       if (max_s < 0. && header_float_.hasKey("length"))
         raw_beamline_->setLength(header_float_.get("length"));
-      if (header_float_.hasKey("energy") && Parameters::get()->beamEnergy() != header_float_.get("energy")) {
-        Parameters::get()->setBeamEnergy(header_float_.get("energy"));
-        H_WARNING << "Beam energy changed to " << Parameters::get()->beamEnergy()
-                  << " GeV to match Twiss optics parameters.";
-      }
-      if (header_float_.hasKey("mass") && Parameters::get()->beamParticlesMass() != header_float_.get("mass")) {
-        Parameters::get()->setBeamParticlesMass(header_float_.get("mass"));
-        H_WARNING << "Beam particles mass changed to " << Parameters::get()->beamParticlesMass()
-                  << " GeV to match Twiss optics parameters.";
-      }
-      if (header_float_.hasKey("charge") &&
-          Parameters::get()->beamParticlesCharge() != static_cast<int>(header_float_.get("charge"))) {
-        Parameters::get()->setBeamParticlesCharge(static_cast<int>(header_float_.get("charge")));
-        H_WARNING << "Beam particles charge changed to " << Parameters::get()->beamParticlesCharge()
-                  << " e to match Twiss optics parameters.";
-      }
-
-      parseElementsFields();
+      updateParameters(headerFloats());
 
-      // start by identifying the interaction point
-      findInteractionPoint();
+      parseElementsFields(pos, end);
 
-      // then parse all elements
-      parseElements();
+      // single pass over the elements: identify the interaction point, then parse the beamline window around it
+      size_t ip_line = std::count(file.data(), pos, '\n') + 1;
+      const char* ip_pos = findInteractionPoint(pos, end, ip_line);
+      parseElements(pos, ip_pos, end, ip_line);
 
       beamline_ = Beamline::sequencedBeamline(raw_beamline_.get());
     }
@@ -126,28 +168,53 @@ namespace hector {
 
     std::map<std::string, float> Twiss::headerFloats() const { return header_float_.asMap(); }
 
-    void Twiss::parseHeader() {
-      if (!in_file_.is_open())
-        throw H_ERROR << "Twiss file is not opened nor ready for parsing!";
-      std::string line;
-      while (!in_file_.eof()) {
-        std::getline(in_file_, line);
-
-        try {
-          std::smatch match;
-          if (!std::regex_search(line, match, rgx_hdr_))
-            break;
-
-          const std::string key = lowercase(match.str(1));
-          if (match.str(2) == "le")
-            header_float_.add(key, std::stod(match.str(3)));
-          else
-            header_str_.add(key, match.str(3));
+    void Twiss::updateParameters(const std::map<std::string, float>& header_floats) {
+      const auto energy = header_floats.find("energy");
+      if (energy != header_floats.end() && Parameters::get()->beamEnergy() != energy->second) {
+        Parameters::get()->setBeamEnergy(energy->second);
+        H_WARNING << "Beam energy changed to " << Parameters::get()->beamEnergy()
+                  << " GeV to match Twiss optics parameters.";
+      }
+      const auto mass = header_floats.find("mass");
+      if (mass != header_floats.end() && Parameters::get()->beamParticlesMass() != mass->second) {
+        Parameters::get()->setBeamParticlesMass(mass->second);
+        H_WARNING << "Beam particles mass changed to " << Parameters::get()->beamParticlesMass()
+                  << " GeV to match Twiss optics parameters.";
+      }
+      const auto charge = header_floats.find("charge");
+      if (charge != header_floats.end() &&
+          Parameters::get()->beamParticlesCharge() != static_cast<int>(charge->second)) {
+        Parameters::get()->setBeamParticlesCharge(static_cast<int>(charge->second));
+        H_WARNING << "Beam particles charge changed to " << Parameters::get()->beamParticlesCharge()
+                  << " e to match Twiss optics parameters.";
+      }
+    }
 
-          // keep track of the last line read in the file
-          in_file_lastline_ = in_file_.tellg();
-        } catch (std::regex_error& e) {
-          throw H_ERROR << "Error at line " << in_file_.tellg() << " while parsing the header!\n\t" << e.what();
+    void Twiss::parseHeader(const char*& pos, const char* end) {
+      // header lines: "@ NAME %type value"
+      const char *line, *line_end;
+      size_t line_num = 0;
+      for (const char* next = pos; nextLine(next, end, line, line_end); pos = next) {
+        ++line_num;
+        const char *key, *key_end, *type, *type_end;
+        const char* it = line;
+        if (it == line_end || *it != '@')
+          break;
+        ++it;
+        if (!nextField(it, line_end, key, key_end) || !nextField(it, line_end, type, type_end) || *type != '%')
+          break;
+        const std::string field_type(type + 1, type_end);
+        if (field_type == "le" || field_type == "d") {
+          const char *value, *value_end;
+          if (nextField(it, line_end, value, value_end))
+            header_float_.add(lowercase(std::string(key, key_end)), toFloat(value, value_end, line_num));
+        } else if (field_type.back() == 's') {
+          while (it < line_end && isBlank(*it))
+            ++it;
+          if (it < line_end && *it == '"')
+            ++it;
+          const auto* quote = static_cast<const char*>(std::memchr(it, '"', line_end - it));
+          header_str_.add(lowercase(std::string(key, key_end)), std::string(it, quote ? quote : line_end));
         }
       }
       // parse the Twiss file production timestamp
@@ -164,178 +231,179 @@ namespace hector {
       }
     }
 
-    void Twiss::parseElementsFields() {
-      if (!in_file_.is_open())
-        throw H_ERROR << "Twiss file is not opened nor ready for parsing!";
-      std::string line;
-
-      in_file_.seekg(in_file_lastline_);
+    void Twiss::parseElementsFields(const char*& pos, const char* end) {
       std::vector<std::string> list_names, list_types;
-
-      while (!in_file_.eof()) {
-        std::getline(in_file_, line);
-
-        try {
-          std::smatch match;
-          if (!std::regex_search(line, match, rgx_elm_hdr_))
-            break;
-
-          std::string field;
-          std::stringstream str(match.str(2));
-          switch (match.str(1)[0]) {
-            case '*':
-              while (str >> field)
-                list_names.emplace_back(lowercase(field));
-              break;  // field names
-            case '$':
-              while (str >> field)
-                list_types.emplace_back(field);
-              break;  // field types
-            default:
-              break;
-          }
-          in_file_lastline_ = in_file_.tellg();
-        } catch (std::regex_error& e) {
-          throw H_ERROR << "Error at line " << in_file_.tellg() << " while parsing elements fields!\n\t" << e.what();
-        }
+      const char *line, *line_end, *field, *field_end;
+      for (const char* next = pos; nextLine(next, end, line, line_end); pos = next) {
+        const char* it = line;
+        while (it < line_end && isBlank(*it))
+          ++it;
+        if (it == line_end || (*it != '*' && *it != '$'))
+          break;
+        auto& list = (*it == '*') ? list_names : list_types;  // field names or field types
+        for (++it; nextField(it, line_end, field, field_end);)
+          list.emplace_back(field, field_end);
       }
 
-      // perform the matching name <-> data type
-      bool has_lists_matching = (list_names.size() == list_types.size());
-      for (size_t i = 0; i < list_names.size(); i++) {
+      // resolve the position of the used columns once, and perform the matching name <-> data type
+      const bool has_lists_matching = (list_names.size() == list_types.size());
+      columns_.fill(-1);
+      fields_columns_.assign(list_names.size(), -1);
+      for (size_t i = 0; i < list_names.size(); ++i) {
+        const auto name_it = std::find(std::begin(column_names), std::end(column_names), lowercase(list_names.at(i)));
+        if (name_it == std::end(column_names))
+          continue;  // field not used
+        const auto col = (Column)(name_it - std::begin(column_names));
         ValueType type = Unknown;
-        try {
-          std::smatch match;
-          if (has_lists_matching && std::regex_search(list_types.at(i), match, rgx_typ_)) {
-            if (match.str(1) == "le")
-              type = Float;
-            else if (match.str(1) == "s")
-              type = String;
-          }
-          elements_fields_.add(list_names.at(i), type);
-        } catch (std::regex_error& e) {
-          throw H_ERROR << "Error while performing the matching name-data!\n\t" << e.what();
+        if (has_lists_matching) {
+          const auto& type_str = list_types.at(i);
+          if (type_str == "%le")
+            type = Float;
+          else if (type_str.size() > 1 && type_str.front() == '%' && type_str.back() == 's' &&
+                   std::all_of(type_str.begin() + 1, type_str.end() - 1, ::isdigit))
+            type = String;
         }
+        const ValueType expected =
+            (col == Column::name || col == Column::keyword || col == Column::apertype) ? String : Float;
+        if (type != expected)
+          throw H_ERROR << "Twiss file predicts an invalid type for the optics element parameter \"" << *name_it
+                        << "\": " << type << " while " << expected << " is expected.";
+        columns_[(size_t)col] = i;
+        fields_columns_[i] = (short)col;
       }
+      for (const auto col : {Column::name, Column::s, Column::l})
+        if (!hasColumn(col))
+          throw H_ERROR << "Twiss file has no \"" << column_names[(size_t)col] << "\" column for its elements.";
     }
 
-    void Twiss::findInteractionPoint() {
-      if (!in_file_.is_open())
-        throw H_ERROR << "Twiss file is not opened nor ready for parsing!";
-      std::string line;
-      in_file_.seekg(in_file_lastline_);
-
-      while (!in_file_.eof()) {
-        std::getline(in_file_, line);
-        std::stringstream str(trim(line));
-        if (str.str().length() == 0)
+    bool Twiss::parseRecord(const char*& pos, const char* end, Record& rec) const {
+      const char *line, *line_end, *field, *field_end;
+      while (nextLine(pos, end, line, line_end)) {
+        ++rec.line;
+        const char* first = nullptr;
+        size_t num_fields = 0;
+        for (const char* it = line; nextField(it, line_end, field, field_end); ++num_fields) {
+          if (!first)
+            first = field;
+          if (num_fields < fields_columns_.size() && fields_columns_[num_fields] >= 0)
+            rec.fields[fields_columns_[num_fields]] = Token{field, field_end};
+        }
+        if (num_fields == 0)  // empty line
           continue;
-        std::string buffer;
-        ValuesCollection values;
-        while (str >> buffer)
-          values.push_back(buffer);
         // first check if the "correct" number of element properties is parsed
-        if (values.size() != elements_fields_.size())
+        if (num_fields != fields_columns_.size())
           throw H_ERROR << "Twiss file seems corrupted!\n\t"
-                        << "Element " << trim(values.at(0)) << " at line " << in_file_.tellg() << " has "
-                        << values.size() << " fields"
-                        << " when " << elements_fields_.size() << " are expected.";
+                        << "Element " << std::string(first, std::find_if(first, line_end, isBlank)) << " at line "
+                        << rec.line << " has " << num_fields << " fields"
+                        << " when " << fields_columns_.size() << " are expected.";
+        return true;
+      }
+      return false;
+    }
+
+    float Twiss::number(const Record& rec, Column col) const {
+      if (!hasColumn(col))
+        throw H_ERROR << "Twiss file has no \"" << column_names[(size_t)col] << "\" column for its elements.";
+      const auto& tok = rec.fields[(size_t)col];
+      return toFloat(tok.begin, tok.end, rec.line);
+    }
+
+    std::string Twiss::string(const Record& rec, Column col) const {
+      if (!hasColumn(col))
+        throw H_ERROR << "Twiss file has no \"" << column_names[(size_t)col] << "\" column for its elements.";
+      const char *begin = rec.fields[(size_t)col].begin, *end = rec.fields[(size_t)col].end;
+      unquote(begin, end);
+      return std::string(begin, end);
+    }
+
+    element::Type Twiss::elementType(const Record& rec) const {
+      return hasColumn(Column::keyword) ? findElementTypeByKeyword(lowercase(string(rec, Column::keyword)))
+                                        : findElementTypeByName(string(rec, Column::name));
+    }
+
+    const char* Twiss::findInteractionPoint(const char* pos, const char* end, size_t& line_num) {
+      const size_t name_field = columns_[(size_t)Column::name];
+      const char *line, *line_end, *field, *field_end;
+      for (const char* next = pos; nextLine(next, end, line, line_end); ++line_num) {
+        // only the name field is extracted, and the element is built once it matches
+        const char* it = line;
+        bool has_name = false;
+        for (size_t i = 0; !has_name && nextField(it, line_end, field, field_end); ++i)
+          has_name = (i == name_field);
+        if (!has_name)
+          continue;
+        unquote(field, field_end);
+        if ((size_t)(field_end - field) != ip_name_.size() || !std::equal(field, field_end, ip_name_.begin()))
+          continue;
         try {
-          auto elem = parseElement(values);
-          if (!elem || elem->name() != ip_name_)
+          Record rec;
+          rec.line = line_num - 1;
+          it = line;
+          parseRecord(it, end, rec);
+          auto elem = parseElement(rec, elementType(rec));
+          if (!elem)
             continue;
           interaction_point_ = elem;
           raw_beamline_->setInteractionPoint(elem);
-          break;
+          return line;
         } catch (Exception& e) {
           e.dump(std::cerr);
           throw H_ERROR << "Failed to retrieve the interaction point with name=\"" << ip_name_ << "\".";
         }
       }
+      throw H_ERROR << "Interaction point \"" << ip_name_ << "\" has not been found in the beamline!";
     }
 
-    void Twiss::parseElements() {
-      if (!in_file_.is_open())
-        throw H_ERROR << "Twiss file is not opened nor ready for parsing!";
+    void Twiss::parseElements(const char* begin, const char* ip_pos, const char* end, size_t ip_line) {
       // parse the optics elements and their characteristics
-      std::string line;
-
-      if (!interaction_point_)
-        throw H_ERROR << "Interaction point \"" << ip_name_ << "\" has not been found in the beamline!";
-
-      in_file_.seekg(in_file_lastline_);  // return to the first element line
+      const double ip_s = interaction_point_->s();
+
+      // elements are ordered in s: walk back from the interaction point to the first line in the parsing range
+      Record rec;
+      const char* first = ip_pos;
+      size_t first_line = ip_line;
+      while (first > begin) {
+        const char* prev = first - 1;  // end of the previous line
+        while (prev > begin && *(prev - 1) != '\n')
+          --prev;
+        const char* it = prev;
+        rec.line = first_line - 2;
+        if (parseRecord(it, first, rec) && number(rec, Column::s) - ip_s < min_s_)
+          break;
+        first = prev;
+        --first_line;
+      }
 
+      // then parse forward, until the beamline window is complete
+      BeamlineBuilder builder(*raw_beamline_);
       bool has_next_element = false;
-      while (!in_file_.eof()) {  // retrieve the next line from the Twiss file
-        std::getline(in_file_, line);
-        std::stringstream str(trim(line));
-        if (str.str().empty())
+      rec.line = first_line - 1;
+      for (const char* pos = first; parseRecord(pos, end, rec);) {
+        if (number(rec, Column::s) - ip_s < min_s_)
           continue;
-
-        // extract the list of properties
-        std::string buffer;
-        ValuesCollection values;
-        while (str >> buffer)
-          values.emplace_back(buffer);
-        try {
-          auto elem = parseElement(values);
-          if (!elem || elem->type() == element::aDrift)
-            continue;
-          elem->offsetS(-interaction_point_->s());
-          if (elem->s() < min_s_)
-            continue;
-          if (elem->s() + elem->length() > raw_beamline_->maxLength()) {
-            if (has_next_element)
-              throw Exception(__PRETTY_FUNCTION__, ExceptionType::info, 20001) << "Finished to parse the beamline";
-            if (elem->type() != element::anInstrument && elem->type() != element::aDrift)
-              has_next_element = true;
-          }
-          raw_beamline_->add(elem);
-        } catch (Exception& e) {
-          if (e.errorNumber() != 20001)
-            e.dump(std::cerr);
-          break;  // finished to parse
+        const auto type = elementType(rec);
+        if (type == element::aDrift)
+          continue;
+        auto elem = parseElement(rec, type);
+        if (!elem || elem->type() == element::aDrift)
+          continue;
+        elem->offsetS(-ip_s);
+        if (elem->s() + elem->length() > raw_beamline_->maxLength()) {
+          if (has_next_element)
+            break;  // finished to parse
+          if (elem->type() != element::anInstrument && elem->type() != element::aDrift)
+            has_next_element = true;
         }
+        builder.add(elem);
       }
       interaction_point_->setS(0.);  // by convention
-      raw_beamline_->add(interaction_point_);
+      builder.add(interaction_point_);
+      builder.build();
     }
 
-    std::shared_ptr<element::ElementBase> Twiss::parseElement(const ValuesCollection& values) {
-      // first check if the "correct" number of element properties is parsed
-      if (values.size() != elements_fields_.size())
-        throw H_ERROR << "Twiss file seems corrupted!\n\t"
-                      << "Element " << trim(values.at(0)) << " has " << values.size() << " fields"
-                      << " when " << elements_fields_.size() << " are expected.";
-
-      // then perform the 3-fold matching key <-> value <-> value type
-      pmap::Ordered<float> elem_map_floats;
-      pmap::Ordered<std::string> elem_map_str;
-      for (size_t i = 0; i < values.size(); i++) {
-        const std::string key = elements_fields_.key(i), value = values.at(i);
-        const ValueType type = elements_fields_.value(i);
-        switch (type) {
-          case String:
-            elem_map_str.add(key, value);
-            break;
-          case Float:
-            elem_map_floats.add(key, std::stod(value));
-            break;
-          case Unknown:
-          default: {
-            throw H_ERROR << "Twiss file predicts an unknown-type optics element parameter:\n\t"
-                          << " (" << elements_fields_.key(i) << ") for " << trim(values.at(0)) << ".";
-          } break;
-        }
-      }
-
-      const std::string name = trim(elem_map_str.get("name"));
-      const float s = elem_map_floats.get("s"), length = elem_map_floats.get("l");
-
-      // convert the element type from string to object
-      const element::Type elemtype = (elem_map_str.hasKey("keyword"))
-                                         ? findElementTypeByKeyword(lowercase(trim(elem_map_str.get("keyword"))))
-                                         : findElementTypeByName(name);
+    std::shared_ptr<element::ElementBase> Twiss::parseElement(const Record& rec, element::Type elemtype) const {
+      const std::string name = string(rec, Column::name);
+      const float s = number(rec, Column::s), length = number(rec, Column::l);
 
       std::shared_ptr<element::ElementBase> elem;
 
@@ -346,7 +414,7 @@ namespace hector {
             if (length <= 0.)
               throw H_ERROR << "Trying to add a quadrupole with invalid length (l=" << length << " m).";
 
-            const double k1l = elem_map_floats.get("k1l");
+            const double k1l = number(rec, Column::k1l);
             const double mag_str_k = -k1l / length;
             if (k1l > 0)
               elem.reset(new element::HorizontalQuadrupole(name, s, length, mag_str_k));
@@ -355,27 +423,26 @@ namespace hector {
           } break;
           case element::aRectangularDipole:
           case element::aSectorDipole: {
-            const double k0l = elem_map_floats.get("k0l");
+            const double k0l = number(rec, Column::k0l);
             if (length <= 0.)
               throw H_ERROR << "Trying to add a dipole with invalid length (l=" << length << " m).";
             if (k0l == 0.)
               throw H_ERROR << "Trying to add a dipole (" << name << ") with k0l=" << k0l << ".";
 
             const double mag_strength = k0l / length;
-            //            std::cout << name << "|" << s << "|" << mag_strength << std::endl;
             if (elemtype == element::aRectangularDipole)
               elem.reset(new element::RectangularDipole(name, s, length, mag_strength));
             if (elemtype == element::aSectorDipole)
               elem.reset(new element::SectorDipole(name, s, length, mag_strength));
           } break;
           case element::anHorizontalKicker: {
-            const double hkick = elem_map_floats.get("hkick");
+            const double hkick = number(rec, Column::hkick);
             if (hkick == 0.)
               return 0;
             elem.reset(new element::HorizontalKicker(name, s, length, hkick));
           } break;
           case element::aVerticalKicker: {
-            const double vkick = elem_map_floats.get("vkick");
+            const double vkick = number(rec, Column::vkick);
             if (vkick == 0.)
               return 0;
             elem.reset(new element::VerticalKicker(name, s, length, vkick));
@@ -402,18 +469,19 @@ namespace hector {
         if (!elem)
           return elem;
 
-        const TwoVector env_pos(elem_map_floats.get("x"), elem_map_floats.get("y"));
+        const TwoVector env_pos(number(rec, Column::x), number(rec, Column::y));
 
         elem->setRelativePosition(env_pos);
-        elem->setDispersion(TwoVector(elem_map_floats.get("dx"), elem_map_floats.get("dy")));
-        elem->setBeta(TwoVector(elem_map_floats.get("betx"), elem_map_floats.get("bety")));
+        elem->setDispersion(TwoVector(number(rec, Column::dx), number(rec, Column::dy)));
+        elem->setBeta(TwoVector(number(rec, Column::betx), number(rec, Column::bety)));
 
         // associate the aperture type to the element
-        if (elem_map_str.hasKey("apertype")) {
-          const std::string aper_type = lowercase(trim(elem_map_str.get("apertype")));
-          const aperture::Type apertype = findApertureTypeByApertype(aper_type);
-          const double aper_1 = elem_map_floats.get("aper_1");
-          const double aper_2 = elem_map_floats.get("aper_2");
+        if (hasColumn(Column::apertype)) {
+          const aperture::Type apertype = findApertureTypeByApertype(lowercase(string(rec, Column::apertype)));
+          if (apertype == aperture::anInvalidAperture)
+            return elem;
+          const double aper_1 = number(rec, Column::aper_1);
+          const double aper_2 = number(rec, Column::aper_2);
           // MAD-X provides it in m
           switch (apertype) {
             case aperture::aCircularAperture:
@@ -426,12 +494,12 @@ namespace hector {
               elem->setAperture(std::make_shared<aperture::Elliptic>(aper_1, aper_2, env_pos));
               break;
             case aperture::aRectEllipticAperture: {
-              const double aper_3 = elem_map_floats.get("aper_3");
-              const double aper_4 = elem_map_floats.get("aper_4");
+              const double aper_3 = number(rec, Column::aper_3);
+              const double aper_4 = number(rec, Column::aper_4);
               elem->setAperture(std::make_shared<aperture::RectElliptic>(aper_1, aper_2, aper_3, aper_4, env_pos));
             } break;
             case aperture::aRectCircularAperture: {
-              const double aper_3 = elem_map_floats.get("aper_3");
+              const double aper_3 = number(rec, Column::aper_3);
               elem->setAperture(std::make_shared<aperture::RectElliptic>(aper_1, aper_2, aper_3, aper_3, env_pos));
             } break;
             default:
@@ -0,0 +1,40 @@
+#include "Hector/ObservationPlanes.h"
+#include "Hector/Beamline.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/String.h"
+
+#include <algorithm>
+
+namespace hector {
+  size_t ObservationPlanes::add(const std::string& name, double s) {
+    // planes sharing the same s-coordinate are kept in their insertion order
+    const size_t i = std::upper_bound(positions_.begin(), positions_.end(), s) - positions_.begin();
+    planes_.insert(planes_.begin() + i, Plane{name, s});
+    positions_.insert(positions_.begin() + i, s);
+    return i;
+  }
+
+  size_t ObservationPlanes::add(double s) { return add(format("s=%g", s), s); }
+
+  size_t ObservationPlanes::addElements(const Beamline& bl, const std::string& regex) {
+    const auto elems = bl.find(regex);
+    if (elems.empty())
+      H_WARNING << "No beamline element matching \"" << regex << "\" to be used as an observation plane.";
+    for (const auto& elem : elems)
+      add(elem->name(), elem->s());
+    return elems.size();
+  }
+
+  void ObservationPlanes::clear() {
+    planes_.clear();
+    positions_.clear();
+  }
+
+  size_t ObservationPlanes::index(const std::string& name) const {
+    for (size_t i = 0; i < planes_.size(); ++i)
+      if (planes_[i].name == name)
+        return i;
+    throw H_ERROR << "Observation plane \"" << name << "\" is not registered.";
+  }
+}  // namespace hector
@@ -12,7 +12,7 @@ namespace hector {
         enable_kickers_(false),
         enable_dipoles_(true) {}
 
-  std::shared_ptr<Parameters> Parameters::get() {
+  const std::shared_ptr<Parameters>& Parameters::get() {
     static std::shared_ptr<Parameters> params(new Parameters);
     return params;
   }
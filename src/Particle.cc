@@ -19,14 +19,17 @@ namespace hector {
     addPosition(0., StateVector(mom));
   }
 
-  Particle::~Particle() {}
-
   Particle Particle::fromMassCharge(double mass, int charge) {
-    Particle p(StateVector(Vector(6, 0), mass));
+    Particle p(StateVector(Vector6(), mass));
     p.setCharge(charge);
     return p;
   }
 
+  void Particle::reset(const StateVector& sv0, double s0) {
+    positions_.clear();
+    addPosition(s0, sv0);
+  }
+
   void Particle::addPosition(const Position& pos, bool stopped) {
     if (!positions_.empty() > 0 && lastStateVector().m() != pos.stateVector().m())
       throw H_ERROR << "Particle mass is not conserved in propagation!\n\t"
@@ -37,28 +40,21 @@ namespace hector {
   }
 
   StateVector Particle::stateVectorAt(double s) const {
-    const auto& pos_s = positions_.find(s);
-    if (pos_s != positions_.end())
-      return pos_s->second;
+    // last position at or before s
+    const size_t i = positions_.locate(s);
+    if (i < positions_.size() && positions_[i].first == s)
+      return positions_[i].second;
 
-    const auto &lower_it = --positions_.upper_bound(s), upper_it = positions_.upper_bound(s);
-
-    if (lower_it == positions_.end() || upper_it->first < lower_it->first)
+    if (i + 1 >= positions_.size())
       throw H_ERROR << "Impossible to interpolate the position at s = " << s << " m.";
 
-    //PrintInfo( Form( "Interpolating for s = %.2f between %.2f and %.2f", s, lower_it->first, upper_it->first ) );
-
-    const StateVector &sv_before = lower_it->second, &sv_after = upper_it->second;
-    const TwoVector &in = sv_before.position(), &out = sv_after.position();
-
-    const double drift_length = upper_it->first - lower_it->first;
-    if (drift_length == 0)
-      throw H_ERROR << "No luck in choosing position (s=" << s << " m)\n\t"
-                    << "Interpolation is impossible!";
+    const auto &lower = positions_[i], &upper = positions_[i + 1];
+    const TwoVector &in = lower.second.position(), &out = upper.second.position();
 
-    const TwoVector s_pos = in + ((s - lower_it->first) / drift_length) * (out - in);
+    const double drift_length = upper.first - lower.first;
+    const TwoVector s_pos = in + ((s - lower.first) / drift_length) * (out - in);
 
-    StateVector out_stvec(lower_it->second);
+    StateVector out_stvec(lower.second);
     out_stvec.setPosition(s_pos);
     return out_stvec;
   }
@@ -0,0 +1,143 @@
+#include "Hector/ParticleBatch.h"
+#include "Hector/Parameters.h"
+#include "Hector/Exception.h"
+
+namespace hector {
+  ParticleBatch::ParticleBatch(size_t num_particles) { resize(num_particles); }
+
+  ParticleBatch::ParticleBatch(const Particles& parts) {
+    reserve(parts.size());
+    for (const auto& part : parts)
+      add(part);
+  }
+
+  void ParticleBatch::resize(size_t num_particles) {
+    x_.resize(num_particles, 0.);
+    tx_.resize(num_particles, 0.);
+    y_.resize(num_particles, 0.);
+    ty_.resize(num_particles, 0.);
+    energy_.resize(num_particles, Parameters::get()->beamEnergy());
+    kick_.resize(num_particles, 1.);
+    mass_.resize(num_particles, Parameters::get()->beamParticlesMass());
+    charge_.resize(num_particles, Parameters::get()->beamParticlesCharge());
+    s_.resize(num_particles, 0.);
+    status_.resize(num_particles, Status::alive);
+  }
+
+  void ParticleBatch::reserve(size_t num_particles) {
+    x_.reserve(num_particles);
+    tx_.reserve(num_particles);
+    y_.reserve(num_particles);
+    ty_.reserve(num_particles);
+    energy_.reserve(num_particles);
+    kick_.reserve(num_particles);
+    mass_.reserve(num_particles);
+    charge_.reserve(num_particles);
+    s_.reserve(num_particles);
+    status_.reserve(num_particles);
+  }
+
+  void ParticleBatch::clear() { resize(0); }
+
+  void ParticleBatch::add(const StateVector& sv, int charge, double s) {
+    x_.emplace_back(sv.x());
+    tx_.emplace_back(sv.Tx());
+    y_.emplace_back(sv.y());
+    ty_.emplace_back(sv.Ty());
+    energy_.emplace_back(sv.energy());
+    kick_.emplace_back(sv.kick());
+    mass_.emplace_back(sv.m());
+    charge_.emplace_back(charge);
+    s_.emplace_back(s);
+    status_.emplace_back(Status::alive);
+  }
+
+  void ParticleBatch::add(const Particle& part) { add(part.firstStateVector(), part.charge(), part.firstS()); }
+
+  StateVector ParticleBatch::stateVector(size_t i) const {
+    if (i >= size())
+      throw H_ERROR << "Invalid particle index: " << i << " (batch size: " << size() << ").";
+    return StateVector(Vector6(x_[i], tx_[i], y_[i], ty_[i], energy_[i], kick_[i]), mass_[i]);
+  }
+
+  void ParticleBatch::setStateVector(size_t i, const StateVector& sv) {
+    if (i >= size())
+      throw H_ERROR << "Invalid particle index: " << i << " (batch size: " << size() << ").";
+    x_[i] = sv.x();
+    tx_[i] = sv.Tx();
+    y_[i] = sv.y();
+    ty_[i] = sv.Ty();
+    energy_[i] = sv.energy();
+    kick_[i] = sv.kick();
+    mass_[i] = sv.m();
+  }
+
+  Particle ParticleBatch::particle(size_t i) const {
+    Particle part(stateVector(i), s_[i]);
+    part.setCharge(charge_[i]);
+    return part;
+  }
+
+  ParticleBatch ParticleBatch::select(const std::vector<size_t>& indices) const {
+    ParticleBatch sub;
+    sub.reserve(indices.size());
+    for (const auto& i : indices) {
+      if (i >= size())
+        throw H_ERROR << "Invalid particle index: " << i << " (batch size: " << size() << ").";
+      sub.x_.emplace_back(x_[i]);
+      sub.tx_.emplace_back(tx_[i]);
+      sub.y_.emplace_back(y_[i]);
+      sub.ty_.emplace_back(ty_[i]);
+      sub.energy_.emplace_back(energy_[i]);
+      sub.kick_.emplace_back(kick_[i]);
+      sub.mass_.emplace_back(mass_[i]);
+      sub.charge_.emplace_back(charge_[i]);
+      sub.s_.emplace_back(s_[i]);
+      sub.status_.emplace_back(status_[i]);
+    }
+    return sub;
+  }
+
+  void ParticleBatch::assign(const std::vector<size_t>& indices, const ParticleBatch& sub) {
+    if (indices.size() != sub.size())
+      throw H_ERROR << "Sub-batch size (" << sub.size() << ") does not match the number of indices (" << indices.size()
+                    << ").";
+    for (size_t j = 0; j < indices.size(); ++j) {
+      const size_t i = indices[j];
+      if (i >= size())
+        throw H_ERROR << "Invalid particle index: " << i << " (batch size: " << size() << ").";
+      x_[i] = sub.x_[j];
+      tx_[i] = sub.tx_[j];
+      y_[i] = sub.y_[j];
+      ty_[i] = sub.ty_[j];
+      energy_[i] = sub.energy_[j];
+      kick_[i] = sub.kick_[j];
+      mass_[i] = sub.mass_[j];
+      charge_[i] = sub.charge_[j];
+      s_[i] = sub.s_[j];
+      status_[i] = sub.status_[j];
+    }
+  }
+
+  double* ParticleBatch::component(StateVector::Components comp) {
+    return const_cast<double*>(static_cast<const ParticleBatch&>(*this).component(comp));
+  }
+
+  const double* ParticleBatch::component(StateVector::Components comp) const {
+    switch (comp) {
+      case StateVector::X:
+        return x_.data();
+      case StateVector::TX:
+        return tx_.data();
+      case StateVector::Y:
+        return y_.data();
+      case StateVector::TY:
+        return ty_.data();
+      case StateVector::E:
+        return energy_.data();
+      case StateVector::K:
+        return kick_.data();
+    }
+    throw H_ERROR << "Invalid state vector component: " << (int)comp << ".";
+  }
+}  // namespace hector
@@ -0,0 +1,30 @@
+#include "Hector/Pipeline.h"
+#include "Hector/PropagationPlan.h"
+
+namespace hector {
+  Pipeline::Pipeline(const Beamline* bl, double s_max, const PropagationContext& ctx)
+      : beamline_(bl), s_max_(s_max), context_(ctx), recording_(Propagator::Recording::full) {}
+
+  uint64_t Pipeline::run(const Source& source, const Sink& sink) const {
+    const PropagationPlan plan(beamline_, s_max_);
+    uint64_t num_events = 0;
+    return runtime_.run(
+        [&source, &num_events](Event& evt) {
+          evt.number = num_events;
+          if (!source(evt.particles))
+            return false;
+          ++num_events;
+          return true;
+        },
+        [this, &plan]() -> StreamingPipeline<Event>::Process {
+          Propagator prop(beamline_, context_);
+          prop.setRecording(recording_);
+          return [prop, &plan](Event& evt) {
+            evt.results.reserve(evt.particles.size());
+            for (auto& part : evt.particles)
+              evt.results.emplace_back(prop.track(part, plan));
+          };
+        },
+        sink);
+  }
+}  // namespace hector
@@ -0,0 +1,305 @@
+#include "Hector/PolynomialOptics.h"
+
+#include "Hector/Exception.h"
+#include "Hector/Particle.h"
+#include "Hector/Propagator.h"
+
+#include "Hector/Utils/Kinematics.h"
+#include "Hector/Utils/String.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace hector {
+  constexpr const char* PolynomialOptics::magic;
+  constexpr unsigned short PolynomialOptics::version;
+
+  PolynomialOptics::PolynomialOptics(unsigned short degree)
+      : degree_(degree), ranges_{0., 0., 0., 0., 0., 0.}, xi_mid_(0.), xi_inv_half_(1.) {}
+
+  PolynomialOptics::PolynomialOptics(const std::string& filename) : PolynomialOptics() {
+    std::ifstream file(filename);
+    if (!file.is_open())
+      throw H_ERROR << "Impossible to open file \"" << filename << "\" for reading!";
+
+    std::string key;
+    unsigned short file_version = 0;
+    size_t num_planes = 0;
+    if (!(file >> key >> file_version) || key != magic)
+      throw H_ERROR << "File \"" << filename << "\" does not hold a polynomial optics parametrisation!";
+    if (file_version > version)
+      throw H_ERROR << "Version " << file_version << " is not (yet) supported! Currently peaking at " << version << "!";
+    file >> degree_ >> ranges_.x >> ranges_.tx >> ranges_.y >> ranges_.ty >> ranges_.xi_min >> ranges_.xi_max >>
+        num_planes;
+    if (!file || ranges_.xi_max <= ranges_.xi_min)
+      throw H_ERROR << "Corrupted header in file \"" << filename << "\"!";
+    xi_mid_ = 0.5 * (ranges_.xi_min + ranges_.xi_max);
+    xi_inv_half_ = 2. / (ranges_.xi_max - ranges_.xi_min);
+
+    for (size_t i = 0; i < num_planes; ++i) {
+      Plane plane;
+      file >> plane.name >> plane.s;
+      for (auto& rms : plane.rms)
+        file >> rms;
+      plane.coeffs.resize(numCoefficients());
+      for (auto& coeff : plane.coeffs)
+        file >> coeff;
+      if (!file)
+        throw H_ERROR << "Corrupted parametrisation for plane " << i << " in file \"" << filename << "\"!";
+      planes_.emplace_back(plane);
+    }
+    H_DEBUG << "Polynomial optics parametrisation of degree " << degree_ << " retrieved for " << planes_.size()
+            << " plane(s) from \"" << filename << "\".";
+  }
+
+  void PolynomialOptics::addPlane(const std::string& name, double s) {
+    if (name.empty() || name.find_first_of(" \t\n") != std::string::npos)
+      throw H_ERROR << "Invalid observation plane name: \"" << name << "\".";
+    planes_.emplace_back(Plane{name, s, {{0., 0., 0., 0.}}, std::vector<double>()});
+  }
+
+  size_t PolynomialOptics::planeIndex(const std::string& name) const {
+    for (size_t i = 0; i < planes_.size(); ++i)
+      if (planes_[i].name == name)
+        return i;
+    throw H_ERROR << "Observation plane \"" << name << "\" is not parametrised!";
+  }
+
+  void PolynomialOptics::fit(const Propagator& prop,
+                             const Ranges& ranges,
+                             size_t num_samples,
+                             unsigned long seed,
+                             unsigned short num_threads) {
+    if (planes_.empty())
+      throw H_ERROR << "No observation plane to parametrise!";
+    if (ranges.x <= 0. || ranges.tx <= 0. || ranges.y <= 0. || ranges.ty <= 0. || ranges.xi_max <= ranges.xi_min)
+      throw H_ERROR << "Invalid phase space to be sampled.";
+    const size_t num_terms = num_functions * (degree_ + 1);
+    if (num_samples < 2 * num_terms)
+      throw H_ERROR << "Insufficient number of samples for the fit: " << num_samples << ".";
+
+    ranges_ = ranges;
+    xi_mid_ = 0.5 * (ranges.xi_min + ranges.xi_max);
+    xi_inv_half_ = 2. / (ranges.xi_max - ranges.xi_min);
+
+    //--- sample the phase space (in normalised coordinates) and propagate
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> flat(-1., 1.);
+    std::vector<std::array<double, 5> > inputs(num_samples);  // t, x, tx, y, ty
+    Particles parts;
+    parts.reserve(num_samples);
+    double s_max = 0.;
+    for (const auto& plane : planes_)
+      s_max = std::max(s_max, plane.s);
+    // particles built for the run parameters snapshot of the propagator
+    const auto& ctx = prop.context();
+    for (auto& in : inputs) {
+      for (auto& coord : in)
+        coord = flat(gen);
+      auto part = Particle::fromMassCharge(ctx.beam_mass, ctx.beam_charge);
+      part.firstStateVector().setEnergy(xi_to_e(xi_mid_ + in[0] / xi_inv_half_, ctx.beam_energy));
+      part.firstStateVector().setPosition(in[1] * ranges.x, in[3] * ranges.y);
+      part.firstStateVector().setAngles(in[2] * ranges.tx, in[4] * ranges.ty);
+      parts.emplace_back(part);
+    }
+    const auto results = prop.propagate(parts, s_max, num_threads);
+
+    //--- fit each plane, with one set of normal equations per transverse plane
+    std::vector<double> basis(num_terms);
+    for (auto& plane : planes_) {
+      plane.coeffs.assign(numCoefficients(), 0.);
+      std::vector<Output> outputs(num_samples);
+      std::vector<bool> used(num_samples, false);
+      size_t num_used = 0;
+      for (size_t i = 0; i < num_samples; ++i) {
+        if (!results[i].success() || parts[i].lastS() < plane.s)
+          continue;
+        const auto sv = parts[i].stateVectorAt(plane.s);
+        outputs[i] = Output{sv.x(), sv.Tx(), sv.y(), sv.Ty()};
+        used[i] = true;
+        ++num_used;
+      }
+      if (num_used < 2 * num_terms)
+        throw H_ERROR << "Only " << num_used << " particle(s) reached the observation plane \"" << plane.name
+                      << "\" at s = " << plane.s << " m.";
+
+      for (size_t proj = 0; proj < 2; ++proj) {
+        // normal equations (A^T.A).c = A^T.b for the two outputs of this transverse plane
+        std::vector<double> ata(num_terms * num_terms, 0.), atb(2 * num_terms, 0.);
+        for (size_t i = 0; i < num_samples; ++i) {
+          if (!used[i])
+            continue;
+          const auto& in = inputs[i];
+          const double pos = in[1 + 2 * proj], ang = in[2 + 2 * proj];
+          double pow_t = 1.;
+          for (size_t n = 0; n <= degree_; ++n, pow_t *= in[0]) {
+            basis[n] = pow_t;
+            basis[(degree_ + 1) + n] = pow_t * pos;
+            basis[2 * (degree_ + 1) + n] = pow_t * ang;
+          }
+          const double val[2] = {(proj == 0) ? outputs[i].x : outputs[i].y,
+                                 (proj == 0) ? outputs[i].tx : outputs[i].ty};
+          for (size_t a = 0; a < num_terms; ++a) {
+            for (size_t b = 0; b < num_terms; ++b)
+              ata[a * num_terms + b] += basis[a] * basis[b];
+            atb[a] += basis[a] * val[0];
+            atb[num_terms + a] += basis[a] * val[1];
+          }
+        }
+        // Gaussian elimination with partial pivoting, on both right-hand sides at once
+        for (size_t col = 0; col < num_terms; ++col) {
+          size_t piv = col;
+          for (size_t row = col + 1; row < num_terms; ++row)
+            if (std::fabs(ata[row * num_terms + col]) > std::fabs(ata[piv * num_terms + col]))
+              piv = row;
+          if (ata[piv * num_terms + col] == 0.)
+            throw H_ERROR << "Singular system while fitting the observation plane \"" << plane.name << "\".";
+          if (piv != col) {
+            for (size_t b = 0; b < num_terms; ++b)
+              std::swap(ata[col * num_terms + b], ata[piv * num_terms + b]);
+            std::swap(atb[col], atb[piv]);
+            std::swap(atb[num_terms + col], atb[num_terms + piv]);
+          }
+          for (size_t row = col + 1; row < num_terms; ++row) {
+            const double factor = ata[row * num_terms + col] / ata[col * num_terms + col];
+            for (size_t b = col; b < num_terms; ++b)
+              ata[row * num_terms + b] -= factor * ata[col * num_terms + b];
+            atb[row] -= factor * atb[col];
+            atb[num_terms + row] -= factor * atb[num_terms + col];
+          }
+        }
+        for (size_t out = 0; out < 2; ++out) {
+          double* sol = atb.data() + out * num_terms;
+          for (size_t row = num_terms; row-- > 0;) {
+            for (size_t b = row + 1; b < num_terms; ++b)
+              sol[row] -= ata[row * num_terms + b] * sol[b];
+            sol[row] /= ata[row * num_terms + row];
+          }
+          // fold the transverse coordinates normalisation into the coefficients
+          const double scales[num_functions] = {
+              1., 1. / ((proj == 0) ? ranges.x : ranges.y), 1. / ((proj == 0) ? ranges.tx : ranges.ty)};
+          double* coeffs = plane.coeffs.data() + (2 * proj + out) * num_terms;
+          for (size_t func = 0; func < num_functions; ++func)
+            for (size_t n = 0; n <= degree_; ++n)
+              coeffs[func * (degree_ + 1) + n] = sol[func * (degree_ + 1) + n] * scales[func];
+        }
+      }
+
+      //--- residuals with respect to the full propagation
+      std::array<double, 4> sum2{{0., 0., 0., 0.}};
+      for (size_t i = 0; i < num_samples; ++i) {
+        if (!used[i])
+          continue;
+        const auto& in = inputs[i];
+        const auto fit = evaluate(&plane - planes_.data(),
+                                  Input{in[1] * ranges.x,
+                                        in[2] * ranges.tx,
+                                        in[3] * ranges.y,
+                                        in[4] * ranges.ty,
+                                        xi_mid_ + in[0] / xi_inv_half_});
+        sum2[0] += std::pow(fit.x - outputs[i].x, 2);
+        sum2[1] += std::pow(fit.tx - outputs[i].tx, 2);
+        sum2[2] += std::pow(fit.y - outputs[i].y, 2);
+        sum2[3] += std::pow(fit.ty - outputs[i].ty, 2);
+      }
+      for (size_t j = 0; j < 4; ++j)
+        plane.rms[j] = std::sqrt(sum2[j] / num_used);
+      H_DEBUG << "Observation plane \"" << plane.name << "\" at s = " << plane.s << " m parametrised with "
+              << num_used << " particle(s).\n\t"
+              << format("Residuals RMS: x: %.3e m, x': %.3e rad, y: %.3e m, y': %.3e rad.",
+                        plane.rms[0],
+                        plane.rms[1],
+                        plane.rms[2],
+                        plane.rms[3]);
+    }
+  }
+
+  void PolynomialOptics::write(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open())
+      throw H_ERROR << "Impossible to open file \"" << filename << "\" for writing!";
+    file << magic << " " << version << "\n"
+         << degree_ << "\n"
+         << format("%.17g %.17g %.17g %.17g %.17g %.17g\n",
+                   ranges_.x,
+                   ranges_.tx,
+                   ranges_.y,
+                   ranges_.ty,
+                   ranges_.xi_min,
+                   ranges_.xi_max)
+         << planes_.size() << "\n";
+    for (const auto& plane : planes_) {
+      file << plane.name << format(" %.17g", plane.s);
+      for (const auto& rms : plane.rms)
+        file << format(" %.17g", rms);
+      for (size_t i = 0; i < plane.coeffs.size(); ++i)
+        file << ((i % (degree_ + 1) == 0) ? "\n" : "") << format(" %.17g", plane.coeffs[i]);
+      file << "\n";
+    }
+    if (!file)
+      throw H_ERROR << "Failed to write the parametrisation to \"" << filename << "\"!";
+  }
+
+  PolynomialOptics::Output PolynomialOptics::evaluate(size_t plane, const Input& in) const {
+    const double t = (in.xi - xi_mid_) * xi_inv_half_;
+    const double* c = planes_[plane].coeffs.data();
+    const size_t num = degree_ + 1;
+    double out[4];
+    for (size_t j = 0; j < 4; ++j, c += num_functions * num) {
+      // Horner scheme for the three optical functions of this output
+      double off = c[degree_], mag = c[num + degree_], len = c[2 * num + degree_];
+      for (size_t n = degree_; n-- > 0;) {
+        off = off * t + c[n];
+        mag = mag * t + c[num + n];
+        len = len * t + c[2 * num + n];
+      }
+      out[j] = (j < 2) ? off + mag * in.x + len * in.tx : off + mag * in.y + len * in.ty;
+    }
+    return Output{out[0], out[1], out[2], out[3]};
+  }
+
+  double PolynomialOptics::function(const Plane& plane, size_t output, size_t func, double t, double* deriv) const {
+    const double* c = plane.coeffs.data() + (output * num_functions + func) * (degree_ + 1);
+    double val = c[degree_], der = 0.;
+    for (size_t n = degree_; n-- > 0;) {
+      der = der * t + val;
+      val = val * t + c[n];
+    }
+    if (deriv)
+      *deriv = der;
+    return val;
+  }
+
+  PolynomialOptics::OpticalFunctions PolynomialOptics::opticalFunctions(size_t plane, double xi) const {
+    const auto& pl = planes_.at(plane);
+    const double t = (xi - xi_mid_) * xi_inv_half_, t0 = -xi_mid_ * xi_inv_half_;
+    OpticalFunctions out;
+    double* fields[2][4] = {{&out.x0, &out.v_x, &out.L_x, &out.D_x}, {&out.y0, &out.v_y, &out.L_y, &out.D_y}};
+    for (size_t proj = 0; proj < 2; ++proj) {
+      const size_t output = 2 * proj;
+      *fields[proj][0] = function(pl, output, 0, t);
+      *fields[proj][1] = function(pl, output, 1, t);
+      *fields[proj][2] = function(pl, output, 2, t);
+      // dispersion from the on-axis trajectory, with its derivative in the limit of a null momentum loss
+      double deriv = 0.;
+      const double pos0 = function(pl, output, 0, t0, &deriv);
+      *fields[proj][3] = (std::fabs(xi) > 1.e-9) ? (*fields[proj][0] - pos0) / xi : deriv * xi_inv_half_;
+    }
+    return out;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const PolynomialOptics::OpticalFunctions& func) {
+    return os << format("x0 = %.4e m, v_x = %.4e, L_x = %.4e m, D_x = %.4e m, "
+                        "y0 = %.4e m, v_y = %.4e, L_y = %.4e m, D_y = %.4e m",
+                        func.x0,
+                        func.v_x,
+                        func.L_x,
+                        func.D_x,
+                        func.y0,
+                        func.v_y,
+                        func.L_y,
+                        func.D_y);
+  }
+}  // namespace hector
@@ -0,0 +1,33 @@
+#include "Hector/PropagationContext.h"
+#include "Hector/Parameters.h"
+
+#include <functional>
+
+namespace hector {
+  PropagationContext PropagationContext::fromParameters() {
+    const auto& params = Parameters::get();
+    PropagationContext ctx;
+    ctx.beam_energy = params->beamEnergy();
+    ctx.beam_mass = params->beamParticlesMass();
+    ctx.beam_charge = params->beamParticlesCharge();
+    ctx.relative_energy = params->useRelativeEnergy();
+    ctx.enable_dipoles = params->enableDipoles();
+    ctx.enable_kickers = params->enableKickers();
+    ctx.compute_apertures = params->computeApertureAcceptance();
+    return ctx;
+  }
+
+  bool PropagationContext::operator==(const PropagationContext& oth) const {
+    return beam_energy == oth.beam_energy && beam_mass == oth.beam_mass && beam_charge == oth.beam_charge &&
+           relative_energy == oth.relative_energy && enable_dipoles == oth.enable_dipoles &&
+           enable_kickers == oth.enable_kickers && compute_apertures == oth.compute_apertures;
+  }
+
+  size_t PropagationContext::hash() const {
+    size_t seed = std::hash<double>()(beam_energy);
+    seed ^= std::hash<double>()(beam_mass) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    const int flags = (relative_energy << 0) | (enable_dipoles << 1) | (enable_kickers << 2) | (compute_apertures << 3);
+    seed ^= std::hash<int>()(beam_charge * 16 + flags) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+}  // namespace hector
@@ -0,0 +1,212 @@
+#include "Hector/PropagationPlan.h"
+
+#include "Hector/Beamline.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Elements/Collimator.h"
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Kicker.h"
+#include "Hector/Elements/Quadrupole.h"
+
+#include <cmath>
+#include <functional>
+#include <typeinfo>
+
+namespace hector {
+  namespace {
+    /// Find the matrix computation algorithm matching the exact class of an element
+    PropagationPlan::Kernel kernelFor(const element::ElementBase& elem) {
+      const std::type_info& type = typeid(elem);
+      if (type == typeid(element::Drift) || type == typeid(element::Marker) || type == typeid(element::Collimator))
+        return PropagationPlan::Kernel::drift;
+      if (type == typeid(element::SectorDipole))
+        return PropagationPlan::Kernel::sectorDipole;
+      if (type == typeid(element::RectangularDipole))
+        return PropagationPlan::Kernel::rectangularDipole;
+      if (type == typeid(element::HorizontalQuadrupole))
+        return PropagationPlan::Kernel::horizontalQuadrupole;
+      if (type == typeid(element::VerticalQuadrupole))
+        return PropagationPlan::Kernel::verticalQuadrupole;
+      if (type == typeid(element::HorizontalKicker))
+        return PropagationPlan::Kernel::horizontalKicker;
+      if (type == typeid(element::VerticalKicker))
+        return PropagationPlan::Kernel::verticalKicker;
+      // user-defined elements keep their own implementation
+      return PropagationPlan::Kernel::generic;
+    }
+  }  // namespace
+
+  PropagationPlan::PropagationPlan(const Beamline* bl, double s_max)
+      : s_max_(s_max), beamline_size_(bl ? bl->elements().size() : 0), fusion_(false) {
+    if (!bl)
+      throw H_ERROR << "Cannot build a propagation plan from an invalid beamline!";
+
+    for (auto it = bl->begin(); it != bl->end(); ++it) {
+      const auto& elem = *it;
+      // the first element is always kept as it defines the entrance of the second one
+      if (it != bl->begin() && elem->s() > s_max)
+        break;
+
+      Record rec;
+      rec.kernel = kernelFor(*elem);
+      rec.type = elem->type();
+      rec.name = names_.size();
+      rec.s = elem->s();
+      rec.length = elem->length();
+      rec.k = elem->magneticStrength();
+      apertures_.add(elem->aperture());
+      rec.aperture = apertures_[records_.size()].type;
+      rec.checkpoint = (rec.aperture != aperture::anInvalidAperture);
+      records_.emplace_back(rec);
+      names_.emplace_back(elem->name());
+      elements_.emplace_back(elem);
+    }
+  }
+
+  Matrix6 PropagationPlan::matrix(
+      size_t i, double length, double eloss, double mp, int qp, const PropagationContext& ctx) const {
+    const Record& rec = records_[i];
+    switch (rec.kernel) {
+      case Kernel::drift:
+        return element::Drift::genericMatrix(length);
+      case Kernel::sectorDipole:
+      case Kernel::rectangularDipole: {
+        if (!ctx.enable_dipoles)
+          return element::Drift::genericMatrix(length);
+        const double ke = element::ElementBase::fieldStrength(
+            rec.k, eloss, mp, qp, ctx.beam_energy, ctx.beam_mass, ctx.beam_charge);
+        if (rec.kernel == Kernel::sectorDipole)
+          return element::SectorDipole::genericMatrix(
+              length, ke, ctx.relative_energy, ctx.beam_energy, names_[rec.name]);
+        return element::RectangularDipole::genericMatrix(
+            length, ke, ctx.relative_energy, ctx.beam_energy, names_[rec.name]);
+      }
+      case Kernel::horizontalQuadrupole:
+      case Kernel::verticalQuadrupole: {
+        const double ke = element::ElementBase::fieldStrength(
+            rec.k, eloss, mp, qp, ctx.beam_energy, ctx.beam_mass, ctx.beam_charge);
+        if (rec.kernel == Kernel::horizontalQuadrupole)
+          return element::HorizontalQuadrupole::genericMatrix(length, ke, names_[rec.name]);
+        return element::VerticalQuadrupole::genericMatrix(length, ke, names_[rec.name]);
+      }
+      case Kernel::horizontalKicker:
+      case Kernel::verticalKicker: {
+        if (!ctx.enable_kickers)
+          return element::Drift::genericMatrix(length);
+        const double ke = -element::ElementBase::fieldStrength(
+            rec.k, eloss, mp, qp, ctx.beam_energy, ctx.beam_mass, ctx.beam_charge);
+        if (rec.kernel == Kernel::horizontalKicker)
+          return element::HorizontalKicker::genericMatrix(length, ke);
+        return element::VerticalKicker::genericMatrix(length, ke);
+      }
+      case Kernel::generic:
+        break;
+    }
+    if (length == rec.length)
+      return elements_[i]->matrix(eloss, mp, qp, ctx);
+    // build a temporary element of the requested length
+    auto elem_tmp = elements_[i]->clone();
+    elem_tmp->setLength(length);
+    return elem_tmp->matrix(eloss, mp, qp, ctx);
+  }
+
+  void PropagationPlan::addObservationPoint(double s) {
+    observations_.emplace_back(s);
+    for (auto& rec : records_)
+      if (s >= rec.s && s <= rec.s + rec.length)
+        rec.checkpoint = true;
+    segments_cache_.clear();
+  }
+
+  std::shared_ptr<const PropagationPlan::Segments> PropagationPlan::segments(
+      double first_s, double eloss, double mp, int qp, const PropagationContext& ctx) const {
+    const SegmentsCache::Key key{first_s, eloss, mp, qp, ctx};
+    auto segs = segments_cache_.find(key);
+    if (segs)
+      return segs;
+    // the (costly) matrices products are performed outside the lock
+    segs = std::make_shared<const Segments>(fuse(first_s, eloss, mp, qp, ctx));
+    segments_cache_.insert(key, segs);
+    return segs;
+  }
+
+  PropagationPlan::Segments PropagationPlan::fuse(
+      double first_s, double eloss, double mp, int qp, const PropagationContext& ctx) const {
+    Segments out;
+    Segment seg;
+    bool open_run = false;
+    double last_s = first_s;
+    for (size_t i = 1; i < records_.size(); ++i) {
+      const auto &prev_rec = records_[i - 1], &rec = records_[i];
+      if (first_s > prev_rec.s && first_s < rec.s)
+        H_INFO << "Path starts inside element " << name(prev_rec) << ".";
+      if (first_s > rec.s)
+        continue;
+      // same selection of elements as for the element-by-element propagation
+      const double out_s = rec.s + rec.length;
+      if (out_s < 0. || out_s <= last_s)
+        continue;
+      const Matrix6 mat = matrix(i, rec.length, eloss, mp, qp, ctx);
+      if (!open_run) {
+        seg = Segment{i, i, out_s, mat};
+        open_run = true;
+      } else {
+        seg.last = i;
+        seg.s_out = out_s;
+        seg.matrix = mat * seg.matrix;
+      }
+      last_s = out_s;
+      // close the run whenever the kinematics is to be recorded at the exit of this element
+      if (rec.checkpoint || (i + 1 < records_.size() && records_[i + 1].checkpoint)) {
+        out.emplace_back(seg);
+        open_run = false;
+      }
+    }
+    if (open_run)
+      out.emplace_back(seg);
+    return out;
+  }
+
+  PropagationPlan::SegmentsCache& PropagationPlan::SegmentsCache::operator=(const SegmentsCache& rhs) {
+    if (this == &rhs)
+      return *this;
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = rhs.capacity_;
+    segments_.clear();
+    return *this;
+  }
+
+  std::shared_ptr<const PropagationPlan::Segments> PropagationPlan::SegmentsCache::find(const Key& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = segments_.find(key);
+    if (it == segments_.end())
+      return std::shared_ptr<const Segments>();
+    return it->second;
+  }
+
+  void PropagationPlan::SegmentsCache::insert(const Key& key, const std::shared_ptr<const Segments>& segs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0)
+      return;
+    if (segments_.size() >= capacity_)
+      segments_.clear();
+    segments_.emplace(key, segs);
+  }
+
+  void PropagationPlan::SegmentsCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    segments_.clear();
+  }
+
+  bool PropagationPlan::SegmentsCache::Key::operator==(const Key& oth) const {
+    return first_s == oth.first_s && eloss == oth.eloss && mp == oth.mp && qp == oth.qp && ctx == oth.ctx;
+  }
+
+  size_t PropagationPlan::SegmentsCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = key.ctx.hash();
+    for (const double val : {key.first_s, key.eloss, key.mp})
+      seed ^= std::hash<double>()(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<int>()(key.qp) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+}  // namespace hector
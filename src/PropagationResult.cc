@@ -0,0 +1,19 @@
+#include "Hector/PropagationResult.h"
+
+#include <iostream>
+
+namespace hector {
+  constexpr size_t PropagationResult::invalid_index;
+
+  std::ostream& operator<<(std::ostream& os, const PropagationResult::Status& status) {
+    switch (status) {
+      case PropagationResult::Status::success:
+        return os << "success";
+      case PropagationResult::Status::stopped:
+        return os << "stopped";
+      case PropagationResult::Status::failed:
+        return os << "failed";
+    }
+    return os;
+  }
+}  // namespace hector
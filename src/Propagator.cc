@@ -1,112 +1,523 @@
 #include "Hector/Propagator.h"
 
 #include "Hector/Beamline.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/TransferMapTable.h"
+#include "Hector/ParticleBatch.h"
 #include "Hector/Elements/ElementBase.h"
 
 #include "Hector/Exception.h"
 #include "Hector/ParticleStoppedException.h"
 
+#include "Hector/Utils/BatchKernels.h"
+#include "Hector/Utils/Executor.h"
+#include "Hector/Utils/Kinematics.h"
+
+#include <algorithm>
+#include <numeric>
 #include <sstream>
+#include <tuple>
 
 namespace hector {
+  template <typename F>
+  void Propagator::record(Particle& part, const Particle::Position& in, const Particle::Position& out, F at) const {
+    switch (recording_) {
+      case Recording::full:
+        part.addPosition(out.s(), out.stateVector());
+        break;
+      case Recording::observationPlanes:
+        for (auto it = std::upper_bound(planes_.positions().begin(), planes_.positions().end(), in.s());
+             it != planes_.positions().end() && *it <= out.s();
+             ++it)
+          part.addPosition(*it, (*it == out.s()) ? out.stateVector() : at(*it));
+        break;
+      case Recording::finalState:
+        break;
+    }
+  }
+
   void Propagator::propagate(Particle& part, double s_max) const {
+    const auto result = track(part, s_max);
+    if (!result.success())
+      raise(result);
+  }
+
+  PropagationResult Propagator::track(Particle& part, double s_max) const {
+    try {
+      return finalise(part, transport(part, s_max));
+    } catch (const Exception& e) {
+      return PropagationResult(PropagationResult::Status::failed, nullptr, e.message());
+    }
+  }
+
+  PropagationResult Propagator::transport(Particle& part, double s_max) const {
     part.clear();
 
-    const double energy_loss = (Parameters::get()->useRelativeEnergy())
-                                   ? Parameters::get()->beamEnergy() - part.lastStateVector().energy()
-                                   : part.lastStateVector().energy();
+    const double energy_loss = (context_.relative_energy) ? context_.beam_energy - part.lastStateVector().energy()
+                                                          : part.lastStateVector().energy();
 
     const double first_s = part.firstS();
 
+    // current position of the particle (not necessarily recorded in its trajectory)
+    Particle::Position pos(*part.begin());
     if (beamline_->elements().size() < 2) {
       H_WARNING << "Insufficiant number of beamline elements for propagation: " << beamline_->elements().size();
-      return;
+      return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
+    }
+    const bool check_apertures = context_.compute_apertures;
+    if (recording_ == Recording::full)
+      part.reserve(beamline_->elements().size());
+    for (auto it = beamline_->begin() + 1; it != beamline_->end(); ++it) {
+      // extract the previous and the current element in the beamline
+      const auto prev_elem = *(it - 1), elem = *it;
+      if (elem->s() > s_max)
+        break;
+
+      const Particle::Position in_pos(pos);
+
+      // initialise the outwards position
+      Particle::Position out_pos(-1., StateVector());
+
+      // between two elements
+      if (first_s > prev_elem->s() && first_s < elem->s()) {
+        switch (prev_elem->type()) {
+          case element::aDrift:
+            H_INFO << "Path starts inside drift " << prev_elem->name() << ".";
+            break;
+          default:
+            H_INFO << "Path starts inside element " << prev_elem->name() << ".";
+            break;
+        }
+
+        // build a temporary element mimicking the drift effect
+        auto elem_tmp = prev_elem->clone();
+        elem_tmp->setS(first_s);
+        elem_tmp->setLength(elem->s() - first_s);
+        out_pos = propagateThrough(in_pos, elem_tmp, energy_loss, part.charge());
+      }
+      // before one element
+      if (first_s <= elem->s())
+        out_pos = propagateThrough(in_pos, elem, energy_loss, part.charge());
+
+      if (out_pos.s() < 0.)
+        continue;  // no new point to add to the particle's trajectory
+
+      // as for the trajectory insertion, only consider positions further in s
+      if (out_pos.s() > pos.s()) {
+        record(part, in_pos, out_pos, [&](double s) {
+          // exact kinematics inside the element, from a shortened copy of it
+          auto elem_tmp = elem->clone();
+          elem_tmp->setLength(s - elem->s());
+          return propagateThrough(in_pos, elem_tmp, energy_loss, part.charge()).stateVector();
+        });
+        pos = out_pos;
+      }
+
+      if (!check_apertures)
+        continue;
+
+      // has the particle entered and passed through the element?
+      const auto& aper = elem->aperture();
+      if (!aper || aper->type() == aperture::anInvalidAperture)
+        continue;
+      if (!aper->contains(in_pos.stateVector().position()))
+        return PropagationResult(
+            PropagationResult::Status::stopped, elem->s(), in_pos.stateVector(), elem, it - beamline_->begin());
+      if (!aper->contains(pos.stateVector().position()))
+        return PropagationResult(PropagationResult::Status::stopped,
+                                 elem->s() + elem->length(),
+                                 pos.stateVector(),
+                                 elem,
+                                 it - beamline_->begin());
     }
+    return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
+  }
+
+  void Propagator::propagate(Particle& part, const PropagationPlan& plan) const {
+    const auto result = track(part, plan);
+    if (!result.success())
+      raise(result);
+  }
+
+  PropagationResult Propagator::track(Particle& part, const PropagationPlan& plan) const {
     try {
-      for (auto it = beamline_->begin() + 1; it != beamline_->end(); ++it) {
-        // extract the previous and the current element in the beamline
-        const auto prev_elem = *(it - 1), elem = *it;
-        if (elem->s() > s_max)
-          break;
+      return finalise(part, transport(part, plan));
+    } catch (const Exception& e) {
+      return PropagationResult(PropagationResult::Status::failed, nullptr, e.message());
+    }
+  }
 
-        const Particle::Position in_pos(*part.rbegin());
+  PropagationResult Propagator::transport(Particle& part, const PropagationPlan& plan) const {
+    part.clear();
 
-        // initialise the outwards position
-        Particle::Position out_pos(-1., StateVector());
+    // retrieve all run parameters once for all
+    const bool check_apertures = context_.compute_apertures;
 
-        // between two elements
-        if (first_s > prev_elem->s() && first_s < elem->s()) {
-          switch (prev_elem->type()) {
-            case element::aDrift:
-              H_INFO << "Path starts inside drift " << prev_elem->name() << ".";
-              break;
-            default:
-              H_INFO << "Path starts inside element " << prev_elem->name() << ".";
-              break;
-          }
+    const double energy_loss = (context_.relative_energy) ? context_.beam_energy - part.lastStateVector().energy()
+                                                          : part.lastStateVector().energy();
+
+    const double first_s = part.firstS();
+
+    // current position of the particle (not necessarily recorded in its trajectory)
+    Particle::Position pos(*part.begin());
+    if (plan.beamlineSize() < 2) {
+      H_WARNING << "Insufficiant number of beamline elements for propagation: " << plan.beamlineSize();
+      return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
+    }
+    if (plan.fusion())
+      return propagateSegments(part, plan, energy_loss);
+
+    const Vector6 shift;
+    PropagationResult result;
+    if (recording_ == Recording::full)
+      part.reserve(plan.size());
+    for (size_t i = 1; i < plan.size(); ++i) {
+      // extract the previous and the current element in the plan
+      const auto &prev_rec = plan[i - 1], &rec = plan[i];
+
+      const Particle::Position in_pos(pos);
+      const double mp = in_pos.stateVector().m();
 
-          // build a temporary element mimicking the drift effect
-          auto elem_tmp = prev_elem->clone();
-          elem_tmp->setS(first_s);
-          elem_tmp->setLength(elem->s() - first_s);
-          out_pos = propagateThrough(in_pos, elem_tmp, energy_loss, part.charge());
+      // between two elements
+      if (first_s > prev_rec.s && first_s < rec.s) {
+        switch (prev_rec.type) {
+          case element::aDrift:
+            H_INFO << "Path starts inside drift " << plan.name(prev_rec) << ".";
+            break;
+          default:
+            H_INFO << "Path starts inside element " << plan.name(prev_rec) << ".";
+            break;
         }
-        // before one element
-        if (first_s <= elem->s())
-          out_pos = propagateThrough(in_pos, elem, energy_loss, part.charge());
-
-        if (out_pos.s() < 0.)
-          continue;  // no new point to add to the particle's trajectory
-
-        part.addPosition(out_pos.s(), out_pos.stateVector());
-
-        if (!Parameters::get()->computeApertureAcceptance())
-          continue;
-
-        const auto& aper = prev_elem->aperture();
-        if (!aper || aper->type() != aperture::anInvalidAperture)
-          continue;
-
-        const TwoVector pos_prev_elem(part.stateVectorAt(prev_elem->s()).position());
-        if (!aper->contains(pos_prev_elem))
-          throw ParticleStoppedException(__PRETTY_FUNCTION__, ExceptionType::warning, prev_elem)
-              << "Entering at " << pos_prev_elem << ", s = " << prev_elem->s() << " m\n\t"
-              << "Aperture centre at " << aper->position() << "\n\t"
-              << "Distance to aperture centre: " << (aper->position() - pos_prev_elem).mag() * 1.e2 << " cm.";
-        // has passed through the element?
-        //std::cout << prev_elem->s()+prev_elem->length() << "\t" << part.stateVectorAt( prev_elem->s()+prev_elem->length() ).position() << std::endl;
-        if (!aper->contains(part.stateVectorAt(prev_elem->s() + prev_elem->length()).position()))
-          throw ParticleStoppedException(__PRETTY_FUNCTION__, ExceptionType::warning, prev_elem)
-              << "Did not pass aperture " << aper->type() << ".";
       }
-    } catch (const ParticleStoppedException&) {
-      throw;
-    } catch (const Exception&) {
-      throw;
+      // before one element
+      if (first_s > rec.s)
+        continue;
+
+      const double out_s = rec.s + rec.length;
+      if (out_s < 0.)
+        continue;  // no new point to add to the particle's trajectory
+
+      const Matrix6 mat = plan.matrix(i, rec.length, energy_loss, mp, part.charge(), context_);
+      const Vector6 prop = mat * (in_pos.stateVector().vector() - shift) + shift;
+
+      if (Parameters::get()->loggingThreshold() <= ExceptionType::debug)
+        H_DEBUG << "Propagating particle of mass " << mp << " GeV"
+                << " and state vector at s = " << in_pos.s() << " m:" << in_pos.stateVector().vector().toVector().T()
+                << "\t"
+                << "through " << rec.type << " element \"" << plan.name(rec) << "\" "
+                << "at s = " << rec.s << " m, "
+                << "of length " << rec.length << " m,\n\t"
+                << "and with transfer matrix:" << mat << "\t"
+                << "Resulting state vector:" << prop.toVector().T();
+
+      // as for the trajectory insertion, only consider positions further in s
+      if (out_s > pos.s()) {
+        const Particle::Position out_pos(out_s, StateVector(prop, mp));
+        record(part, in_pos, out_pos, [&](double s) {
+          return StateVector(transportWithin(plan, i, i, in_pos.stateVector().vector(), s, energy_loss, mp,
+                                             part.charge()),
+                             mp);
+        });
+        pos = out_pos;
+      }
+
+      if (check_apertures && checkAperture(plan, i, in_pos.stateVector(), pos.stateVector(), result))
+        return result;
     }
+    return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
+  }
+
+  PropagationResult Propagator::propagateSegments(Particle& part,
+                                                  const PropagationPlan& plan,
+                                                  double energy_loss) const {
+    const bool check_apertures = context_.compute_apertures;
+    const double mp = part.lastStateVector().m();
+
+    Particle::Position pos(*part.begin());
+    PropagationResult result;
+    const auto segments = plan.segments(part.firstS(), energy_loss, mp, part.charge(), context_);
+    if (recording_ == Recording::full)
+      part.reserve(segments->size() + 1);
+    for (const auto& seg : *segments) {
+      const Particle::Position in_pos(pos);
+      const Vector6 prop = seg.matrix * in_pos.stateVector().vector();
+
+      if (Parameters::get()->loggingThreshold() <= ExceptionType::debug)
+        H_DEBUG << "Propagating particle of mass " << mp << " GeV"
+                << " and state vector at s = " << in_pos.s() << " m:" << in_pos.stateVector().vector().toVector().T()
+                << "\t"
+                << "through elements \"" << plan.name(plan[seg.first]) << "\" to \"" << plan.name(plan[seg.last])
+                << "\",\n\t"
+                << "and with transfer matrix:" << seg.matrix << "\t"
+                << "Resulting state vector:" << prop.toVector().T();
 
-    // finish by sorting all positions according to their s-coordinate
-    //part.sortPositions();
+      pos = Particle::Position(seg.s_out, StateVector(prop, mp));
+      record(part, in_pos, pos, [&](double s) {
+        return StateVector(transportWithin(plan, seg.first, seg.last, in_pos.stateVector().vector(), s, energy_loss,
+                                           mp, part.charge()),
+                           mp);
+      });
+
+      if (check_apertures)
+        for (size_t i = seg.first; i <= seg.last; ++i)
+          if (checkAperture(plan, i, in_pos.stateVector(), pos.stateVector(), result))
+            return result;
+    }
+    return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
   }
 
-  bool Propagator::stopped(Particle& part, double s_max) const {
-    for (auto it = beamline_->begin() + 1; it != beamline_->end(); ++it) {
-      // extract the previous and the current element in the beamline
-      const auto prev_elem = *(it - 1), elem = *it;
-      if (s_max > 0 && elem->s() > s_max)
-        return false;
-
-      const auto& aper = prev_elem->aperture();
-      if (aper && aper->type() != aperture::anInvalidAperture) {
-        // has passed the element entrance?
-        if (!aper->contains(part.stateVectorAt(prev_elem->s()).position()))
-          return true;
-        // has passed through the element?
-        if (!aper->contains(part.stateVectorAt(prev_elem->s() + prev_elem->length()).position()))
-          return true;
+  Vector6 Propagator::transportWithin(const PropagationPlan& plan,
+                                      size_t first,
+                                      size_t last,
+                                      const Vector6& in,
+                                      double s,
+                                      double energy_loss,
+                                      double mp,
+                                      int qp) const {
+    Vector6 vec = in;
+    for (size_t i = first; i <= last; ++i) {
+      const auto& rec = plan[i];
+      if (s < rec.s + rec.length)
+        return plan.matrix(i, s - rec.s, energy_loss, mp, qp, context_) * vec;
+      vec = plan.matrix(i, rec.length, energy_loss, mp, qp, context_) * vec;
+    }
+    return vec;
+  }
+
+  bool Propagator::checkAperture(const PropagationPlan& plan,
+                                 size_t i,
+                                 const StateVector& in,
+                                 const StateVector& out,
+                                 PropagationResult& result) const {
+    // has the particle entered and passed through the element?
+    const auto& rec = plan[i];
+    const auto& aper = plan.apertures()[i];
+    if (!aper.restricted)
+      return false;
+    if (!aper.contains(in.x(), in.y()))
+      result = PropagationResult(PropagationResult::Status::stopped, rec.s, in, plan.element(i), i);
+    else if (!aper.contains(out.x(), out.y()))
+      result = PropagationResult(PropagationResult::Status::stopped, rec.s + rec.length, out, plan.element(i), i);
+    else
+      return false;
+    return true;
+  }
+
+  PropagationResult Propagator::finalise(Particle& part, const PropagationResult& result) const {
+    // only the last position reached (or the stopping point) is kept
+    if (recording_ == Recording::finalState && result.lastS() > part.firstS())
+      part.addPosition(result.lastS(), result.stateVector());
+    return result;
+  }
+
+  void Propagator::raise(const PropagationResult& result) const {
+    if (result.status() != PropagationResult::Status::stopped)
+      throw H_ERROR << "Propagation failed: " << result.message();
+    const auto& elem = result.stoppingElement();
+    if (!elem || !elem->aperture())
+      throw ParticleStoppedException(__PRETTY_FUNCTION__, ExceptionType::warning, elem);
+    const auto& aper = elem->aperture();
+    const TwoVector pos = result.stateVector().position();
+    if (result.lastS() == elem->s())
+      throw ParticleStoppedException(__PRETTY_FUNCTION__, ExceptionType::warning, elem)
+          << "Entering at " << pos << ", s = " << elem->s() << " m\n\t"
+          << "Aperture centre at " << aper->position() << "\n\t"
+          << "Distance to aperture centre: " << (aper->position() - pos).mag() * 1.e2 << " cm.";
+    throw ParticleStoppedException(__PRETTY_FUNCTION__, ExceptionType::warning, elem)
+        << "Did not pass aperture " << aper->type() << ".";
+  }
+
+  void Propagator::propagate(Particle& part, const TransferMapTable& table) const {
+    const auto result = track(part, table);
+    if (!result.success())
+      raise(result);
+  }
+
+  PropagationResult Propagator::track(Particle& part, const TransferMapTable& table) const {
+    try {
+      return finalise(part, transport(part, table));
+    } catch (const Exception& e) {
+      return PropagationResult(PropagationResult::Status::failed, nullptr, e.message());
+    }
+  }
+
+  PropagationResult Propagator::transport(Particle& part, const TransferMapTable& table) const {
+    if (!table.covers(part, context_)) {
+      H_DEBUG << "Particle not covered by the transfer maps table. Using the exact propagation.";
+      return transport(part, table.plan());
+    }
+    part.clear();
+
+    const bool check_apertures = context_.compute_apertures;
+    const StateVector ini_sv = part.firstStateVector();
+    const double xi = e_to_xi(ini_sv.energy(), table.context().beam_energy);
+    const double energy_loss = (context_.relative_energy) ? context_.beam_energy - ini_sv.energy() : ini_sv.energy();
+
+    // all checkpoints are reached directly from the initial position
+    Particle::Position pos(*part.begin());
+    PropagationResult result;
+    if (recording_ == Recording::full)
+      part.reserve(table.size() + 1);
+    for (size_t i = 0; i < table.size(); ++i) {
+      const auto& seg = table.segment(i);
+      const Particle::Position in_pos(pos);
+      pos = Particle::Position(seg.s_out, StateVector(table.map(i, xi) * ini_sv.vector(), ini_sv.m()));
+      record(part, in_pos, pos, [&](double s) {
+        return StateVector(transportWithin(table.plan(), seg.first, seg.last, in_pos.stateVector().vector(), s,
+                                           energy_loss, ini_sv.m(), part.charge()),
+                           ini_sv.m());
+      });
+      if (check_apertures)
+        for (size_t j = seg.first; j <= seg.last; ++j)
+          if (checkAperture(table.plan(), j, in_pos.stateVector(), pos.stateVector(), result))
+            return result;
+    }
+    return PropagationResult(PropagationResult::Status::success, pos.s(), pos.stateVector());
+  }
+
+  void Propagator::propagate(ParticleBatch& batch, const PropagationPlan& plan) const {
+    if (batch.empty())
+      return;
+
+    const bool check_apertures = context_.compute_apertures;
+
+    if (plan.beamlineSize() < 2) {
+      H_WARNING << "Insufficiant number of beamline elements for propagation: " << plan.beamlineSize();
+      return;
+    }
+
+    // compute the energy loss of each particle (conserved along the path)
+    const size_t num_parts = batch.size();
+    std::vector<double> eloss(num_parts);
+    for (size_t i = 0; i < num_parts; ++i)
+      eloss[i] = (context_.relative_energy) ? context_.beam_energy - batch.energy()[i] : batch.energy()[i];
+
+    // group the particles sharing the same transfer matrices and starting point
+    const auto key = [&batch, &eloss](size_t i) {
+      return std::make_tuple(batch.status()[i], batch.charge()[i], batch.mass()[i], eloss[i], batch.s()[i]);
+    };
+    std::vector<size_t> order(num_parts);
+    std::iota(order.begin(), order.end(), 0);
+    const bool grouped =
+        std::is_sorted(order.begin(), order.end(), [&key](size_t i, size_t j) { return key(i) < key(j); });
+    if (!grouped)
+      std::stable_sort(order.begin(), order.end(), [&key](size_t i, size_t j) { return key(i) < key(j); });
+
+    // work on a reordered copy of the batch if needed
+    ParticleBatch sorted_batch;
+    if (!grouped) {
+      sorted_batch = batch.select(order);
+      std::vector<double> sorted_eloss(num_parts);
+      for (size_t i = 0; i < num_parts; ++i)
+        sorted_eloss[i] = eloss[order[i]];
+      eloss.swap(sorted_eloss);
+    }
+    ParticleBatch& work = grouped ? batch : sorted_batch;
+
+    double* cols[6];
+    for (unsigned short j = 0; j < 6; ++j)
+      cols[j] = work.component((StateVector::Components)j);
+
+    for (size_t begin = 0, end = 0; begin < num_parts; begin = end) {
+      // find the range of particles sharing the same properties
+      end = begin + 1;
+      while (end < num_parts && work.status()[end] == work.status()[begin] &&
+             work.charge()[end] == work.charge()[begin] && work.mass()[end] == work.mass()[begin] &&
+             eloss[end] == eloss[begin] && work.s()[end] == work.s()[begin])
+        ++end;
+      if (work.status()[begin] != ParticleBatch::Status::alive)
+        continue;
+
+      const double first_s = work.s()[begin], mp = work.mass()[begin];
+      const int qp = work.charge()[begin];
+      double last_s = first_s;
+      double* range[6];
+      for (unsigned short j = 0; j < 6; ++j)
+        range[j] = cols[j] + begin;
+      // particles stopped by an aperture keep their kinematics at the stopping point
+      std::vector<std::pair<size_t, double> > stopped;
+      std::vector<double> stopped_cols;
+      std::vector<uint64_t> survival((end - begin + 63) / 64);
+      const auto check_aperture = [&](size_t i, double s) {
+        const auto& aper = plan.apertures()[i];
+        if (!check_apertures || !aper.restricted)
+          return;
+        kernel::apertureMask(aper, range[StateVector::X], range[StateVector::Y], end - begin, survival.data());
+        for (size_t w = 0; w < survival.size(); ++w)
+          // only loop over the lost particles
+          for (uint64_t lost = ~survival[w]; lost != 0; lost &= lost - 1) {
+            const size_t k = begin + 64 * w + __builtin_ctzll(lost);
+            if (k >= end)
+              break;
+            if (work.status()[k] != ParticleBatch::Status::alive)
+              continue;
+            work.status()[k] = ParticleBatch::Status::stopped;
+            stopped.emplace_back(k, s);
+            for (unsigned short j = 0; j < 6; ++j)
+              stopped_cols.emplace_back(cols[j][k]);
+          }
+      };
+      try {
+        if (plan.fusion()) {
+          // keep the runs alive while iterating, as they may be flushed from the plan memoisation at any time
+          const auto segments = plan.segments(first_s, eloss[begin], mp, qp, context_);
+          for (const auto& seg : *segments) {
+            // aperture-restricted elements are always isolated in their own run
+            check_aperture(seg.first, plan[seg.first].s);
+            kernel::applyMatrix(seg.matrix, range, end - begin);
+            check_aperture(seg.last, seg.s_out);
+            last_s = seg.s_out;
+          }
+        } else
+          for (size_t i = 1; i < plan.size(); ++i) {
+            const auto &prev_rec = plan[i - 1], &rec = plan[i];
+            if (first_s > prev_rec.s && first_s < rec.s)
+              H_INFO << "Path starts inside element " << plan.name(prev_rec) << ".";
+            if (first_s > rec.s)
+              continue;
+            // as for the trajectory-based propagation, only consider positions further in s
+            const double out_s = rec.s + rec.length;
+            if (out_s < 0.)
+              continue;
+            check_aperture(i, rec.s);
+            if (out_s > last_s) {
+              kernel::applyMatrix(plan.matrix(i, rec.length, eloss[begin], mp, qp, context_), range, end - begin);
+              last_s = out_s;
+            }
+            check_aperture(i, out_s);
+          }
+      } catch (const Exception& e) {
+        std::replace(work.status() + begin,
+                     work.status() + end,
+                     ParticleBatch::Status::alive,
+                     ParticleBatch::Status::invalid);
+      }
+      std::fill(work.s() + begin, work.s() + end, last_s);
+      for (size_t k = 0; k < stopped.size(); ++k) {
+        work.s()[stopped[k].first] = stopped[k].second;
+        for (unsigned short j = 0; j < 6; ++j)
+          cols[j][stopped[k].first] = stopped_cols[6 * k + j];
       }
     }
-    return false;
+
+    if (!grouped)
+      batch.assign(order, work);
+  }
+
+  bool Propagator::stopped(Particle& part, double s_max) const {
+    return track(part, (s_max > 0.) ? s_max : beamline_->length()).status() == PropagationResult::Status::stopped;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const Propagator::Recording& rec) {
+    switch (rec) {
+      case Propagator::Recording::full:
+        return os << "full";
+      case Propagator::Recording::observationPlanes:
+        return os << "observation planes";
+      case Propagator::Recording::finalState:
+        return os << "final state";
+    }
+    return os;
   }
 
   Particle::Position Propagator::propagateThrough(const Particle::Position& ini_pos,
@@ -117,18 +528,18 @@ namespace hector {
       //const StateVector shift( elem->relativePosition(), elem->angles(), 0., 0. );
       //const StateVector shift( elem->relativePosition(), TwoVector(), 0., 0. );
       const StateVector shift(TwoVector(), TwoVector(), 0., 0.);
-      const Vector prop =
-          elem->matrix(eloss, ini_pos.stateVector().m(), qp) * (ini_pos.stateVector().vector() - shift.vector()) +
-          shift.vector();
+      const Matrix6 mat = elem->cachedMatrix(eloss, ini_pos.stateVector().m(), qp, context_);
+      const Vector6 prop = mat * (ini_pos.stateVector().vector() - shift.vector()) + shift.vector();
 
-      if (Parameters::get()->loggingThreshold() >= ExceptionType::debug)
+      if (Parameters::get()->loggingThreshold() <= ExceptionType::debug)
         H_DEBUG << "Propagating particle of mass " << ini_pos.stateVector().m() << " GeV"
-                << " and state vector at s = " << ini_pos.s() << " m:" << ini_pos.stateVector().vector().T() << "\t"
+                << " and state vector at s = " << ini_pos.s() << " m:" << ini_pos.stateVector().vector().toVector().T()
+                << "\t"
                 << "through " << elem->type() << " element \"" << elem->name() << "\" "
                 << "at s = " << elem->s() << " m, "
                 << "of length " << elem->length() << " m,\n\t"
-                << "and with transfer matrix:" << elem->matrix(eloss, ini_pos.stateVector().m(), qp) << "\t"
-                << "Resulting state vector:" << prop.T();
+                << "and with transfer matrix:" << mat << "\t"
+                << "Resulting state vector:" << prop.toVector().T();
 
       // perform the propagation (assuming that mass is conserved...)
       StateVector vec(prop, ini_pos.stateVector().m());
@@ -147,4 +558,90 @@ namespace hector {
     for (auto& part : beam)
       propagate(part, s_max);
   }
+
+  std::vector<PropagationResult> Propagator::propagate(Particles& beam,
+                                                       double s_max,
+                                                       unsigned short num_threads) const {
+    Executor exec(num_threads);
+    return propagate(beam, s_max, exec);
+  }
+
+  std::vector<PropagationResult> Propagator::propagate(Particles& beam, double s_max, Executor& exec) const {
+    std::vector<PropagationResult> results(beam.size());
+    // each particle is propagated independently, and its outcome stored at its own index
+    exec.parallelFor(beam.size(), 0, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        results[i] = track(beam[i], s_max);
+    });
+    return results;
+  }
+
+  void Propagator::propagate(Particles& beam, const PropagationPlan& plan) const {
+    for (auto& part : beam)
+      propagate(part, plan);
+  }
+
+  void Propagator::propagate(Particles& beam, const TransferMapTable& table) const {
+    for (auto& part : beam)
+      propagate(part, table);
+  }
+
+  void Propagator::fillHits(const Particle& part, const PropagationResult& result, HitTable::Hit* hits) const {
+    const auto& planes = planes_.positions();
+    // both the planes and the trajectory are ordered in s: a single sweep matches them
+    auto it = part.positions().begin();
+    for (size_t j = 0; j < planes.size(); ++j) {
+      auto& hit = hits[j];
+      while (it != part.positions().end() && it->first < planes[j])
+        ++it;
+      if (it != part.positions().end() && it->first == planes[j] &&
+          (result.status() != PropagationResult::Status::stopped || planes[j] <= result.lastS())) {
+        const auto& sv = it->second;
+        hit = HitTable::Hit{sv.x(), sv.y(), sv.Tx(), sv.Ty(), HitTable::Status::reached};
+        continue;
+      }
+      switch (result.status()) {
+        case PropagationResult::Status::success:
+          hit.status = HitTable::Status::notReached;
+          break;
+        case PropagationResult::Status::stopped:
+          hit.status = HitTable::Status::stopped;
+          break;
+        case PropagationResult::Status::failed:
+          hit.status = HitTable::Status::failed;
+          break;
+      }
+    }
+  }
+
+  PropagationResult Propagator::readout(Particle& part, const PropagationPlan& plan, HitTable::Hit* hits) const {
+    if (recording_ != Recording::observationPlanes) {
+      Propagator prop(*this);
+      prop.recording_ = Recording::observationPlanes;
+      return prop.readout(part, plan, hits);
+    }
+    const auto result = track(part, plan);
+    fillHits(part, result, hits);
+    return result;
+  }
+
+  template <typename F>
+  HitTable Propagator::readout(Particles& beam, Executor& exec, F track) const {
+    Propagator prop(*this);
+    prop.recording_ = Recording::observationPlanes;
+    HitTable hits(beam.size(), planes_.size());
+    exec.parallelFor(beam.size(), 0, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        prop.fillHits(beam[i], track(prop, beam[i]), hits.row(i));
+    });
+    return hits;
+  }
+
+  HitTable Propagator::readout(Particles& beam, double s_max, Executor& exec) const {
+    return readout(beam, exec, [s_max](const Propagator& prop, Particle& part) { return prop.track(part, s_max); });
+  }
+
+  HitTable Propagator::readout(Particles& beam, const PropagationPlan& plan, Executor& exec) const {
+    return readout(beam, exec, [&plan](const Propagator& prop, Particle& part) { return prop.track(part, plan); });
+  }
 }  // namespace hector
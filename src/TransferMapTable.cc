@@ -0,0 +1,173 @@
+#include "Hector/TransferMapTable.h"
+
+#include "Hector/Exception.h"
+#include "Hector/Particle.h"
+
+#include "Hector/Utils/Executor.h"
+#include "Hector/Utils/Kinematics.h"
+#include "Hector/Utils/String.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hector {
+  TransferMapTable::TransferMapTable(
+      const PropagationPlan& plan, double xi_min, double xi_max, double xi_step, const PropagationContext& ctx)
+      : plan_(plan),
+        context_(ctx),
+        xi_min_(xi_min),
+        xi_step_(xi_step),
+        num_nodes_(0),
+        first_s_(0.),
+        mass_(context_.beam_mass),
+        charge_(context_.beam_charge),
+        interp_(Interpolation::cubic) {
+    if (xi_step <= 0. || xi_max <= xi_min)
+      throw H_ERROR << "Invalid momentum loss grid: [" << xi_min << ", " << xi_max << "] with a step of " << xi_step
+                    << ".";
+    if (plan.size() < 2)
+      throw H_ERROR << "Insufficient number of elements to tabulate the transfer maps: " << plan.size() << ".";
+    num_nodes_ = (size_t)std::lround((xi_max - xi_min) / xi_step) + 1;
+    first_s_ = plan[0].s;
+  }
+
+  TransferMapTable::TransferMapTable(const PropagationPlan& plan,
+                                     double xi_min,
+                                     double xi_max,
+                                     double xi_step,
+                                     Executor& exec,
+                                     const PropagationContext& ctx)
+      : TransferMapTable(plan, xi_min, xi_max, xi_step, ctx) {
+    build(exec);
+  }
+
+  TransferMapTable::TransferMapTable(const PropagationPlan& plan,
+                                     double xi_min,
+                                     double xi_max,
+                                     double xi_step,
+                                     unsigned short num_threads,
+                                     const PropagationContext& ctx)
+      : TransferMapTable(plan, xi_min, xi_max, xi_step, ctx) {
+    // the pool of workers is only needed for the tabulation
+    Executor exec(num_threads);
+    build(exec);
+  }
+
+  void TransferMapTable::build(Executor& exec) {
+    // the structure of the collapsed runs only depends on the elements positions
+    segments_ = plan_.fuse(first_s_, energyLoss(xi_min_), mass_, charge_, context_);
+    if (segments_.empty())
+      throw H_ERROR << "No element to be crossed from s = " << first_s_ << " m.";
+
+    maps_.resize(segments_.size() * num_nodes_);
+    exec.parallelFor(num_nodes_, 0, [this](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        const auto maps = exactMaps(xi_min_ + j * xi_step_);
+        if (maps.size() != segments_.size())
+          throw H_ERROR << "Inconsistent number of checkpoints for node " << j << ": " << maps.size() << " instead of "
+                        << segments_.size() << ".";
+        for (size_t i = 0; i < maps.size(); ++i)
+          maps_[i * num_nodes_ + j] = maps[i];
+      }
+    });
+    H_DEBUG << "Transfer maps to " << segments_.size() << " checkpoint(s) tabulated for " << num_nodes_
+            << " momentum loss values in [" << xi_min_ << ", " << xiMax() << "].";
+  }
+
+  double TransferMapTable::energyLoss(double xi) const {
+    // same definition as for the element-by-element propagation
+    const double energy = xi_to_e(xi, context_.beam_energy);
+    return (context_.relative_energy) ? context_.beam_energy - energy : energy;
+  }
+
+  bool TransferMapTable::covers(const Particle& part, const PropagationContext& ctx) const {
+    if (ctx != context_ || part.firstS() != first_s_ || part.charge() != charge_ ||
+        part.firstStateVector().m() != mass_)
+      return false;
+    const double xi = e_to_xi(part.firstStateVector().energy(), context_.beam_energy);
+    return xi >= xi_min_ && xi <= xiMax();
+  }
+
+  Matrix6 TransferMapTable::map(size_t i, double xi) const {
+    // locate the grid interval and the position within it
+    const double u = std::min(std::max((xi - xi_min_) / xi_step_, 0.), (double)(num_nodes_ - 1));
+    const size_t j = std::min((size_t)u, num_nodes_ - 2);
+    const double t = u - j;
+
+    Matrix6 out;
+    const Matrix6 &m1 = node(i, j), &m2 = node(i, j + 1);
+    if (interp_ == Interpolation::linear || num_nodes_ < 3) {
+      for (size_t a = 0; a < 6; ++a)
+        for (size_t b = 0; b < 6; ++b)
+          out(a, b) = m1(a, b) + t * (m2(a, b) - m1(a, b));
+      return out;
+    }
+    // Catmull-Rom spline, with quadratically extrapolated nodes at the grid edges
+    const bool first = (j == 0), last = (j + 2 >= num_nodes_);
+    const Matrix6 &m0 = first ? node(i, j + 2) : node(i, j - 1), &m3 = last ? node(i, j - 1) : node(i, j + 2);
+    for (size_t a = 0; a < 6; ++a)
+      for (size_t b = 0; b < 6; ++b) {
+        const double p1 = m1(a, b), p2 = m2(a, b);
+        const double p0 = first ? 3. * (p1 - p2) + m0(a, b) : m0(a, b),
+                     p3 = last ? 3. * (p2 - p1) + m3(a, b) : m3(a, b);
+        out(a, b) = p1 + 0.5 * t * (p2 - p0 + t * (2. * p0 - 5. * p1 + 4. * p2 - p3 + t * (3. * (p1 - p2) + p3 - p0)));
+      }
+    return out;
+  }
+
+  std::vector<Matrix6> TransferMapTable::exactMaps(double xi) const {
+    const auto segments = plan_.fuse(first_s_, energyLoss(xi), mass_, charge_, context_);
+    std::vector<Matrix6> out;
+    out.reserve(segments.size());
+    for (const auto& seg : segments)
+      out.emplace_back(out.empty() ? seg.matrix : seg.matrix * out.back());
+    return out;
+  }
+
+  TransferMapTable::Accuracy TransferMapTable::accuracy(size_t num_samples) const {
+    Accuracy acc{0, 0., 0., xi_min_, 0};
+    num_samples = std::min(std::max<size_t>(num_samples, 1), num_nodes_ - 1);
+    for (size_t n = 0; n < num_samples; ++n) {
+      // half-way between two nodes, where the interpolation is the least accurate
+      const size_t j = n * (num_nodes_ - 1) / num_samples;
+      const double xi = xi_min_ + (j + 0.5) * xi_step_;
+      const auto exact = exactMaps(xi);
+      for (size_t i = 0; i < exact.size() && i < segments_.size(); ++i) {
+        const Matrix6 interp = map(i, xi);
+        for (size_t a = 0; a < 6; ++a)
+          for (size_t b = 0; b < 6; ++b) {
+            const double diff = std::fabs(interp(a, b) - exact[i](a, b));
+            if (diff > acc.max_abs_diff) {
+              acc.max_abs_diff = diff;
+              acc.worst_xi = xi;
+              acc.worst_segment = i;
+            }
+            if (exact[i](a, b) != 0.)
+              acc.max_rel_diff = std::max(acc.max_rel_diff, diff / std::fabs(exact[i](a, b)));
+          }
+      }
+      ++acc.num_samples;
+    }
+    return acc;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const TransferMapTable::Interpolation& interp) {
+    switch (interp) {
+      case TransferMapTable::Interpolation::linear:
+        return os << "linear";
+      case TransferMapTable::Interpolation::cubic:
+        return os << "cubic";
+    }
+    return os;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const TransferMapTable::Accuracy& acc) {
+    return os << format("%zu samples: max. abs. difference = %.3e (xi = %.5f, checkpoint %zu), "
+                        "max. rel. difference = %.3e",
+                        acc.num_samples,
+                        acc.max_abs_diff,
+                        acc.worst_xi,
+                        acc.worst_segment,
+                        acc.max_rel_diff);
+  }
+}  // namespace hector
@@ -0,0 +1,126 @@
+#include "Hector/Utils/BatchKernels.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace hector {
+  namespace kernel {
+    namespace {
+      /// Scalar version of the matrix application, for a range of state vectors
+      void applyMatrixScalar(const Matrix6& mat, double* const cols[6], size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+          const double in[6] = {cols[0][k], cols[1][k], cols[2][k], cols[3][k], cols[4][k], cols[5][k]};
+          for (unsigned short i = 0; i < 6; ++i) {
+            double out = 0.;
+            for (unsigned short j = 0; j < 6; ++j)
+              out += mat(i, j) * in[j];
+            cols[i][k] = out;
+          }
+        }
+      }
+      /// Scalar version of the aperture test, for a range of positions
+      void apertureMaskScalar(const aperture::ApertureTable::Entry& aper,
+                              const double* x,
+                              const double* y,
+                              size_t begin,
+                              size_t end,
+                              uint64_t* mask) {
+        for (size_t k = begin; k < end; ++k)
+          mask[k / 64] |= (uint64_t)aper.contains(x[k], y[k]) << (k % 64);
+      }
+    }  // namespace
+
+    void applyMatrix(const Matrix6& mat, double* const cols[6], size_t n) {
+      size_t k = 0;
+#if defined(__AVX512F__)
+      for (; k + 8 <= n; k += 8) {
+        __m512d in[6];
+        for (unsigned short j = 0; j < 6; ++j)
+          in[j] = _mm512_loadu_pd(cols[j] + k);
+        for (unsigned short i = 0; i < 6; ++i) {
+          __m512d out = _mm512_setzero_pd();
+          // no fused multiply-add, to keep the rounding of the scalar version
+          for (unsigned short j = 0; j < 6; ++j)
+            out = _mm512_add_pd(out, _mm512_mul_pd(_mm512_set1_pd(mat(i, j)), in[j]));
+          _mm512_storeu_pd(cols[i] + k, out);
+        }
+      }
+#elif defined(__AVX2__)
+      for (; k + 4 <= n; k += 4) {
+        __m256d in[6];
+        for (unsigned short j = 0; j < 6; ++j)
+          in[j] = _mm256_loadu_pd(cols[j] + k);
+        for (unsigned short i = 0; i < 6; ++i) {
+          __m256d out = _mm256_setzero_pd();
+          // no fused multiply-add, to keep the rounding of the scalar version
+          for (unsigned short j = 0; j < 6; ++j)
+            out = _mm256_add_pd(out, _mm256_mul_pd(_mm256_set1_pd(mat(i, j)), in[j]));
+          _mm256_storeu_pd(cols[i] + k, out);
+        }
+      }
+#endif
+      // remaining state vectors (or all of them if no vectorisation is available)
+      applyMatrixScalar(mat, cols, k, n);
+    }
+
+    void apertureMask(const aperture::ApertureTable::Entry& aper,
+                      const double* x,
+                      const double* y,
+                      size_t n,
+                      uint64_t* mask) {
+      const size_t num_words = (n + 63) / 64;
+      if (!aper.restricted) {
+        for (size_t w = 0; w < num_words; ++w)
+          mask[w] = (n - 64 * w >= 64) ? ~(uint64_t)0 : ((uint64_t)1 << (n - 64 * w)) - 1;
+        return;
+      }
+      for (size_t w = 0; w < num_words; ++w)
+        mask[w] = 0;
+      size_t k = 0;
+#if defined(__AVX512F__)
+      const __m512d x0 = _mm512_set1_pd(aper.x0), y0 = _mm512_set1_pd(aper.y0);
+      const __m512d half_x = _mm512_set1_pd(aper.half_x), half_y = _mm512_set1_pd(aper.half_y);
+      const __m512d inv_a = _mm512_set1_pd(aper.inv_a), inv_b = _mm512_set1_pd(aper.inv_b);
+      const __m512d one = _mm512_set1_pd(1.);
+      for (; k + 8 <= n; k += 8) {
+        const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + k), x0), dy = _mm512_sub_pd(_mm512_loadu_pd(y + k), y0);
+        const __m512d ex = _mm512_mul_pd(dx, inv_a), ey = _mm512_mul_pd(dy, inv_b);
+        // ordered comparisons: any NaN coordinate is flagged as lost
+        __mmask8 in = _mm512_cmp_pd_mask(_mm512_abs_pd(dx), half_x, _CMP_LT_OQ);
+        in = _mm512_mask_cmp_pd_mask(in, _mm512_abs_pd(dy), half_y, _CMP_LT_OQ);
+        in = _mm512_mask_cmp_pd_mask(
+            in, _mm512_add_pd(_mm512_mul_pd(ex, ex), _mm512_mul_pd(ey, ey)), one, _CMP_LT_OQ);
+        mask[k / 64] |= (uint64_t)in << (k % 64);
+      }
+#elif defined(__AVX2__)
+      const __m256d x0 = _mm256_set1_pd(aper.x0), y0 = _mm256_set1_pd(aper.y0);
+      const __m256d half_x = _mm256_set1_pd(aper.half_x), half_y = _mm256_set1_pd(aper.half_y);
+      const __m256d inv_a = _mm256_set1_pd(aper.inv_a), inv_b = _mm256_set1_pd(aper.inv_b);
+      const __m256d one = _mm256_set1_pd(1.), sign = _mm256_set1_pd(-0.);
+      for (; k + 4 <= n; k += 4) {
+        const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + k), x0), dy = _mm256_sub_pd(_mm256_loadu_pd(y + k), y0);
+        const __m256d ex = _mm256_mul_pd(dx, inv_a), ey = _mm256_mul_pd(dy, inv_b);
+        // ordered comparisons: any NaN coordinate is flagged as lost
+        const __m256d in = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, dx), half_x, _CMP_LT_OQ),
+                          _mm256_cmp_pd(_mm256_andnot_pd(sign, dy), half_y, _CMP_LT_OQ)),
+            _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(ex, ex), _mm256_mul_pd(ey, ey)), one, _CMP_LT_OQ));
+        mask[k / 64] |= (uint64_t)_mm256_movemask_pd(in) << (k % 64);
+      }
+#endif
+      // remaining positions (or all of them if no vectorisation is available)
+      apertureMaskScalar(aper, x, y, k, n, mask);
+    }
+
+    const char* instructionSet() {
+#if defined(__AVX512F__)
+      return "AVX-512";
+#elif defined(__AVX2__)
+      return "AVX2";
+#else
+      return "scalar";
+#endif
+    }
+  }  // namespace kernel
+}  // namespace hector
@@ -12,32 +12,45 @@ namespace hector {
     return num_gen_++;
   }
 
-  Particle beam::Xscanner::shoot() {
-    const TwoVector pos_ini(p1_.first + LinearScanner::next() * (p1_.second - p1_.first) / (num_part_ - 1), p2_.first);
-    const LorentzVector mom_ini(0., 0., 0., Parameters::get()->beamEnergy());
-    return Particle(StateVector(mom_ini, pos_ini), s_.first);
+  Particle beam::LinearScanner::shoot() {
+    Particle part(stateVector(next()), s_.first);
+    part.setCharge(Parameters::get()->beamParticlesCharge());
+    return part;
   }
 
-  Particle beam::Yscanner::shoot() {
-    const TwoVector pos_ini(p2_.first, p1_.first + LinearScanner::next() * (p1_.second - p1_.first) / (num_part_ - 1));
-    const LorentzVector mom_ini(0., 0., 0., Parameters::get()->beamEnergy());
-    return Particle(StateVector(mom_ini, pos_ini), s_.first);
+  void beam::LinearScanner::shootN(size_t n, ParticleBatch& batch) {
+    if (num_gen_ + n > num_part_)
+      throw H_ERROR << "Too much particles requested! " << num_part_ - num_gen_ << " remaining in the scan.";
+    const size_t offset = batch.size();
+    batch.resize(offset + n);
+    for (size_t i = 0; i < n; ++i) {
+      batch.setStateVector(offset + i, stateVector(next()));
+      batch.s()[offset + i] = s_.first;
+    }
   }
 
-  Particle beam::TXscanner::shoot() {
-    const TwoVector angles(p1_.first + LinearScanner::next() * (p1_.second - p1_.first) / (num_part_ - 1), p2_.first);
-    return Particle(StateVector(TwoVector(), angles, e_.first), s_.first);
+  StateVector beam::Xscanner::stateVector(unsigned short k) const {
+    return StateVector(Vector6(scanValue(p1_, k), 0., p2_.first, 0., Parameters::get()->beamEnergy(), 1.),
+                       Parameters::get()->beamParticlesMass());
   }
 
-  Particle beam::TYscanner::shoot() {
-    const TwoVector angles(p2_.first, p1_.first + LinearScanner::next() * (p1_.second - p1_.first) / (num_part_ - 1));
-    return Particle(StateVector(TwoVector(), angles, e_.first), s_.first);
+  StateVector beam::Yscanner::stateVector(unsigned short k) const {
+    return StateVector(Vector6(p2_.first, 0., scanValue(p1_, k), 0., Parameters::get()->beamEnergy(), 1.),
+                       Parameters::get()->beamParticlesMass());
   }
 
-  Particle beam::Xiscanner::shoot() {
-    const double energy = e_.first + LinearScanner::next() * (e_.second - e_.first) / (num_part_ - 1);
+  StateVector beam::TXscanner::stateVector(unsigned short k) const {
+    return StateVector(TwoVector(), TwoVector(scanValue(p1_, k), p2_.first), e_.first);
+  }
+
+  StateVector beam::TYscanner::stateVector(unsigned short k) const {
+    return StateVector(TwoVector(), TwoVector(p2_.first, scanValue(p1_, k)), e_.first);
+  }
+
+  StateVector beam::Xiscanner::stateVector(unsigned short k) const {
+    const double energy = scanValue(e_, k);
     const double mom = sqrt(energy * energy - pow(Parameters::get()->beamParticlesMass(), 2));
-    return Particle(StateVector(LorentzVector(0., 0., mom, energy), TwoVector(p1_.first, p2_.first)), s_.first);
+    return StateVector(LorentzVector(0., 0., mom, energy), TwoVector(p1_.first, p2_.first));
   }
 
   beam::params_t beam::GaussianParticleGun::parameters(float lim1, float lim2) {
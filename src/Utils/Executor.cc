@@ -0,0 +1,114 @@
+#include "Hector/Utils/Executor.h"
+
+#include <algorithm>
+
+namespace hector {
+  Executor::Executor(unsigned short num_threads) : job_id_(0), stop_(false), remaining_(0) {
+    if (num_threads == 0)
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (num_threads < 2)  // everything is processed in the calling thread
+      return;
+    for (unsigned short i = 0; i < num_threads; ++i)
+      queues_.emplace_back(new Queue);
+    for (unsigned short i = 0; i < num_threads; ++i)
+      threads_.emplace_back(&Executor::work, this, i);
+  }
+
+  Executor::~Executor() {
+    {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      stop_ = true;
+    }
+    job_cv_.notify_all();
+    for (auto& thr : threads_)
+      thr.join();
+  }
+
+  void Executor::parallelFor(size_t num, size_t grain, const RangeFunction& func) {
+    if (num == 0)
+      return;
+    // serial processing
+    if (threads_.empty()) {
+      func(0, num);
+      return;
+    }
+    std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+    // by default, a few ranges per worker for the stealing to balance the load
+    if (grain == 0)
+      grain = std::max<size_t>(1, num / (threads_.size() * 8));
+
+    const size_t num_tasks = (num + grain - 1) / grain;
+    {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      remaining_ = num_tasks;
+      exception_ = nullptr;
+      // distribute contiguous blocks of ranges to each worker
+      const size_t tasks_per_queue = (num_tasks + queues_.size() - 1) / queues_.size();
+      for (size_t i = 0; i < num_tasks; ++i) {
+        auto& queue = *queues_[i / tasks_per_queue];
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        queue.tasks.push_back(Task{i * grain, std::min(num, (i + 1) * grain), &func});
+      }
+      ++job_id_;
+    }
+    job_cv_.notify_all();
+
+    std::unique_lock<std::mutex> lock(job_mutex_);
+    done_cv_.wait(lock, [this] { return remaining_ == 0; });
+    if (exception_)
+      std::rethrow_exception(exception_);
+  }
+
+  void Executor::work(size_t id) {
+    unsigned long long last_job = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(job_mutex_);
+        job_cv_.wait(lock, [this, &last_job] { return stop_ || job_id_ != last_job; });
+        if (stop_)
+          return;
+        last_job = job_id_;
+      }
+      Task task;
+      while (next(id, task))
+        run(task);
+    }
+  }
+
+  bool Executor::next(size_t id, Task& task) {
+    {  // first look into the worker own queue
+      auto& queue = *queues_[id];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+      }
+    }
+    // then steal from the back of the other queues
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      auto& queue = *queues_[(id + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Executor::run(const Task& task) {
+    try {
+      (*task.func)(task.begin, task.end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      if (!exception_)
+        exception_ = std::current_exception();
+    }
+    if (--remaining_ == 0) {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      done_cv_.notify_all();
+    }
+  }
+}  // namespace hector
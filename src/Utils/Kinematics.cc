@@ -1,12 +1,28 @@
 #include "Hector/Utils/Kinematics.h"
 #include "Hector/Utils/BeamProducer.h"
+#include "Hector/Utils/Random.h"
 
 #include "Hector/Parameters.h"
 #include "Hector/Exception.h"
 #include "Hector/Particle.h"
 
+#include <atomic>
+
 namespace hector {
+  namespace {
+    /// Key of the per-thread photon emission streams, apart from the (user-defined) particle guns seeds
+    constexpr uint64_t emission_seed = 0x6b696e656d676d61ull;
+  }  // namespace
+
   void emitGamma(Particle& part, double e_gamma, double q2_gamma, double phi_min, double phi_max) {
+    // one independent stream per thread, for lack of any event/particle identifier
+    static std::atomic<uint64_t> num_streams(0);
+    thread_local random::Stream rng(emission_seed, num_streams++);
+    emitGamma(part, e_gamma, q2_gamma, phi_min, phi_max, rng);
+  }
+
+  void emitGamma(
+      Particle& part, double e_gamma, double q2_gamma, double phi_min, double phi_max, random::Stream& rng) {
     const double pos_ini = part.firstS();
     auto& sv_ini = part.firstStateVector();
 
@@ -48,7 +64,7 @@ namespace hector {
                  seta = sqrt(1. - ceta * ceta);
     // theta is the angle between particle and beam
     const double theta = atan(seta / (Parameters::get()->beamEnergy() / gkk - ceta)),
-                 phi = phi_min + rand() * (phi_max - phi_min) / RAND_MAX;
+                 phi = rng.uniform(phi_min, phi_max);
 
     TwoVector old_ang(sv_ini.angles());
     sv_ini.setAngles(old_ang + TwoVector(theta * cos(phi), -theta * sin(phi)));
@@ -0,0 +1,44 @@
+#include "Hector/Utils/MappedFile.h"
+#include "Hector/Exception.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hector {
+  MappedFile::MappedFile(const std::string& path) : path_(path), data_(nullptr), size_(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw H_ERROR << "Impossible to open file \"" << path << "\" for reading: " << std::strerror(errno) << ".";
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw H_ERROR << "Impossible to retrieve the size of file \"" << path << "\": " << std::strerror(errno) << ".";
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw H_ERROR << "Impossible to map file \"" << path << "\" into memory: " << std::strerror(errno) << ".";
+      }
+      data_ = static_cast<const char*>(addr);
+    }
+    // the mapping remains valid once the descriptor is closed
+    ::close(fd);
+  }
+
+  MappedFile::MappedFile(MappedFile&& oth) : path_(std::move(oth.path_)), data_(oth.data_), size_(oth.size_) {
+    oth.data_ = nullptr;
+    oth.size_ = 0;
+  }
+
+  MappedFile::~MappedFile() {
+    if (data_)
+      ::munmap(const_cast<char*>(data_), size_);
+  }
+}  // namespace hector
@@ -0,0 +1,44 @@
+#include "Hector/Utils/Matrix6.h"
+#include "Hector/Exception.h"
+
+#include <algorithm>
+
+namespace hector {
+  Vector6::Vector6(const Vector& vec) : v_{} {
+    if (vec.num_row() != 6)
+      throw H_ERROR << "Invalid vector dimension: " << vec.num_row() << " (should be 6).";
+    for (size_t i = 0; i < 6; ++i)
+      v_[i] = vec[i];
+  }
+
+  Vector Vector6::toVector() const {
+    Vector out(6, 0);
+    for (size_t i = 0; i < 6; ++i)
+      out[i] = v_[i];
+    return out;
+  }
+
+  bool Vector6::operator==(const Vector6& rhs) const { return std::equal(v_, v_ + 6, rhs.v_); }
+
+  Matrix6::Matrix6(const Matrix& mat) : m_{} {
+    if (mat.num_row() != 6 || mat.num_col() != 6)
+      throw H_ERROR << "Invalid matrix dimension: " << mat.num_row() << "x" << mat.num_col() << " (should be 6x6).";
+    for (size_t i = 0; i < 6; ++i)
+      for (size_t j = 0; j < 6; ++j)
+        m_[i * 6 + j] = mat(i + 1, j + 1);
+  }
+
+  Matrix Matrix6::toMatrix() const {
+    Matrix out(6, 6, 0);
+    for (size_t i = 0; i < 6; ++i)
+      for (size_t j = 0; j < 6; ++j)
+        out(i + 1, j + 1) = m_[i * 6 + j];
+    return out;
+  }
+
+  bool Matrix6::operator==(const Matrix6& rhs) const { return std::equal(m_, m_ + 36, rhs.m_); }
+
+  std::ostream& operator<<(std::ostream& os, const Vector6& vec) { return os << vec.toVector(); }
+
+  std::ostream& operator<<(std::ostream& os, const Matrix6& mat) { return os << mat.toMatrix(); }
+}  // namespace hector
@@ -0,0 +1,67 @@
+#include "Hector/Utils/Random.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hector {
+  namespace random {
+    void Stream::seek(uint64_t pos) {
+      ctr_[0] = (uint32_t)(pos / 4);
+      num_used_ = 4;
+      has_spare_ = false;
+      // skip the first words of the block
+      for (unsigned short i = 0; i < pos % 4; ++i)
+        next();
+    }
+
+    double Stream::gaussian(double mean, double sigma) {
+      if (has_spare_) {
+        has_spare_ = false;
+        return mean + sigma * spare_;
+      }
+      const double radius = std::sqrt(-2. * std::log(uniform())), phi = 2. * M_PI * uniform();
+      spare_ = radius * std::sin(phi);
+      has_spare_ = true;
+      return mean + sigma * radius * std::cos(phi);
+    }
+
+    void Stream::uniformColumns(
+        uint64_t seed, uint64_t stream, uint32_t first, size_t n, unsigned short num_draws, double* const* out) {
+      // sub-streams are processed by chunks, with the counters words stored as columns
+      static constexpr size_t num_lanes = 64;
+      uint32_t ctr0[num_lanes], ctr1[num_lanes], ctr2[num_lanes], ctr3[num_lanes];
+      for (size_t begin = 0; begin < n; begin += num_lanes) {
+        const size_t num = std::min(num_lanes, n - begin);
+        // each block provides two draws
+        for (unsigned short blk = 0; 2 * blk < num_draws; ++blk) {
+          for (size_t l = 0; l < num; ++l) {
+            ctr0[l] = blk;
+            ctr1[l] = first + (uint32_t)(begin + l);
+            ctr2[l] = (uint32_t)stream;
+            ctr3[l] = (uint32_t)(stream >> 32);
+          }
+          uint32_t key0 = (uint32_t)seed, key1 = (uint32_t)(seed >> 32);
+          for (unsigned short i = 0; i < 10; ++i) {
+            for (size_t l = 0; l < num; ++l) {
+              const uint64_t prod0 = (uint64_t)Philox::mul0 * ctr0[l], prod1 = (uint64_t)Philox::mul1 * ctr2[l];
+              ctr0[l] = (uint32_t)(prod1 >> 32) ^ ctr1[l] ^ key0;
+              ctr1[l] = (uint32_t)prod1;
+              ctr2[l] = (uint32_t)(prod0 >> 32) ^ ctr3[l] ^ key1;
+              ctr3[l] = (uint32_t)prod0;
+            }
+            key0 += Philox::weyl0;
+            key1 += Philox::weyl1;
+          }
+          double* out0 = out[2 * blk] + begin;
+          for (size_t l = 0; l < num; ++l)
+            out0[l] = toUniform(((uint64_t)ctr0[l] << 32) | ctr1[l]);
+          if (2 * blk + 1 == num_draws)
+            break;
+          double* out1 = out[2 * blk + 1] + begin;
+          for (size_t l = 0; l < num; ++l)
+            out1[l] = toUniform(((uint64_t)ctr2[l] << 32) | ctr3[l]);
+        }
+      }
+    }
+  }  // namespace random
+}  // namespace hector
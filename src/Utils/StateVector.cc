@@ -7,21 +7,20 @@
 #include "Hector/Exception.h"
 
 namespace hector {
-  StateVector::StateVector() : Vector(6, 0), m_(0.) {
-    (*this)[K] = 1.;
-    (*this)[E] = Parameters::get()->beamEnergy();
+  StateVector::StateVector() : m_(0.) {
+    vec_[K] = 1.;
+    vec_[E] = Parameters::get()->beamEnergy();
   }
 
-  StateVector::StateVector(const Vector& vec, double mass) : Vector(vec), m_(mass) {}
+  StateVector::StateVector(const Vector& vec, double mass) : vec_(vec), m_(mass) {}
 
-  StateVector::StateVector(const LorentzVector& mom, const TwoVector& pos) : Vector(6, 1), m_(mom.m()) {
+  StateVector::StateVector(const LorentzVector& mom, const TwoVector& pos) : m_(mom.m()) {
     setPosition(pos);
     setMomentum(mom);
-    (*this)[K] = 1.;
+    vec_[K] = 1.;
   }
 
-  StateVector::StateVector(const TwoVector& pos, const TwoVector& ang, double energy, double kick)
-      : Vector(6, 1), m_(0.) {
+  StateVector::StateVector(const TwoVector& pos, const TwoVector& ang, double energy, double kick) : m_(0.) {
     setPosition(pos);
     setAngles(ang);
     if (energy < 0.)
@@ -36,23 +35,23 @@ namespace hector {
 
   void StateVector::setPosition(double x, double y) {
     // store in m
-    (*this)[X] = x;
-    (*this)[Y] = y;
+    vec_[X] = x;
+    vec_[Y] = y;
   }
 
   TwoVector StateVector::position() const {
     // return in m
-    return TwoVector((*this)[X], (*this)[Y]);
+    return TwoVector(vec_[X], vec_[Y]);
   }
 
   void StateVector::setAngles(double tx, double ty) {
-    (*this)[TX] = tx;
-    (*this)[TY] = ty;
+    vec_[TX] = tx;
+    vec_[TY] = ty;
   }
 
   TwoVector StateVector::angles() const {
     // return in rad
-    return TwoVector((*this)[TX], (*this)[TY]);
+    return TwoVector(vec_[TX], vec_[TY]);
   }
 
   void StateVector::setMomentum(const LorentzVector& mom) {
@@ -63,7 +62,7 @@ namespace hector {
 
   void StateVector::addMomentum(const LorentzVector& mom) {
     setAngles(angles() + TwoVector(mom.px() / mom.pz(), mom.py() / mom.pz()));
-    (*this)[E] = mom.e();
+    vec_[E] = mom.e();
     m_ = mom.m();
   }
 
@@ -78,7 +77,7 @@ namespace hector {
     if (mass != momentum().m()) {
       m_ = mass;
       if (momentum().mag2() != 0.)
-        (*this)[E] = std::hypot(momentum().mag(), m_);  // match the energy accordingly
+        vec_[E] = std::hypot(momentum().mag(), m_);  // match the energy accordingly
       else {
         const int sign = 1;  //FIXME
         setMomentum(
@@ -0,0 +1,81 @@
+#include "Hector/Utils/Trajectory.h"
+
+#include <algorithm>
+
+namespace hector {
+  namespace {
+    bool lowerS(const Trajectory::value_type& pos, double s) { return pos.first < s; }
+    bool upperS(double s, const Trajectory::value_type& pos) { return s < pos.first; }
+  }  // namespace
+
+  Trajectory& Trajectory::operator=(const Trajectory& rhs) {
+    points_ = rhs.points_;
+    hint_.store(0, std::memory_order_relaxed);
+    return *this;
+  }
+
+  Trajectory& Trajectory::operator=(Trajectory&& rhs) noexcept {
+    points_ = std::move(rhs.points_);
+    hint_.store(0, std::memory_order_relaxed);
+    return *this;
+  }
+
+  void Trajectory::clear() {
+    points_.clear();
+    hint_.store(0, std::memory_order_relaxed);
+  }
+
+  std::pair<Trajectory::iterator, bool> Trajectory::insert(const value_type& pos) {
+    // most common case: positions appended along the path
+    if (points_.empty() || points_.back().first < pos.first) {
+      points_.emplace_back(pos);
+      return std::make_pair(points_.end() - 1, true);
+    }
+    auto it = std::lower_bound(points_.begin(), points_.end(), pos.first, lowerS);
+    if (it->first == pos.first)
+      return std::make_pair(it, false);
+    return std::make_pair(points_.insert(it, pos), true);
+  }
+
+  Trajectory::iterator Trajectory::erase(const_iterator first, const_iterator last) {
+    hint_.store(0, std::memory_order_relaxed);
+    return points_.erase(first, last);
+  }
+
+  Trajectory::iterator Trajectory::find(double s) {
+    auto it = std::lower_bound(points_.begin(), points_.end(), s, lowerS);
+    return (it != points_.end() && it->first == s) ? it : points_.end();
+  }
+
+  Trajectory::const_iterator Trajectory::find(double s) const {
+    auto it = lower_bound(s);
+    return (it != points_.end() && it->first == s) ? it : points_.end();
+  }
+
+  Trajectory::const_iterator Trajectory::lower_bound(double s) const {
+    return std::lower_bound(points_.begin(), points_.end(), s, lowerS);
+  }
+
+  Trajectory::const_iterator Trajectory::upper_bound(double s) const {
+    return std::upper_bound(points_.begin(), points_.end(), s, upperS);
+  }
+
+  size_t Trajectory::locate(double s) const {
+    const size_t num_points = points_.size();
+    if (num_points == 0 || s < points_.front().first)
+      return num_points;
+    // first look at the previously located position and its successor
+    size_t i = hint_.load(std::memory_order_relaxed);
+    if (i < num_points && points_[i].first <= s) {
+      if (i + 1 == num_points || s < points_[i + 1].first)
+        return i;
+      if (i + 2 == num_points || s < points_[i + 2].first) {
+        hint_.store(i + 1, std::memory_order_relaxed);
+        return i + 1;
+      }
+    }
+    i = (upper_bound(s) - points_.begin()) - 1;
+    hint_.store(i, std::memory_order_relaxed);
+    return i;
+  }
+}  // namespace hector
@@ -1,5 +1,4 @@
 #include "Hector/Exception.h"
-#include "Hector/ParticleStoppedException.h"
 
 #include "Hector/IO/TwissHandler.h"
 
@@ -69,14 +68,11 @@ int main(int argc, char* argv[]) {
     for (unsigned int i = 0; i < num_part; ++i) {
       hector::Particle p = gun.shoot();
       p.setCharge(+1);
-      try {
-        prop.propagate(p, 203.826);
-      } catch (const hector::ParticleStoppedException& e) {
-        stopping_elements[e.stoppingElement()->name()]++;
-        continue;
-      } catch (const hector::Exception& e) {
-        e.dump(std::cerr);
-      }
+      const auto result = prop.track(p, 203.826);
+      if (result.status() == hector::PropagationResult::Status::stopped)
+        stopping_elements[result.stoppingElement()->name()]++;
+      else if (!result.success())
+        H_WARNING << "Propagation failed: " << result.message();
     }
 
     H_INFO.log([&](auto& log) {
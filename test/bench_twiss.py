@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Compare the Twiss files parsing time of two Hector builds on the same synthetic LHC-like optics file.
+
+Each build is given by its source directory and its build directory (holding libHector2 and a CMakeCache.txt file
+pointing to the CLHEP installation). A small parsing driver is compiled against each build, and run several times
+on the same generated file ; the best parsing time, and the consistency of the parsed beamlines, are reported.
+
+usage: bench_twiss.py BASELINE_SOURCE BASELINE_BUILD SOURCE BUILD [--runs N] [--output FILE]
+"""
+
+import argparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+DRIVER = r'''
+#include "Hector/Apertures/ApertureBase.h"
+#include "Hector/Beamline.h"
+#include "Hector/Elements/ElementBase.h"
+#include "Hector/IO/TwissHandler.h"
+#include "Hector/Parameters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char* argv[]) {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto start = std::chrono::steady_clock::now();
+  hector::io::Twiss parser(argv[1], argv[2], atof(argv[3]), atof(argv[4]));
+  fprintf(stderr, "%.6f\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  for (const auto* bl : {parser.rawBeamline(), parser.beamline()}) {
+    printf("--- %zu elements, length %.10g\n", bl->elements().size(), bl->length());
+    for (const auto& elem : bl->elements()) {
+      printf("%s %d %.10g %.10g %.10g %.10g %.10g %.10g %.10g", elem->name().c_str(), (int)elem->type(), elem->s(),
+             elem->length(), elem->magneticStrength(), elem->beta().x(), elem->beta().y(), elem->dispersion().x(),
+             elem->dispersion().y());
+      if (elem->aperture()) {
+        printf(" %d", (int)elem->aperture()->type());
+        for (const auto& par : elem->aperture()->parameters())
+          printf(" %.10g", par);
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
+'''
+
+# columns read by the parser, interleaved with unused ones
+USED = ['NAME', 'KEYWORD', 'S', 'L', 'K0L', 'K1L', 'HKICK', 'VKICK', 'BETX', 'BETY', 'X', 'Y', 'DX', 'DY']
+APERTURE = ['APERTYPE', 'APER_1', 'APER_2', 'APER_3', 'APER_4']
+UNUSED = ['ALFX', 'ALFY', 'MUX', 'MUY', 'DPX', 'DPY', 'PX', 'PY', 'T', 'PT', 'K2L', 'K3L', 'K4L', 'K5L', 'K1SL',
+          'K2SL', 'K3SL', 'TILT', 'E1', 'E2', 'H1', 'H2', 'FINT', 'FINTX', 'HGAP', 'ANGLE', 'WX', 'WY', 'PHIX', 'PHIY',
+          'DMUX', 'DMUY', 'DDX', 'DDY', 'DDPX', 'DDPY', 'RE11', 'RE12', 'RE21', 'RE22', 'N1', 'VOLT', 'LAG', 'FREQ']
+STRINGS = ('NAME', 'KEYWORD', 'APERTYPE')
+
+
+def generate(path, length=26658.8832, ip_index=6000):
+    """Write a full-ring optics file, with the quoting and headers conventions understood by all parsers"""
+    random.seed(1)
+    cols = USED + UNUSED[:20] + APERTURE + UNUSED[20:]
+    kinds = [('QUADRUPOLE', 'MQ', 3.1), ('DRIFT', 'DRIFT_', 1.), ('SBEND', 'MB', 14.3), ('DRIFT', 'DRIFT_', 0.7),
+             ('MONITOR', 'BPM', 0.), ('HKICKER', 'MCBH', 0.6), ('VKICKER', 'MCBV', 0.6), ('MARKER', 'MK', 0.),
+             ('RCOLLIMATOR', 'TC', 1.), ('SEXTUPOLE', 'MS', 0.4)]
+    with open(path, 'w') as out:
+        for key, fmt, val in [('NAME', '%05s', '"TWISS"'), ('TYPE', '%05s', '"TWISS"'), ('MASS', '%le', 0.9382720813),
+                              ('CHARGE', '%le', 1), ('ENERGY', '%le', 6500), ('LENGTH', '%le', length),
+                              ('TITLE', '%08s', '"benchmark"')]:
+            out.write('@ %-16s %-8s %s\n' % (key, fmt, val))
+        out.write('* ' + ' '.join('%-18s' % col for col in cols) + '\n')
+        out.write('$ ' + ' '.join('%-18s' % ('%s' if col in STRINGS else '%le') for col in cols) + '\n')
+        pos, i = 0., 0
+        while pos < length:
+            keyword, prefix, elem_length = kinds[i % len(kinds)]
+            name = '%s.%d' % (prefix, i)
+            if i == ip_index:
+                name, keyword, elem_length = 'IP5', 'MARKER', 0.
+            pos += elem_length
+            vals = dict((col, random.uniform(-1., 100.)) for col in UNUSED + ['BETX', 'BETY', 'X', 'Y', 'DX', 'DY'])
+            vals.update({'NAME': name, 'KEYWORD': keyword, 'S': pos, 'L': elem_length, 'K0L': 0., 'K1L': 0.,
+                         'HKICK': 0., 'VKICK': 0., 'APERTYPE': 'NONE', 'APER_1': 0., 'APER_2': 0., 'APER_3': 0.,
+                         'APER_4': 0.})
+            if keyword == 'QUADRUPOLE':
+                vals['K1L'] = random.uniform(-0.02, 0.02)
+            elif keyword == 'SBEND':
+                vals['K0L'] = 0.008
+            elif keyword in ('HKICKER', 'VKICKER'):
+                vals[keyword[0] + 'KICK'] = 1.e-6
+            if keyword in ('QUADRUPOLE', 'SBEND'):
+                vals.update({'APERTYPE': 'RECTELLIPSE', 'APER_1': 0.022, 'APER_2': 0.017, 'APER_3': 0.022,
+                             'APER_4': 0.022})
+            elif keyword == 'RCOLLIMATOR':
+                vals.update({'APERTYPE': 'RECTANGLE', 'APER_1': 0.04, 'APER_2': 0.02})
+            out.write(' ' + ' '.join(('%-18s' % ('"%s"' % vals[col])) if col in STRINGS else '%18.10g' % vals[col]
+                                     for col in cols) + '\n')
+            i += 1
+
+
+def compile_driver(source_dir, build_dir, work_dir, label):
+    """Build the parsing driver against one Hector build"""
+    with open(os.path.join(build_dir, 'CMakeCache.txt')) as cache:
+        cache_vars = dict(re.findall(r'^(CLHEP_\w+):\w+=(.*)$', cache.read(), re.M))
+    src, exe = os.path.join(work_dir, 'driver.cc'), os.path.join(work_dir, 'driver_' + label)
+    with open(src, 'w') as out:
+        out.write(DRIVER)
+    build_dir = os.path.abspath(build_dir)
+    subprocess.check_call([os.environ.get('CXX', 'c++'), '-std=c++14', '-O2', '-I' + os.path.abspath(source_dir),
+                           '-I' + cache_vars['CLHEP_INCLUDE'], src, '-o', exe, '-L' + build_dir,
+                           '-Wl,-rpath,' + build_dir, '-lHector2', cache_vars['CLHEP_LIB']])
+    return exe
+
+
+def run(exe, path, args, num_runs):
+    """Best parsing time, and printout of the parsed beamlines"""
+    times, dump = [], None
+    for _ in range(num_runs):
+        proc = subprocess.run([exe, path] + args, stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=True,
+                              universal_newlines=True)
+        times.append(float(proc.stderr.split()[-1]))
+        dump = proc.stdout
+    return min(times), dump
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('baseline_source')
+    parser.add_argument('baseline_build')
+    parser.add_argument('source')
+    parser.add_argument('build')
+    parser.add_argument('--runs', type=int, default=5, help='number of parsings for each build')
+    parser.add_argument('--output', help='path to the generated optics file (kept if given)')
+    opts = parser.parse_args(argv)
+
+    work_dir = tempfile.mkdtemp(prefix='bench_twiss')
+    path = opts.output or os.path.join(work_dir, 'bench.tfs')
+    generate(path)
+    print('Optics file: %s (%.1f MB)' % (path, os.path.getsize(path) * 1.e-6))
+    exes = [compile_driver(opts.baseline_source, opts.baseline_build, work_dir, 'baseline'),
+            compile_driver(opts.source, opts.build, work_dir, 'new')]
+
+    status = 0
+    for title, args in [('250 m window around IP5', ['IP5', '250', '0']), ('full ring', ['IP5', '-1', '0'])]:
+        (time_base, dump_base), (time_new, dump_new) = [run(exe, path, args, opts.runs) for exe in exes]
+        identical = dump_base == dump_new
+        status |= not identical
+        print('%-24s baseline: %8.3f s, new: %8.3f s (x%.1f), beamlines %s' % (
+            title + ':', time_base, time_new, time_base / time_new, 'identical' if identical else 'DIFFERENT'))
+    shutil.rmtree(work_dir)
+    return status
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,88 @@
+#ifndef Hector_test_fixtures_h
+#define Hector_test_fixtures_h
+
+#include "Hector/Beamline.h"
+
+#include "Hector/Apertures/Circular.h"
+#include "Hector/Elements/Collimator.h"
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Marker.h"
+#include "Hector/Elements/Quadrupole.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace hector {
+  /// Common utilitaries for the unit tests
+  namespace test {
+    /// Build a 0.5 m-long collimator, with a circular aperture if a radius is given
+    inline element::ElementPtr collimator(const std::string& name, double s, double radius = 0.) {
+      auto coll = std::make_shared<element::Collimator>(name, s, 0.5);
+      if (radius > 0.)
+        coll->setAperture(std::make_shared<aperture::Circular>(radius));
+      return coll;
+    }
+
+    /// Builder for the short beamlines of the unit tests, starting with an "IP" marker at s = 0
+    class BeamlineFixture {
+    public:
+      /// \param[in] length Longitudinal length of the beamline (in m)
+      explicit BeamlineFixture(double length = 50.)
+          : ip_(std::make_shared<element::Marker>("IP", 0., 0.)), line_(length, ip_) {
+        line_.add(ip_);
+      }
+
+      /// Add any element to the beamline
+      BeamlineFixture& add(const element::ElementPtr& elem) {
+        line_.add(elem);
+        return *this;
+      }
+      /// Add a 3 m-long horizontal quadrupole
+      BeamlineFixture& horizontalQuadrupole(const std::string& name, double s, double k) {
+        return add(std::make_shared<element::HorizontalQuadrupole>(name, s, 3., k));
+      }
+      /// Add a 3 m-long vertical quadrupole
+      BeamlineFixture& verticalQuadrupole(const std::string& name, double s, double k) {
+        return add(std::make_shared<element::VerticalQuadrupole>(name, s, 3., k));
+      }
+      /// Add a sector dipole
+      BeamlineFixture& sectorDipole(const std::string& name, double s, double length, double k) {
+        return add(std::make_shared<element::SectorDipole>(name, s, length, k));
+      }
+      /// Add a 0.5 m-long collimator, with a circular aperture if a radius is given
+      BeamlineFixture& collimator(const std::string& name, double s, double radius = 0.) {
+        return add(test::collimator(name, s, radius));
+      }
+
+      /// Sequenced beamline, with all drifts between the elements
+      std::unique_ptr<Beamline> sequenced() const { return Beamline::sequencedBeamline(&line_); }
+
+    private:
+      element::ElementPtr ip_;
+      Beamline line_;
+    };
+
+    /// Collection of checks, reporting all failures
+    class Checks {
+    public:
+      Checks() : num_failed_(0) {}
+
+      /// Perform a check, and report its failure
+      /// \param[in] what Quantity being checked
+      void operator()(bool cond, const std::string& what) {
+        if (cond)
+          return;
+        std::cerr << "Invalid " << what << "." << std::endl;
+        ++num_failed_;
+      }
+      /// Number of failed checks
+      unsigned short numFailed() const { return num_failed_; }
+
+    private:
+      unsigned short num_failed_;
+    };
+  }  // namespace test
+}  // namespace hector
+
+#endif
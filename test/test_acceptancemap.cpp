@@ -0,0 +1,103 @@
+#include "Hector/AcceptanceMap.h"
+#include "Hector/Beamline.h"
+
+#include "Hector/Utils/Executor.h"
+
+#include "fixtures.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .sectorDipole("MB1", 20., 5., 1.e-5)
+                       .collimator("COLL", 40., 5.e-3)
+                       .sequenced();
+
+  typedef hector::AcceptanceMap::Variable Variable;
+  hector::AcceptanceMapBuilder builder(seq.get(), 45.);
+  builder.addAxis(Variable::xi, 5, 0., 0.1).addAxis(Variable::t, 4, 0., 2.).addAxis(Variable::phi, 4, -M_PI, M_PI);
+  builder.setParticlesPerCell(200).setSeed(42);
+
+  unsigned short num_failed = 0;
+  hector::Executor exec1(1), exec4(4);
+  const auto map = builder.build(exec4), map_seq = builder.build(exec1);
+  bool has_losses = false, has_survivors = false;
+  for (size_t i = 0; i < map.numCells(); ++i) {
+    const auto &cell = map.cell(i), &cell_seq = map_seq.cell(i);
+    if (cell.num_generated != cell_seq.num_generated || cell.num_accepted != cell_seq.num_accepted) {
+      std::cerr << "Cell " << i << ": result depends on the number of threads." << std::endl;
+      ++num_failed;
+    }
+    has_losses |= cell.num_accepted < cell.num_generated;
+    has_survivors |= cell.num_accepted > 0;
+    // lookups at the cell centre
+    const auto bins = map.cellBins(i);
+    std::vector<double> centre;
+    for (size_t j = 0; j < bins.size(); ++j)
+      centre.emplace_back(map.axes()[j].binCenter(bins[j]));
+    if (map.cellIndex(bins) != i || map.acceptance(centre) != cell.acceptance() ||
+        std::fabs(map.interpolate(centre) - cell.acceptance()) > 1.e-12) {
+      std::cerr << "Cell " << i << ": invalid lookup." << std::endl;
+      ++num_failed;
+    }
+  }
+  if (!has_losses || !has_survivors) {
+    std::cerr << "Trivial acceptance map." << std::endl;
+    ++num_failed;
+  }
+
+  // persistency: the stored map is reused as long as the settings are unchanged
+  const std::string path = "test_acceptancemap.hamp";
+  std::remove(path.c_str());
+  builder.build(path, exec4);
+  const auto stored = hector::AcceptanceMap::load(path);
+  if (stored.key() != builder.key() || stored.numCells() != map.numCells() || stored.axes().size() != 3) {
+    std::cerr << "Invalid map retrieved from file." << std::endl;
+    ++num_failed;
+  }
+  for (size_t i = 0; i < stored.numCells(); ++i)
+    if (stored.cell(i).num_accepted != map.cell(i).num_accepted)
+      ++num_failed;
+  const auto other_key = hector::AcceptanceMapBuilder(seq.get(), 30.).addAxis(Variable::xi, 5, 0., 0.1).key();
+  if (other_key == builder.key()) {
+    std::cerr << "Map key does not depend on the settings." << std::endl;
+    ++num_failed;
+  }
+
+  // invalid stored maps are reported without any exception, and rebuilt
+  const auto stored_size = std::ifstream(path, std::ios::binary | std::ios::ate).tellg();
+  const auto write_file = [&path](const std::string& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(content.data(), content.size());
+  };
+  std::string content;
+  {
+    std::ifstream file(path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  if (!hector::AcceptanceMap::check(path).empty()) {
+    std::cerr << "Valid map file rejected: " << hector::AcceptanceMap::check(path) << "." << std::endl;
+    ++num_failed;
+  }
+  for (const auto& corrupt : {std::string("HAMP\x01\x02\x03garb", 11), content.substr(0, content.size() - 5)}) {
+    write_file(corrupt);
+    if (hector::AcceptanceMap::check(path).empty()) {
+      std::cerr << "Corrupt map file of " << corrupt.size() << " bytes not detected." << std::endl;
+      ++num_failed;
+    }
+    const auto rebuilt = builder.build(path, exec4);
+    if (rebuilt.key() != builder.key() || rebuilt.numCells() != map.numCells() ||
+        std::ifstream(path, std::ios::binary | std::ios::ate).tellg() != stored_size) {
+      std::cerr << "Corrupt map file of " << corrupt.size() << " bytes not rebuilt." << std::endl;
+      ++num_failed;
+    }
+  }
+  std::remove(path.c_str());
+  std::cout << "Acceptance map: " << map.numCells() << " cells, " << num_failed << " failure(s)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include "Hector/Apertures/ApertureTable.h"
+#include "Hector/Apertures/Circular.h"
+#include "Hector/Apertures/Elliptic.h"
+#include "Hector/Apertures/RectElliptic.h"
+#include "Hector/Apertures/Rectangular.h"
+#include "Hector/Utils/BatchKernels.h"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main() {
+  using namespace hector::aperture;
+  using hector::TwoVector;
+  const std::vector<std::shared_ptr<ApertureBase> > apertures = {
+      std::make_shared<Rectangular>(2.e-3, 1.e-3, TwoVector(1.e-4, -2.e-4)),
+      std::make_shared<Elliptic>(1.5e-3, 2.5e-3, TwoVector(-3.e-4, 0.)),
+      std::make_shared<Circular>(2.e-3),
+      std::make_shared<RectElliptic>(1.8e-3, 1.2e-3, 2.e-3, 2.e-3, TwoVector(0., 5.e-4)),
+      // closed apertures (zero semi-axis)
+      std::make_shared<Elliptic>(0., 2.5e-3),
+      std::make_shared<Circular>(0.),
+      std::make_shared<RectElliptic>(1.8e-3, 1.2e-3, 2.e-3, 0.)};
+
+  // an odd number of positions, to also cover the partial vectors and bitmask words
+  const size_t num_pos = 1001;
+  std::mt19937_64 gen(42);
+  std::uniform_real_distribution<double> coord(-3.e-3, 3.e-3);
+  std::vector<double> x(num_pos), y(num_pos);
+  for (size_t k = 0; k < num_pos; ++k)
+    x[k] = coord(gen), y[k] = coord(gen);
+
+  unsigned short num_failed = 0;
+  std::vector<uint64_t> mask((num_pos + 63) / 64);
+  for (const auto& aper : apertures) {
+    const auto entry = ApertureTable::Entry::fromAperture(aper.get());
+    hector::kernel::apertureMask(entry, x.data(), y.data(), num_pos, mask.data());
+    size_t num_mismatches = 0;
+    for (size_t k = 0; k < num_pos; ++k) {
+      const bool expected = aper->contains(TwoVector(x[k], y[k]));
+      if (entry.contains(x[k], y[k]) != expected || (bool)((mask[k / 64] >> (k % 64)) & 1) != expected)
+        ++num_mismatches;
+    }
+    if (mask.back() >> (num_pos % 64) != 0)
+      ++num_mismatches;
+    if (num_mismatches > 0) {
+      std::cerr << "Aperture " << aper->type() << ": " << num_mismatches << " mismatch(es) with the reference."
+                << std::endl;
+      ++num_failed;
+    }
+  }
+
+  // closed apertures stop everything, including the particles on their centre
+  for (size_t i = apertures.size() - 3; i < apertures.size(); ++i) {
+    const auto& aper = apertures[i];
+    const auto entry = ApertureTable::Entry::fromAperture(aper.get());
+    if (aper->contains(aper->position()) || entry.contains(aper->x(), aper->y())) {
+      std::cerr << "Closed aperture " << aper->type() << " contains its centre." << std::endl;
+      ++num_failed;
+    }
+  }
+
+  // elements without restriction let everything pass
+  hector::kernel::apertureMask(ApertureTable::Entry::fromAperture(nullptr), x.data(), y.data(), num_pos, mask.data());
+  if (mask.front() != ~(uint64_t)0 || mask.back() != ((uint64_t)1 << (num_pos % 64)) - 1) {
+    std::cerr << "Invalid survival mask for an unrestricted element." << std::endl;
+    ++num_failed;
+  }
+
+  std::cout << "Aperture table tests (" << hector::kernel::instructionSet() << "): " << num_failed << " failure(s)."
+            << std::endl;
+  return num_failed;
+}
@@ -0,0 +1,49 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/ParticleBatch.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/BatchKernels.h"
+
+#include "fixtures.h"
+
+#include <iostream>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .sectorDipole("MB1", 30., 5., 1.e-4)
+                       .sequenced();
+
+  const double s_max = 45.;
+  hector::Propagator prop(seq.get());
+  hector::PropagationPlan plan(seq.get(), s_max);
+
+  hector::Particles parts;
+  for (unsigned short i = 0; i < 101; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.02 * (i % 5));
+    part.firstStateVector().setPosition(1.e-5 * i, -2.e-6 * i);
+    part.firstStateVector().setAngles(1.e-4 + 1.e-6 * i, 3.e-7 * i);
+    parts.emplace_back(part);
+  }
+  hector::ParticleBatch batch(parts);
+  prop.propagate(batch, plan);
+
+  unsigned short num_failed = 0;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    prop.propagate(parts[i], s_max);
+    const auto sv = parts[i].lastStateVector(), sv_batch = batch.stateVector(i);
+    if (sv.x() != sv_batch.x() || sv.Tx() != sv_batch.Tx() || sv.y() != sv_batch.y() || sv.Ty() != sv_batch.Ty() ||
+        parts[i].lastS() != batch.s()[i]) {
+      std::cerr << "Particle " << i << " differs:\n\t" << sv << "\n\t" << sv_batch << std::endl;
+      ++num_failed;
+    }
+  }
+  std::cout << "Batch propagation (" << hector::kernel::instructionSet() << "): " << num_failed << " mismatch(es) out of "
+            << parts.size() << " particles." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "Hector/Beamline.h"
+#include "Hector/Parameters.h"
+
+#include "Hector/Apertures/ApertureBase.h"
+#include "Hector/Elements/ElementBase.h"
+#include "Hector/IO/BeamlineCache.h"
+
+#include "fixtures.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+
+  // a small optics file, with an instrument inside each dipole to be split around it
+  const std::string path = "test_beamline_cache.tfs", cache_dir = "test_beamline_cache";
+  {
+    std::ofstream out(path);
+    out << "@ TITLE            %08s \"cached\"\n"
+        << "@ ENERGY           %le                 6500\n"
+        << "* NAME KEYWORD S L K0L K1L HKICK VKICK BETX BETY X Y DX DY APERTYPE APER_1 APER_2 APER_3 APER_4\n"
+        << "$ %s %s %le %le %le %le %le %le %le %le %le %le %le %le %s %le %le %le %le\n";
+    const auto line = [&](const std::string& name, const std::string& keyword, double s, double l, double k0l,
+                          double k1l, const std::string& aper, double aper_1) {
+      out << " \"" << name << "\" \"" << keyword << "\" " << s << " " << l << " " << k0l << " " << k1l
+          << " 0 0 120.5 95.25 1.e-4 0 0.1 0 \"" << aper << "\" " << aper_1 << " " << aper_1 << " " << aper_1 << " "
+          << aper_1 << "\n";
+    };
+    line("IP5", "MARKER", 0., 0., 0., 0., "NONE", 0.);
+    for (unsigned short i = 0; i < 20; ++i) {
+      const double s = i * 25.;
+      const auto id = std::to_string(i);
+      line("MQ." + id, "QUADRUPOLE", s + 3., 3., 0., (i % 2 == 0) ? 0.01 : -0.01, "CIRCLE", 0.02);
+      line("MB." + id, "SBEND", s + 10., 10., 1.e-4, 0., "RECTELLIPSE", 0.03);
+      line("BPM." + id, "INSTRUMENT", s + 15., 0., 0., 0., "NONE", 0.);
+    }
+  }
+
+  hector::test::Checks check;
+
+  const hector::io::BeamlineCache cache(cache_dir);
+  const auto parsed = cache.load(path, "IP5", 250.);
+  check(!parsed.cached, "first retrieval");
+
+  hector::Parameters::get()->setBeamEnergy(1.);
+  const auto start = std::chrono::steady_clock::now();
+  const auto cached = cache.load(path, "IP5", 250.);
+  const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  check(cached.cached, "second retrieval");
+  check(hector::Parameters::get()->beamEnergy() == 6500., "beam energy");
+  check(cached.header_strings == parsed.header_strings && cached.header_floats == parsed.header_floats,
+        "header variables");
+
+  // the retrieved beamline must be identical to the parsed one
+  const auto &bl_parsed = *parsed.beamline, &bl_cached = *cached.beamline;
+  check(bl_cached.maxLength() == bl_parsed.maxLength(), "beamline length");
+  check(bl_cached.interactionPoint() && bl_cached.interactionPoint()->name() == "IP5", "interaction point");
+  check(bl_cached.elements().size() == bl_parsed.elements().size(), "number of elements");
+  size_t num_split = 0;
+  for (size_t i = 0; i < std::min(bl_cached.elements().size(), bl_parsed.elements().size()); ++i) {
+    const auto &elem = *bl_cached.elements().at(i), &ref = *bl_parsed.elements().at(i);
+    check(elem == ref, "element " + ref.name());
+    check(elem.beta() == ref.beta() && elem.dispersion() == ref.dispersion() &&
+              elem.relativePosition() == ref.relativePosition(),
+          "optical functions of " + ref.name());
+    check((elem.aperture() != nullptr) == (ref.aperture() != nullptr) &&
+              (!ref.aperture() || *elem.aperture() == *ref.aperture()),
+          "aperture of " + ref.name());
+    if (ref.parentElement()) {
+      check(elem.parentElement() && elem.parentElement()->name() == ref.parentElement()->name(),
+            "parent of " + ref.name());
+      ++num_split;
+    }
+  }
+  check(num_split > 0, "number of split elements");
+
+  // any other parsing option is a distinct entry
+  check(!cache.load(path, "IP5", 200.).cached, "retrieval with other options");
+
+  // a damaged entry is reported and rebuilt from the Twiss file
+  const auto entry_path = cache.path(hector::io::BeamlineCache::key(path, "IP5", 250., 0.));
+  std::string content;
+  {
+    std::ifstream in(entry_path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  std::ofstream(entry_path, std::ios::binary) << content.substr(0, content.size() / 2);
+  const auto rebuilt = cache.load(path, "IP5", 250.);
+  check(!rebuilt.cached && rebuilt.beamline->elements().size() == bl_parsed.elements().size(),
+        "retrieval of a damaged entry");
+  check(cache.load(path, "IP5", 250.).cached, "retrieval of a rebuilt entry");
+
+  // concurrent population of a single entry
+  std::vector<std::thread> jobs;
+  std::vector<char> valid(8, 0);
+  for (size_t i = 0; i < valid.size(); ++i)
+    jobs.emplace_back([&, i]() {
+      const auto entry = cache.load(path, "IP5", 150.);
+      valid[i] = entry.beamline && entry.beamline->elements().size() > 0;
+    });
+  for (auto& job : jobs)
+    job.join();
+  check(std::count(valid.begin(), valid.end(), 1) == (long)valid.size(), "concurrent retrievals");
+
+  // only the three complete entries remain
+  size_t num_entries = 0;
+  if (auto* dir = opendir(cache_dir.c_str())) {
+    while (auto* ent = readdir(dir)) {
+      const std::string name = ent->d_name;
+      if (name == "." || name == "..")
+        continue;
+      check(name.find(".tmp.") == std::string::npos, "temporary file removal");
+      ++num_entries;
+      std::remove((cache_dir + "/" + name).c_str());
+    }
+    closedir(dir);
+  }
+  check(num_entries == 3, "number of cache entries");
+  rmdir(cache_dir.c_str());
+  std::remove(path.c_str());
+
+  std::cout << "Beamline cache retrieval: " << duration * 1.e3 << " ms, " << check.numFailed() << " failure(s)."
+            << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
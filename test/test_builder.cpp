@@ -0,0 +1,90 @@
+#include "Hector/Beamline.h"
+#include "Hector/BeamlineBuilder.h"
+#include "Hector/Parameters.h"
+
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Drift.h"
+#include "Hector/Elements/Marker.h"
+#include "Hector/Elements/Quadrupole.h"
+#include "Hector/Utils/String.h"
+
+#include "fixtures.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace hector;
+
+namespace {
+  /// A list of elements with instruments and quadrupoles inside dipoles, to be split around them
+  element::Elements elements() {
+    element::Elements out;
+    out.emplace_back(std::make_shared<element::Marker>("IP5", 0.));
+    for (unsigned short i = 0; i < 50; ++i) {
+      const double s = i * 20.;
+      const auto id = std::to_string(i);
+      out.emplace_back(std::make_shared<element::HorizontalQuadrupole>("MQ." + id, s + 2., 3., 0.01));
+      out.emplace_back(std::make_shared<element::SectorDipole>("MB." + id, s + 6., 10., 1.e-4));
+      out.emplace_back(std::make_shared<element::Drift>("BPM." + id, element::anInstrument, s + 9., 0.));
+      if (i % 3 == 0)
+        out.emplace_back(std::make_shared<element::VerticalQuadrupole>("MQS." + id, s + 11., 2., 0.02));
+      out.emplace_back(std::make_shared<element::Marker>("M." + id, s + 18.));
+    }
+    return out;
+  }
+}  // namespace
+
+int main() {
+  Parameters::get()->setLoggingThreshold(ExceptionType::fatal);
+
+  hector::test::Checks check;
+  const auto compare = [&check](const Beamline& bl, const Beamline& ref, const std::string& what) {
+    check(bl.elements().size() == ref.elements().size(), what + " number of elements");
+    for (size_t i = 0; i < std::min(bl.elements().size(), ref.elements().size()); ++i) {
+      const auto &elem = *bl.elements().at(i), &ref_elem = *ref.elements().at(i);
+      check(elem.name() == ref_elem.name() && elem.s() == ref_elem.s() && elem.length() == ref_elem.length(),
+            what + " element " + ref_elem.name());
+      check((elem.parentElement() != nullptr) == (ref_elem.parentElement() != nullptr) &&
+                (!ref_elem.parentElement() || elem.parentElement()->name() == ref_elem.parentElement()->name()),
+            what + " parent of " + ref_elem.name());
+    }
+  };
+
+  // element-by-element construction
+  Beamline ref(1000.);
+  const auto ref_elems = elements();
+  for (const auto& elem : ref_elems)
+    ref.add(elem);
+  ref.add(ref_elems.front());  // already added
+  ref.setInteractionPoint(ref_elems.front());
+
+  // bulk construction, from an unordered list of elements
+  Beamline bl(1000.);
+  auto elems = elements();
+  std::reverse(elems.begin() + 1, elems.end());
+  BeamlineBuilder builder(bl);
+  for (const auto& elem : elems)
+    builder.add(elem);
+  builder.add(elems.front());
+  builder.build();
+  bl.setInteractionPoint(elems.front());
+  compare(bl, ref, "bulk");
+
+  // sequenced beamline, with all drifts inserted in the same pass
+  Beamline ref_seq(ref, false);
+  double pos = 0.;
+  for (const auto& elem : ref) {
+    if (elem->type() == element::aMarker && elem->name() != "IP5")
+      continue;
+    if (elem->s() > pos)
+      ref_seq.add(std::make_shared<element::Drift>(format("drift:%.4E", pos), pos, elem->s() - pos));
+    ref_seq.add(elem);
+    pos = elem->s() + elem->length();
+  }
+  compare(*Beamline::sequencedBeamline(&bl), ref_seq, "sequenced");
+
+  std::cout << "Beamline builder: " << bl.elements().size() << " elements, " << check.numFailed() << " failure(s)."
+            << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+
+#include "Hector/IO/ColumnarFile.h"
+#include "Hector/Utils/BeamProducer.h"
+#include "Hector/Utils/Executor.h"
+
+#include "fixtures.h"
+
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .collimator("XRPH.A", 25.)
+                       .collimator("XRPH.B", 42.)
+                       .sequenced();
+
+  // a beam, and its hits at two Roman pots
+  hector::beam::GaussianParticleGun gun;
+  gun.smearX(0., 1.e-4);
+  gun.smearTx(0., 5.e-5);
+  gun.smearEnergy(hector::Parameters::get()->beamEnergy(), 0.);
+  hector::Particles parts;
+  for (unsigned short i = 0; i < 1000; ++i)
+    parts.emplace_back(gun.shoot());
+  const hector::ParticleBatch beam(parts);
+  hector::Propagator prop(seq.get());
+  prop.observationPlanes().addElements(*seq, "XRPH\\.");
+  hector::Executor exec(2);
+  const auto hits = prop.readout(parts, 45., exec);
+
+  // concurrent appends of chunks of particles
+  const std::string path = "test_columnar.hcol";
+  const unsigned short num_threads = 4, chunk_size = 100;
+  {
+    hector::io::ColumnarWriter writer(path, prop.observationPlanes());
+    std::vector<std::thread> threads;
+    for (unsigned short t = 0; t < num_threads; ++t)
+      threads.emplace_back([&, t]() {
+        for (size_t first = t * chunk_size; first < beam.size(); first += num_threads * chunk_size) {
+          std::vector<size_t> indices;
+          std::vector<uint64_t> event_ids;
+          std::vector<int32_t> pdg_ids;
+          hector::HitTable chunk_hits(chunk_size, hits.numPlanes());
+          for (size_t i = first; i < first + chunk_size; ++i) {
+            indices.emplace_back(i);
+            event_ids.emplace_back(i);
+            pdg_ids.emplace_back(2212);
+            for (size_t p = 0; p < hits.numPlanes(); ++p)
+              chunk_hits(i - first, p) = hits(i, p);
+          }
+          writer.append(beam.select(indices), &chunk_hits, event_ids.data(), pdg_ids.data());
+        }
+      });
+    for (auto& thr : threads)
+      thr.join();
+  }
+
+  unsigned short num_failed = 0;
+  const hector::io::ColumnarReader reader(path);
+  if (reader.numParticles() != beam.size() || reader.numChunks() != beam.size() / chunk_size ||
+      reader.planes().size() != 2 || reader.planes()[1].name != "XRPH.B") {
+    std::cerr << "Invalid file content." << std::endl;
+    ++num_failed;
+  }
+  hector::ParticleBatch read_beam;
+  reader.read(read_beam);
+  const auto read_hits = reader.hits();
+  size_t k = 0;
+  for (size_t c = 0; c < reader.numChunks(); ++c) {
+    const auto& chunk = reader.chunk(c);
+    for (size_t j = 0; j < chunk.size(); ++j, ++k) {
+      const size_t i = chunk.eventId()[j];
+      // zero-copy columns and batch copy
+      if (chunk.pdgId()[j] != 2212 || chunk.component(hector::StateVector::X)[j] != beam.x()[i] ||
+          read_beam.stateVector(k).vector() != beam.stateVector(i).vector() || read_beam.s()[k] != beam.s()[i] ||
+          read_beam.charge()[k] != beam.charge()[i]) {
+        std::cerr << "Particle " << i << ": invalid kinematics retrieved." << std::endl;
+        ++num_failed;
+      }
+      for (size_t p = 0; p < hits.numPlanes(); ++p) {
+        const auto &hit = hits(i, p), &read_hit = read_hits(k, p);
+        if (read_hit.status != hit.status || read_hit.x != hit.x || read_hit.ty != hit.ty ||
+            chunk.hitY(p)[j] != hit.y) {
+          std::cerr << "Particle " << i << ", plane " << p << ": invalid hit retrieved." << std::endl;
+          ++num_failed;
+        }
+      }
+    }
+  }
+  std::remove(path.c_str());
+  std::cout << "Columnar file: " << reader.numParticles() << " particles in " << reader.numChunks() << " chunks, "
+            << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+
+#include "fixtures.h"
+
+#include <iostream>
+#include <thread>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .sequenced();
+
+  const auto make_beam = [](double energy) {
+    hector::Particles parts;
+    for (unsigned short i = 0; i < 20; ++i) {
+      auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+      part.firstStateVector().setEnergy(energy * (1. - 0.01 * (i % 5)));
+      part.firstStateVector().setAngles(1.e-4 + 1.e-6 * i, -2.e-6 * i);
+      parts.emplace_back(part);
+    }
+    return parts;
+  };
+  const double energies[2] = {6500., 450.};
+
+  // reference: one beam energy at a time, through the global run parameters
+  hector::Particles ref_beams[2];
+  for (unsigned short i = 0; i < 2; ++i) {
+    hector::Parameters::get()->setBeamEnergy(energies[i]);
+    ref_beams[i] = make_beam(energies[i]);
+    hector::Propagator(seq.get()).propagate(ref_beams[i], 48.);
+  }
+
+  // both beam energies propagated concurrently, each with its own context
+  hector::Particles beams[2] = {make_beam(energies[0]), make_beam(energies[1])};
+  std::thread threads[2];
+  for (unsigned short i = 0; i < 2; ++i) {
+    auto ctx = hector::PropagationContext::fromParameters();
+    ctx.beam_energy = energies[i];
+    threads[i] = std::thread([&seq, &beams, ctx, i]() { hector::Propagator(seq.get(), ctx).propagate(beams[i], 48.); });
+  }
+  for (auto& thr : threads)
+    thr.join();
+
+  unsigned short num_failed = 0;
+  for (unsigned short i = 0; i < 2; ++i)
+    for (size_t j = 0; j < beams[i].size(); ++j)
+      if (beams[i][j].lastStateVector().vector() != ref_beams[i][j].lastStateVector().vector()) {
+        std::cerr << "Beam energy " << energies[i] << " GeV, particle " << j << ": mismatch with the reference."
+                  << std::endl;
+        ++num_failed;
+      }
+  if (beams[0][1].lastStateVector().x() == beams[1][1].lastStateVector().x()) {
+    std::cerr << "Beam energy has no effect on the propagation." << std::endl;
+    ++num_failed;
+  }
+  std::cout << "Concurrent propagation contexts: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/ParticleBatch.h"
+#include "Hector/Exception.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .collimator("RP", 28., 0.1)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  const double s_max = 48.;
+  hector::Propagator prop(seq.get());
+  hector::PropagationPlan plan(seq.get(), s_max), fused_plan(seq.get(), s_max);
+  fused_plan.setFusion(true);
+  fused_plan.addObservationPoint(41.);
+
+  // one run up to the aperture, the aperture itself, one run up to the observation point, the drift holding it,
+  // and a last run up to the end of the plan
+  const auto segments = fused_plan.segments(0., 0., hector::Parameters::get()->beamParticlesMass(), +1,
+                                            hector::PropagationContext::fromParameters());
+  unsigned short num_failed = 0;
+  if (segments->size() != 5) {
+    std::cerr << "Unexpected number of collapsed runs: " << segments->size() << " for " << plan.size()
+              << " elements." << std::endl;
+    ++num_failed;
+  }
+
+  for (unsigned short i = 0; i < 50; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.02 * (i % 5));
+    part.firstStateVector().setPosition(1.e-5 * i, -2.e-6 * i);
+    part.firstStateVector().setAngles(1.e-4 + 1.e-6 * i, 3.e-7 * i);
+    auto part_fused = part;
+    prop.propagate(part, plan);
+    prop.propagate(part_fused, fused_plan);
+    for (const double s : {28., 28.5, 41., s_max}) {
+      const auto sv = part.stateVectorAt(s), sv_fused = part_fused.stateVectorAt(s);
+      if (std::fabs(sv.x() - sv_fused.x()) > 1.e-12 || std::fabs(sv.Tx() - sv_fused.Tx()) > 1.e-12 ||
+          std::fabs(sv.y() - sv_fused.y()) > 1.e-12 || std::fabs(sv.Ty() - sv_fused.Ty()) > 1.e-12) {
+        std::cerr << "Particle " << i << " differs at s = " << s << " m:\n\t" << sv << "\n\t" << sv_fused << std::endl;
+        ++num_failed;
+      }
+    }
+  }
+  // concurrent batch propagations, with more energy losses than the collapsed runs memoised at once
+  hector::Particles parts;
+  for (unsigned short i = 0; i < 1000; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(1.e-4 * i);
+    part.firstStateVector().setAngles(1.e-4, -1.e-5);
+    parts.emplace_back(part);
+  }
+  hector::ParticleBatch ref_batch(parts);
+  prop.propagate(ref_batch, fused_plan);
+  std::vector<unsigned short> num_differ(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_differ.size(); ++t)
+    threads.emplace_back([&, t]() {
+      for (unsigned short rep = 0; rep < 5; ++rep) {
+        hector::ParticleBatch batch(parts);
+        prop.propagate(batch, fused_plan);
+        for (size_t i = 0; i < batch.size(); ++i)
+          if (batch.stateVector(i).x() != ref_batch.stateVector(i).x() || batch.s()[i] != ref_batch.s()[i] ||
+              batch.status()[i] != ref_batch.status()[i])
+            ++num_differ[t];
+      }
+    });
+  for (auto& thread : threads)
+    thread.join();
+  for (size_t t = 0; t < num_differ.size(); ++t)
+    if (num_differ[t] > 0) {
+      std::cerr << "Concurrent batch propagation " << t << ": " << num_differ[t] << " particle(s) differ." << std::endl;
+      ++num_failed;
+    }
+
+  std::cout << "Segments fusion: " << segments->size() << " runs for " << plan.size() << " elements, " << num_failed
+            << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
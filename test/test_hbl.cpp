@@ -0,0 +1,119 @@
+#include "Hector/Beamline.h"
+#include "Hector/Parameters.h"
+#include "Hector/PropagationPlan.h"
+
+#include "Hector/Apertures/RectElliptic.h"
+#include "Hector/Apertures/Rectangular.h"
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Marker.h"
+#include "Hector/Elements/Quadrupole.h"
+#include "Hector/IO/HBLFileHandler.h"
+#include "Hector/IO/HBLFileStructures.h"
+
+#include "fixtures.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  using namespace hector;
+
+  hector::test::Checks check;
+
+  // a beamline with all element properties set, a long element name, and an element split around an instrument
+  Beamline raw(100.);
+  auto ip = std::make_shared<element::Marker>("IP5", 0.);
+  raw.setInteractionPoint(ip);
+  raw.add(ip);
+  auto quad = std::make_shared<element::HorizontalQuadrupole>("MQXA.1R5", 20., 6.37, 0.0087);
+  quad->setAperture(std::make_shared<aperture::RectElliptic>(0.03, 0.025, 0.03, 0.03, TwoVector(1.e-4, 0.)));
+  quad->setBeta(TwoVector(1200.5, 850.25));
+  quad->setDispersion(TwoVector(0.01, -0.002));
+  quad->setRelativePosition(TwoVector(2.e-4, -1.e-4));
+  quad->setAngles(TwoVector(1.e-6, 2.e-6));
+  raw.add(quad);
+  const std::string long_name = "MBXW.A4R5.WITH.A.NAME.WELL.BEYOND.THE.FIFTY.CHARACTERS.OF.THE.FIRST.LAYOUT";
+  auto dipole = std::make_shared<element::SectorDipole>(long_name, 40., 10., 1.e-4);
+  dipole->setAperture(std::make_shared<aperture::Rectangular>(0.04, 0.02));
+  raw.add(dipole);
+  raw.add(std::make_shared<element::Drift>("BPM.5R5", element::anInstrument, 45., 0.));
+  const auto bl = Beamline::sequencedBeamline(&raw);
+
+  const std::string path = "test_hbl.hbl";
+  io::HBL::write(bl.get(), path, {{"title", "hbl"}}, {{"energy", 6500.f}});
+  check(io::HBL::valid(path), "file validation");
+
+  const io::HBL hbl(path);
+  const auto* bl_read = hbl.beamline();
+  check(bl_read->maxLength() == bl->maxLength(), "beamline length");
+  check(bl_read->interactionPoint() && bl_read->interactionPoint()->name() == "IP5", "interaction point");
+  check(hbl.headerStrings().at("title") == "hbl" && hbl.headerFloats().at("energy") == 6500.f, "header variables");
+  check(bl_read->elements().size() == bl->elements().size(), "number of elements");
+  size_t num_split = 0;
+  for (size_t i = 0; i < std::min(bl_read->elements().size(), bl->elements().size()); ++i) {
+    const auto &elem = *bl_read->elements().at(i), &ref = *bl->elements().at(i);
+    check(elem == ref, "element " + ref.name());
+    check(elem.beta() == ref.beta() && elem.dispersion() == ref.dispersion() &&
+              elem.relativePosition() == ref.relativePosition() && elem.angles() == ref.angles(),
+          "optical functions of " + ref.name());
+    check((elem.aperture() != nullptr) == (ref.aperture() != nullptr) &&
+              (!ref.aperture() || *elem.aperture() == *ref.aperture()),
+          "aperture of " + ref.name());
+    if (ref.parentElement()) {
+      check(elem.parentElement() && elem.parentElement()->name() == ref.parentElement()->name(),
+            "parent of " + ref.name());
+      ++num_split;
+    }
+    // records are accessible in place
+    check(hbl.name(hbl.record(i)) == ref.name() && hbl.record(i).element_s == ref.s(), "record of " + ref.name());
+  }
+  check(num_split == 1, "number of split elements");
+
+  // a plan compiled from the stored beamline is identical
+  const PropagationPlan plan(bl.get(), 100.), plan_read(bl_read, 100.);
+  check(plan_read.size() == plan.size(), "propagation plan size");
+  for (size_t i = 0; i < std::min(plan.size(), plan_read.size()); ++i)
+    check(plan_read[i].kernel == plan[i].kernel && plan_read[i].aperture == plan[i].aperture &&
+              plan_read[i].k == plan[i].k,
+          "propagation plan record " + plan.name(plan[i]));
+
+  // a validated mapping is parsed in place
+  {
+    MappedFile file(path);
+    check(io::HBL::check(file).empty(), "mapped file validation");
+    const io::HBL hbl_mapped(std::move(file));
+    check(hbl_mapped.beamline()->elements().size() == bl->elements().size() &&
+              hbl_mapped.headerStrings() == hbl.headerStrings(),
+          "parsing of a mapped file");
+  }
+
+  // corrupted files are detected
+  std::string content;
+  {
+    std::ifstream in(path, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  const auto store = [&path](const std::string& data) { std::ofstream(path, std::ios::binary) << data; };
+  auto corrupted = content;
+  corrupted[sizeof(io::HBLHeaderV2) + 24] ^= 0x10;
+  store(corrupted);
+  check(!io::HBL::valid(path), "corrupted file validation");
+  store(content.substr(0, content.size() - 8));
+  check(!io::HBL::valid(path), "truncated file validation");
+  std::remove(path.c_str());
+
+  // first layout elements copy
+  io::HBLElement el;
+  el.aperture_p1 = 1.;
+  el.aperture_p2 = 2.;
+  check(io::HBLElement(el).aperture_p2 == 2., "first layout element copy");
+
+  std::cout << "HBL files: " << bl->elements().size() << " elements, " << check.numFailed() << " failure(s)."
+            << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include "Hector/IO/HepMCHandler.h"
+
+#ifdef HEPMC
+#include "HepMC/Version.h"
+#ifdef HEPMC_VERSION_CODE  // HepMC v3+
+#define GOOD_HEPMC
+#include "HepMC/Attribute.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenParticle.h"
+#include "HepMC/GenVertex.h"
+#include "HepMC/ReaderAscii.h"
+#include "HepMC/WriterAscii.h"
+
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#endif
+#endif
+
+#include <iostream>
+
+int main() {
+  unsigned short num_failed = 0;
+
+  // electric charge retrieved from the PDG numbering scheme
+  const struct {
+    int pdg_id, charge;
+  } particles[] = {
+      {2212, +1},        // proton
+      {-2212, -1},       // antiproton
+      {2112, 0},         // neutron
+      {3122, 0},         // lambda
+      {3222, +1},        // sigma+
+      {211, +1},         // pi+
+      {111, 0},          // pi0
+      {321, +1},         // K+
+      {-321, -1},        // K-
+      {411, +1},         // D+
+      {521, +1},         // B+
+      {11, -1},          // electron
+      {-13, +1},         // antimuon
+      {22, 0},           // photon
+      {1000822080, 82},  // lead nucleus
+  };
+  for (const auto& part : particles)
+    if (hector::io::HepMC::charge(part.pdg_id) != part.charge) {
+      std::cerr << "Invalid charge for PDG id " << part.pdg_id << ": " << hector::io::HepMC::charge(part.pdg_id)
+                << " != " << part.charge << "." << std::endl;
+      ++num_failed;
+    }
+  std::cout << "HepMC particles charge: " << num_failed << " failure(s)." << std::endl;
+
+#ifdef GOOD_HEPMC
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .collimator("COLL", 30., 1.e-3)
+                       .sequenced();
+  hector::ObservationPlanes planes;
+  planes.add("RP1", 25.);
+  planes.add("RP2", 40.);
+  const double s_max = 45.;
+
+  // each event holds two beam protons, two mirrored forward protons, a forward neutron, and a central pion
+  const std::string input = "test_hepmc_input.hepmc", output = "test_hepmc_output.hepmc";
+  const double energy = hector::Parameters::get()->beamEnergy(), mass = hector::Parameters::get()->beamParticlesMass();
+  const unsigned short num_events = 50;
+  {
+    ::HepMC::WriterAscii writer(input);
+    for (unsigned short i = 0; i < num_events; ++i) {
+      ::HepMC::GenEvent evt(::HepMC::Units::GEV, ::HepMC::Units::MM);
+      evt.set_event_number(i);
+      const auto particle = [](double px, double pz, double e, int pdg_id, int status) {
+        return std::make_shared<::HepMC::GenParticle>(::HepMC::FourVector(px, 0., pz, e), pdg_id, status);
+      };
+      const double beam_pz = std::sqrt(energy * energy - mass * mass);
+      const double e = energy * (1. - 0.01 * (i % 5)), p = std::sqrt(e * e - mass * mass), tx = 4.e-5 * (i % 7 - 3);
+      auto vtx = std::make_shared<::HepMC::GenVertex>();
+      vtx->add_particle_in(particle(0., +beam_pz, energy, 2212, 4));
+      vtx->add_particle_in(particle(0., -beam_pz, energy, 2212, 4));
+      vtx->add_particle_out(particle(+p * tx, +p, e, 2212, 1));
+      vtx->add_particle_out(particle(-p * tx, -p, e, 2212, 1));
+      vtx->add_particle_out(particle(+p * tx, +p, e, 2112, 1));
+      vtx->add_particle_out(particle(1., 0.1, std::sqrt(1.01 + 0.139 * 0.139), 211, 1));
+      evt.add_vertex(vtx);
+      writer.write_event(evt);
+    }
+    writer.close();
+  }
+
+  hector::io::HepMC proc(input, output);
+  proc.setBeamline(hector::io::HepMC::Arm::positive, seq.get(), s_max, planes)
+      .setBeamline(hector::io::HepMC::Arm::negative, seq.get(), s_max, planes)
+      .setMinAbsEta(5.)
+      .setNumWorkers(4)
+      .setBatchSize(3)
+      .setQueueSize(2);
+  const auto num_written = proc.run();
+
+  // reference readout, with the backward particles expressed in the frame of their own beam
+  hector::Propagator ref_prop(seq.get());
+  ref_prop.setRecording(hector::Propagator::Recording::observationPlanes);
+  ref_prop.observationPlanes() = planes;
+  const hector::PropagationPlan plan(seq.get(), s_max);
+  std::vector<hector::HitTable::Hit> ref_hits(planes.size());
+
+  hector::test::Checks check;
+  check(num_written == num_events, "number of events written");
+  ::HepMC::ReaderAscii reader(output);
+  ::HepMC::GenEvent evt;
+  unsigned short num_read = 0, num_propagated = 0, num_mirrored = 0;
+  while (reader.read_event(evt) && !reader.failed()) {
+    check(evt.event_number() == num_read++, "events ordering");
+    std::vector<double> positive_x, negative_x;
+    for (const auto& gen_part : evt.particles()) {
+      const auto& mom = gen_part->momentum();
+      const auto status = gen_part->attribute<::HepMC::IntAttribute>("hector_status");
+      const bool selected = gen_part->status() == 1 && std::fabs(mom.eta()) >= 5. && gen_part->pid() == 2212;
+      check((status != nullptr) == selected, "selection of particle " + std::to_string(gen_part->pid()));
+      if (!selected || !status)
+        continue;
+      ++num_propagated;
+      const double sign = (mom.pz() > 0.) ? +1. : -1.;
+      hector::Particle part(hector::LorentzVector(sign * mom.px(), mom.py(), sign * mom.pz(), mom.e()), +1, 2212);
+      const auto result = ref_prop.readout(part, plan, ref_hits.data());
+      check(status->value() == (int)result.status(), "propagation status");
+      for (size_t k = 0; k < planes.size(); ++k) {
+        const auto x = gen_part->attribute<::HepMC::DoubleAttribute>("hector_" + planes[k].name + "_x");
+        const bool reached = ref_hits[k].status == hector::HitTable::Status::reached;
+        check((x != nullptr) == reached, "hit at " + planes[k].name);
+        if (!x || !reached)
+          continue;
+        // attributes may be stored with a fixed number of decimals
+        check(std::fabs(x->value() - ref_hits[k].x) < 1.e-6, "horizontal position at " + planes[k].name);
+        (sign > 0. ? positive_x : negative_x).emplace_back(x->value());
+      }
+    }
+    // mirrored protons hit both arms at the same position
+    check(positive_x == negative_x, "arms flip");
+    num_mirrored += !positive_x.empty();
+  }
+  reader.close();
+  check(num_read == num_events, "number of events read back");
+  check(num_mirrored > 0, "number of hits");
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+  num_failed += check.numFailed();
+  std::cout << "HepMC events processing: " << num_read << " events, " << num_propagated << " particles propagated, "
+            << check.numFailed() << " failure(s)." << std::endl;
+#endif
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/TransferMapTable.h"
+#include "Hector/Exception.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <iostream>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .collimator("RP", 28., 0.1)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  const double s_max = 48.;
+  hector::Propagator prop(seq.get());
+  hector::PropagationPlan plan(seq.get(), s_max);
+  plan.setFusion(true);
+  hector::TransferMapTable table(plan, 0., 0.1, 1.e-3, 2);
+
+  unsigned short num_failed = 0;
+  for (const auto interp : {hector::TransferMapTable::Interpolation::linear,
+                            hector::TransferMapTable::Interpolation::cubic}) {
+    table.setInterpolation(interp);
+    const double tolerance = (interp == hector::TransferMapTable::Interpolation::linear) ? 1.e-8 : 1.e-11;
+    std::cout << "Transfer maps table (" << interp << " interpolation): " << table.accuracy() << std::endl;
+
+    for (unsigned short i = 0; i < 50; ++i) {
+      auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+      part.firstStateVector().setXi(0.0019 * i + 1.3e-5);
+      part.firstStateVector().setPosition(1.e-5 * i, -2.e-6 * i);
+      part.firstStateVector().setAngles(1.e-4 + 1.e-6 * i, 3.e-7 * i);
+      auto part_table = part;
+      prop.propagate(part, plan);
+      prop.propagate(part_table, table);
+      const auto sv = part.lastStateVector(), sv_table = part_table.lastStateVector();
+      if (part.lastS() != part_table.lastS() || std::fabs(sv.x() - sv_table.x()) > tolerance ||
+          std::fabs(sv.Tx() - sv_table.Tx()) > tolerance || std::fabs(sv.y() - sv_table.y()) > tolerance ||
+          std::fabs(sv.Ty() - sv_table.Ty()) > tolerance) {
+        std::cerr << "Particle " << i << " differs (" << interp << " interpolation):\n\t" << sv << "\n\t" << sv_table
+                  << std::endl;
+        ++num_failed;
+      }
+    }
+  }
+  std::cout << "Transfer maps table: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
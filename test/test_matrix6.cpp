@@ -0,0 +1,87 @@
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Drift.h"
+#include "Hector/Elements/Kicker.h"
+#include "Hector/Elements/Quadrupole.h"
+#include "Hector/Utils/Matrix6.h"
+
+#include "fixtures.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace hector;
+
+namespace {
+  /// Element-by-element (bitwise) comparison of a fixed-size matrix with its algebraic counterpart
+  bool identical(const Matrix6& mat6, const Matrix& mat) {
+    if (mat.num_row() != 6 || mat.num_col() != 6)
+      return false;
+    for (size_t i = 0; i < 6; ++i)
+      for (size_t j = 0; j < 6; ++j)
+        if (mat6(i, j) != mat(i + 1, j + 1))
+          return false;
+    return true;
+  }
+  /// Component-by-component (bitwise) comparison of a fixed-size vector with its algebraic counterpart
+  bool identical(const Vector6& vec6, const Vector& vec) {
+    if (vec.num_row() != 6)
+      return false;
+    for (size_t i = 0; i < 6; ++i)
+      if (vec6[i] != vec[i])
+        return false;
+    return true;
+  }
+}  // namespace
+
+int main() {
+  Parameters::get()->setLoggingThreshold(ExceptionType::fatal);
+  const auto ctx = PropagationContext::fromParameters();
+  const double mp = ctx.beam_mass;
+  const int qp = ctx.beam_charge;
+
+  hector::test::Checks check;
+
+  // identity and drift builders
+  check(identical(Matrix6::identity(), DiagonalMatrix(6, 1)), "identity matrix");
+  for (const double length : {0., 1.e-3, 2.5, 125.}) {
+    Matrix drift = DiagonalMatrix(6, 1);
+    drift(1, 2) = drift(3, 4) = length;
+    check(identical(Matrix6::drift(length), drift), "drift matrix for length " + std::to_string(length));
+  }
+
+  // transfer matrices of all element types, with and without energy loss
+  const std::vector<std::shared_ptr<element::ElementBase> > elements = {
+      std::make_shared<element::Drift>("DRIFT", 0., 3.2),
+      std::make_shared<element::HorizontalQuadrupole>("MQH", 5., 3.1, -0.013),
+      std::make_shared<element::VerticalQuadrupole>("MQV", 10., 2.9, +0.011),
+      std::make_shared<element::SectorDipole>("MBS", 15., 9.4, 3.5e-4),
+      std::make_shared<element::RectangularDipole>("MBR", 25., 9.4, -2.7e-4),
+      std::make_shared<element::HorizontalKicker>("MCH", 35., 0.6, 1.2e-5),
+      std::make_shared<element::VerticalKicker>("MCV", 37., 0.6, -0.8e-5)};
+  const Vector6 state6(1.2e-4, -3.1e-5, -0.7e-4, 4.4e-5, 0.03, 1.);
+  const Vector state = state6.toVector();
+  for (const double eloss : {0., 50., 210.}) {
+    auto total6 = Matrix6::identity();
+    Matrix total = DiagonalMatrix(6, 1);
+    for (const auto& elem : elements) {
+      const std::string what = elem->name() + " with energy loss " + std::to_string(eloss);
+      const auto mat6 = elem->matrix(eloss, mp, qp, ctx);
+      const auto mat = mat6.toMatrix();
+      check(identical(mat6, mat) && Matrix6(mat) == mat6, "conversion of the " + what + " matrix");
+      // matrix-matrix and matrix-vector products
+      total6 = mat6 * total6;
+      total = mat * total;
+      check(identical(total6, total), "matrix product with the " + what + " matrix");
+      check(identical(mat6 * state6, mat * state), "vector product with the " + what + " matrix");
+    }
+    // full chain applied to a vector
+    check(identical(total6 * state6, total * state), "vector product with the full chain");
+  }
+  check(Vector6(state) == state6, "vector conversion");
+
+  std::cout << "Fixed-size matrices: " << elements.size() << " element types, " << check.numFailed()
+            << " failure(s)." << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#include "Hector/Elements/MatrixCache.h"
+#include "Hector/Elements/Quadrupole.h"
+
+#include "fixtures.h"
+
+#include <iostream>
+#include <thread>
+
+using namespace hector;
+
+int main() {
+  Parameters::get()->setLoggingThreshold(ExceptionType::fatal);
+  const auto ctx = PropagationContext::fromParameters();
+  const double mp = ctx.beam_mass;
+  const int qp = ctx.beam_charge;
+
+  hector::test::Checks check;
+  element::HorizontalQuadrupole quad("MQ", 10., 3., -0.01);
+  auto& cache = element::MatrixCache::local();
+  cache.clear();
+  cache.resetCounters();
+
+  // repeated keys are stored on their second request, and retrieved afterwards
+  const auto ref = quad.matrix(0., mp, qp, ctx);
+  for (unsigned short i = 0; i < 5; ++i)
+    check(quad.cachedMatrix(0., mp, qp, ctx) == ref, "cached matrix");
+  check(cache.misses() == 2 && cache.hits() == 3 && cache.size() == 1, "hits/misses for a repeated key");
+
+  // non-repeating keys (continuous energy loss) bypass the cache
+  cache.resetCounters();
+  for (unsigned short i = 1; i <= 100; ++i)
+    check(quad.cachedMatrix(1.e-3 * i, mp, qp, ctx) == quad.matrix(1.e-3 * i, mp, qp, ctx), "uncached matrix");
+  check(cache.misses() == 100 && cache.hits() == 0 && cache.size() == 1, "hits/misses for non-repeating keys");
+
+  // another run parameters snapshot is another key
+  auto other_ctx = ctx;
+  other_ctx.beam_energy *= 0.5;
+  cache.resetCounters();
+  check(quad.cachedMatrix(0., mp, qp, other_ctx) == quad.matrix(0., mp, qp, other_ctx) && cache.misses() == 1,
+        "matrix for another run parameters snapshot");
+
+  // a change of the element properties invalidates its matrices
+  quad.setLength(2.);
+  const auto ref_length = quad.matrix(0., mp, qp, ctx);
+  check(!(ref_length == ref), "matrix for another length");
+  for (unsigned short i = 0; i < 3; ++i)
+    check(quad.cachedMatrix(0., mp, qp, ctx) == ref_length, "cached matrix after a length change");
+  quad.setMagneticStrength(-0.02);
+  const auto ref_strength = quad.matrix(0., mp, qp, ctx);
+  check(!(ref_strength == ref_length), "matrix for another strength");
+  for (unsigned short i = 0; i < 3; ++i)
+    check(quad.cachedMatrix(0., mp, qp, ctx) == ref_strength, "cached matrix after a strength change");
+
+  // a copy of the element never shares the matrices of its source once modified
+  element::HorizontalQuadrupole copy(quad);
+  copy.setMagneticStrength(-0.03);
+  check(copy.cachedMatrix(0., mp, qp, ctx) == copy.matrix(0., mp, qp, ctx), "matrix of a modified copy");
+
+  // each thread holds its own cache
+  size_t other_size = 0;
+  std::thread([&other_size]() { other_size = element::MatrixCache::local().size(); }).join();
+  check(other_size == 0 && cache.size() > 0, "per-thread caches");
+
+  std::cout << "Transfer matrices cache: " << cache.size() << " matrices, " << check.numFailed() << " failure(s)."
+            << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/Executor.h"
+
+#include "fixtures.h"
+
+#include <iostream>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .sectorDipole("MB1", 30., 5., 1.e-4)
+                       .sequenced();
+
+  const double s_max = 45.;
+  hector::Propagator prop(seq.get());
+
+  hector::Particles ref;
+  for (unsigned short i = 0; i < 1000; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(1.e-4 * i);
+    part.firstStateVector().setPosition(1.e-6 * i, -2.e-7 * i);
+    part.firstStateVector().setAngles(1.e-4 + 1.e-7 * i, 3.e-8 * i);
+    ref.emplace_back(part);
+  }
+  hector::Particles serial = ref;
+  prop.propagate(serial, s_max);
+
+  unsigned short num_failed = 0;
+  for (unsigned short num_threads : {1, 2, 4, 8}) {
+    hector::Particles parallel = ref;
+    const auto results = prop.propagate(parallel, s_max, num_threads);
+    for (size_t i = 0; i < parallel.size(); ++i) {
+      const auto sv = serial[i].lastStateVector(), sv_par = parallel[i].lastStateVector();
+      if (!results[i].success() || sv.x() != sv_par.x() || sv.Tx() != sv_par.Tx() || sv.y() != sv_par.y() ||
+          sv.Ty() != sv_par.Ty() || serial[i].positions().size() != parallel[i].positions().size()) {
+        std::cerr << "Particle " << i << " differs with " << num_threads << " thread(s):\n\t" << sv << "\n\t" << sv_par
+                  << std::endl;
+        ++num_failed;
+      }
+    }
+  }
+  std::cout << "Parallel propagation: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
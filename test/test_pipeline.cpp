@@ -0,0 +1,89 @@
+#include "Hector/Beamline.h"
+#include "Hector/Pipeline.h"
+
+#include "Hector/Utils/BeamProducer.h"
+
+#include "fixtures.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .collimator("COLL", 30., 1.e-3)
+                       .sequenced();
+
+  // each event holds three particles from reproducible random streams
+  hector::beam::GaussianParticleGun gun;
+  gun.smearX(0., 5.e-4);
+  gun.smearTx(0., 2.e-5);
+  gun.smearEnergy(hector::Parameters::get()->beamEnergy(), 0.);
+  const uint64_t num_events = 500;
+  std::atomic<uint64_t> num_generated(0);  // also read by the sink
+  const auto source = [&gun, &num_generated](hector::Particles& parts) {
+    if (num_generated == num_events)
+      return false;
+    for (uint32_t i = 0; i < 3; ++i)
+      parts.emplace_back(gun.shoot(num_generated, i));
+    ++num_generated;
+    return true;
+  };
+
+  unsigned short num_failed = 0;
+  const hector::Propagator ref_prop(seq.get());
+  hector::Pipeline pipeline(seq.get(), 45.);
+  pipeline.setNumWorkers(4).setBatchSize(7).setQueueSize(4).setOrdered(true);
+  uint64_t next_event = 0, num_stopped = 0;
+  const auto num_processed = pipeline.run(source, [&](hector::Pipeline::Event& evt) {
+    if (evt.number != next_event++) {
+      std::cerr << "Event " << evt.number << " received out of order." << std::endl;
+      ++num_failed;
+    }
+    // at most (queue size + number of workers) batches of 7 events in flight
+    if (num_generated > evt.number + (4 + 4) * 7) {
+      std::cerr << "Event " << evt.number << " consumed after " << num_generated << " events generated." << std::endl;
+      ++num_failed;
+    }
+    for (size_t i = 0; i < evt.particles.size(); ++i) {
+      auto ref = gun.shoot(evt.number, i);
+      const auto result = ref_prop.track(ref, 45.);
+      num_stopped += (evt.results[i].status() == hector::PropagationResult::Status::stopped);
+      if (result.status() != evt.results[i].status() ||
+          ref.lastStateVector().vector() != evt.particles[i].lastStateVector().vector()) {
+        std::cerr << "Event " << evt.number << ", particle " << i << ": inconsistent propagation." << std::endl;
+        ++num_failed;
+      }
+    }
+  });
+  if (num_processed != num_events || next_event != num_events || num_stopped == 0) {
+    std::cerr << "Invalid number of processed events: " << num_processed << "." << std::endl;
+    ++num_failed;
+  }
+
+  // unordered processing, with a maximal number of events
+  num_generated = 0;
+  std::vector<bool> seen(num_events, false);
+  pipeline.setOrdered(false).setMaxEvents(100).setRecording(hector::Propagator::Recording::finalState);
+  if (pipeline.run(source, [&seen](hector::Pipeline::Event& evt) { seen.at(evt.number) = true; }) != 100 ||
+      std::count(seen.begin(), seen.end(), true) != 100) {
+    std::cerr << "Invalid unordered processing." << std::endl;
+    ++num_failed;
+  }
+
+  // failures are propagated to the caller
+  try {
+    pipeline.run([](hector::Particles&) -> bool { throw std::runtime_error("Source failure."); },
+                 [](hector::Pipeline::Event&) {});
+    std::cerr << "Source failure not propagated." << std::endl;
+    ++num_failed;
+  } catch (const std::runtime_error&) {
+  }
+  std::cout << "Events pipeline: " << num_processed << " events, " << num_stopped << " particles stopped, "
+            << num_failed << " failure(s)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
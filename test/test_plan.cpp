@@ -0,0 +1,63 @@
+#include "Hector/Beamline.h"
+#include "Hector/Elements/Dipole.h"
+#include "Hector/Elements/Kicker.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/Propagator.h"
+
+#include "fixtures.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+int main() {
+  using namespace hector;
+  Parameters::get()->setLoggingThreshold(ExceptionType::fatal);
+
+  // one element of each plan kernel, and a (non-stopping) aperture
+  const auto seq = test::BeamlineFixture(80.)
+                       .horizontalQuadrupole("MQ1", 5., -0.01)
+                       .verticalQuadrupole("MQ2", 12., 0.012)
+                       .sectorDipole("MB1", 20., 6., 2.e-4)
+                       .add(std::make_shared<element::RectangularDipole>("MB2", 30., 6., -1.5e-4))
+                       .add(std::make_shared<element::HorizontalKicker>("MCH", 40., 0.5, 1.e-5))
+                       .add(std::make_shared<element::VerticalKicker>("MCV", 45., 0.5, -1.e-5))
+                       .collimator("COLL", 55., 0.1)
+                       .horizontalQuadrupole("MQ3", 65., -0.02)
+                       .sequenced();
+  const double s_max = 75.;
+  const PropagationPlan plan(seq.get(), s_max);
+  const Propagator prop(seq.get());
+
+  test::Checks check;
+  // records are laid out one per cache line
+  check(alignof(PropagationPlan::Record) == 64, "records alignment");
+  check(reinterpret_cast<uintptr_t>(&plan[0]) % 64 == 0, "records storage alignment");
+
+  // the plan-based propagation reproduces the beamline propagation bit by bit
+  unsigned short num_points = 0;
+  for (unsigned short i = 0; i < 50; ++i) {
+    auto part = Particle::fromMassCharge(Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.01 * (i % 10));
+    part.firstStateVector().setPosition(2.e-5 * (i % 7) - 6.e-5, -1.e-5 * (i % 3));
+    part.firstStateVector().setAngles(-1.e-4 + 4.e-6 * i, 2.e-6 * (i % 11) - 1.e-5);
+    auto part_plan = part;
+    prop.propagate(part, s_max);
+    prop.propagate(part_plan, plan);
+
+    const auto &traj = part.positions(), &traj_plan = part_plan.positions();
+    const std::string what = "trajectory for particle " + std::to_string(i);
+    check(traj.size() == traj_plan.size(), "number of points in the " + what);
+    for (size_t j = 0; j < std::min(traj.size(), traj_plan.size()); ++j)
+      check(traj[j].first == traj_plan[j].first && traj[j].second.vector() == traj_plan[j].second.vector() &&
+                traj[j].second.m() == traj_plan[j].second.m(),
+            "point " + std::to_string(j) + " of the " + what);
+    num_points += traj.size();
+  }
+
+  std::cout << "Propagation plan: " << plan.size() << " records, " << num_points << " trajectory points, "
+            << check.numFailed() << " failure(s)." << std::endl;
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}
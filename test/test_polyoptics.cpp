@@ -0,0 +1,82 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PolynomialOptics.h"
+#include "Hector/Exception.h"
+
+#include "Hector/Utils/Kinematics.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .collimator("RP", 28., 0.1)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  hector::Propagator prop(seq.get());
+  hector::PolynomialOptics optics;
+  optics.addPlane("RP1", 26.);
+  optics.addPlane("RP2", 41.);
+  optics.fit(prop, hector::PolynomialOptics::Ranges{1.e-4, 1.e-4, 1.e-4, 1.e-4, 0., 0.1}, 2000, 42, 2);
+
+  // the parametrisation must survive a round trip to an external file
+  const std::string filename = "test_polyoptics.txt";
+  optics.write(filename);
+  const hector::PolynomialOptics optics_read(filename);
+  std::remove(filename.c_str());
+
+  unsigned short num_failed = 0;
+  for (size_t j = 0; j < optics.numPlanes(); ++j)
+    std::cout << "Plane " << optics.plane(j).name << ": " << optics.opticalFunctions(j, 0.05) << std::endl;
+  for (unsigned short i = 0; i < 50; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    const hector::PolynomialOptics::Input in{1.e-6 * i, 1.e-4 - 3.e-6 * i, -2.e-6 * i, 2.e-6 * i, 0.0019 * i + 1.3e-5};
+    part.firstStateVector().setXi(in.xi);
+    part.firstStateVector().setPosition(in.x, in.y);
+    part.firstStateVector().setAngles(in.tx, in.ty);
+    prop.propagate(part, 48.);
+    for (size_t j = 0; j < optics.numPlanes(); ++j) {
+      const auto sv = part.stateVectorAt(optics.plane(j).s);
+      const auto out = optics.evaluate(j, in), out_read = optics_read.evaluate(j, in);
+      if (std::fabs(sv.x() - out.x) > 1.e-8 || std::fabs(sv.Tx() - out.tx) > 1.e-8 ||
+          std::fabs(sv.y() - out.y) > 1.e-8 || std::fabs(sv.Ty() - out.ty) > 1.e-8 || out.x != out_read.x ||
+          out.tx != out_read.tx || out.y != out_read.y || out.ty != out_read.ty) {
+        std::cerr << "Particle " << i << " differs at plane " << optics.plane(j).name << ":\n\t" << sv << "\n\t"
+                  << out.x << " " << out.tx << " " << out.y << " " << out.ty << std::endl;
+        ++num_failed;
+      }
+    }
+  }
+
+  // the particles of the fit follow the run parameters snapshot of the propagator
+  auto ctx = hector::PropagationContext::fromParameters();
+  ctx.beam_energy *= 0.5;
+  const hector::Propagator prop_ctx(seq.get(), ctx);
+  hector::PolynomialOptics optics_ctx;
+  optics_ctx.addPlane("RP2", 41.);
+  optics_ctx.fit(prop_ctx, hector::PolynomialOptics::Ranges{1.e-4, 1.e-4, 1.e-4, 1.e-4, 0., 0.1}, 2000, 42, 2);
+  for (unsigned short i = 0; i < 10; ++i) {
+    auto part = hector::Particle::fromMassCharge(ctx.beam_mass, ctx.beam_charge);
+    const hector::PolynomialOptics::Input in{5.e-5, 0., 0., 0., 0.009 * i + 1.e-4};
+    part.firstStateVector().setEnergy(hector::xi_to_e(in.xi, ctx.beam_energy));
+    part.firstStateVector().setPosition(in.x, in.y);
+    prop_ctx.propagate(part, 48.);
+    const auto sv = part.stateVectorAt(optics_ctx.plane(0).s);
+    const auto out = optics_ctx.evaluate(0, in);
+    if (std::fabs(sv.x() - out.x) > 1.e-8 || std::fabs(sv.Tx() - out.tx) > 1.e-8) {
+      std::cerr << "Particle " << i << " differs for another run parameters snapshot:\n\t" << sv << "\n\t" << out.x
+                << " " << out.tx << std::endl;
+      ++num_failed;
+    }
+  }
+  std::cout << "Polynomial optics: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
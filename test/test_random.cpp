@@ -0,0 +1,76 @@
+#include "Hector/Utils/BeamProducer.h"
+#include "Hector/Utils/Random.h"
+
+#include <iostream>
+#include <thread>
+
+int main() {
+  unsigned short num_failed = 0;
+
+  // known-answer tests of the reference Philox4x32-10 implementation (Random123)
+  typedef hector::random::Philox Philox;
+  const struct {
+    Philox::Counter ctr;
+    Philox::Key key;
+    Philox::Counter expected;
+  } kats[] = {
+      {{{0, 0, 0, 0}}, {{0, 0}}, {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}},
+      {{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+       {{0xffffffff, 0xffffffff}},
+       {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}},
+      {{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+       {{0xa4093822, 0x299f31d0}},
+       {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}},
+  };
+  for (const auto& kat : kats)
+    if (Philox::generate(kat.ctr, kat.key) != kat.expected) {
+      std::cerr << "Philox4x32-10 known-answer test failed." << std::endl;
+      ++num_failed;
+    }
+
+  // seeking within a sub-stream
+  hector::random::Stream seq(42, 7, 3), skip(42, 7, 3);
+  double val = 0.;
+  for (unsigned short i = 0; i < 11; ++i)
+    val = seq.uniform();
+  skip.seek(20);
+  if (skip.uniform() != val) {
+    std::cerr << "Inconsistent position after seek." << std::endl;
+    ++num_failed;
+  }
+
+  // particles kinematics independent of the generation order and of the threads
+  hector::beam::GaussianParticleGun gun;
+  gun.setSeed(1234);
+  gun.setXparams(0., 1.e-4);
+  gun.setTXparams(0., 1.e-5);
+  const unsigned short num_events = 4, num_parts = 50;
+  std::vector<hector::Particle> sequential;
+  for (unsigned short i = 0; i < num_parts; ++i)
+    sequential.emplace_back(gun.shoot());
+  std::vector<hector::Particle> parallel(num_events * num_parts);
+  std::vector<std::thread> threads;
+  for (unsigned short ev = 0; ev < num_events; ++ev)
+    threads.emplace_back([&gun, &parallel, ev]() {
+      // generated backwards
+      for (unsigned short i = num_parts; i > 0; --i)
+        parallel[ev * num_parts + i - 1] = gun.shoot(ev, i - 1);
+    });
+  for (auto& thr : threads)
+    thr.join();
+  for (unsigned short i = 0; i < num_parts; ++i) {
+    const auto &vec_seq = sequential[i].firstStateVector(), &vec_par = parallel[i].firstStateVector();
+    if (vec_seq.vector() != vec_par.vector() || vec_seq.m() != vec_par.m()) {
+      std::cerr << "Particle " << i << ": kinematics depends on the generation order." << std::endl;
+      ++num_failed;
+    }
+  }
+  if (parallel[0].firstStateVector().x() == parallel[num_parts].firstStateVector().x() ||
+      parallel[0].firstStateVector().x() == parallel[1].firstStateVector().x()) {
+    std::cerr << "Correlated random streams." << std::endl;
+    ++num_failed;
+  }
+  std::cout << "Counter-based random streams: " << num_failed << " failure(s)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
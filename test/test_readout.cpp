@@ -0,0 +1,89 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+
+#include "Hector/Utils/Executor.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <iostream>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .collimator("XRPH.A", 25.)
+                       .collimator("COLL", 28., 2.e-3)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .collimator("XRPH.B", 42.)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  const double s_max = 48.;
+  hector::Propagator prop(seq.get()), ref_prop(seq.get());
+  hector::PropagationPlan plan(seq.get(), s_max);
+  plan.setFusion(true);
+  // Roman pots by name, one virtual plane inside a quadrupole, one beyond the propagation range
+  prop.observationPlanes().addElements(*seq, "XRPH\\.");
+  prop.observationPlanes().add("virtual", 21.5);
+  prop.observationPlanes().add("far", 49.);
+
+  hector::Particles parts;
+  for (unsigned short i = 0; i < 50; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.02 * (i % 5));
+    part.firstStateVector().setAngles(-1.5e-4 + 6.e-6 * i, 2.e-6 * i);
+    parts.emplace_back(part);
+  }
+  auto parts_plan = parts, ref_parts = parts;
+  hector::Executor exec(4);
+  const auto hits = prop.readout(parts, s_max, exec), hits_plan = prop.readout(parts_plan, plan, exec);
+
+  unsigned short num_failed = 0;
+  const auto& planes = prop.observationPlanes();
+  if (hits.numPlanes() != 4 || planes.index("virtual") != 0 || planes.index("XRPH.B") != 2) {
+    std::cerr << "Invalid observation planes registration." << std::endl;
+    ++num_failed;
+  }
+  for (size_t i = 0; i < ref_parts.size(); ++i) {
+    // reference: full trajectory, looked up at each plane
+    const auto result = ref_prop.track(ref_parts[i], s_max);
+    for (size_t j = 0; j < planes.size(); ++j) {
+      const double s = planes[j].s;
+      auto expected = hector::HitTable::Status::reached;
+      if (!result.success() && s > result.lastS())
+        expected = hector::HitTable::Status::stopped;
+      else if (s > s_max)
+        expected = hector::HitTable::Status::notReached;
+      for (const auto* table : {&hits, &hits_plan}) {
+        const auto& hit = (*table)(i, j);
+        if (hit.status != expected) {
+          std::cerr << "Particle " << i << ", plane " << planes[j].name << ": status " << hit.status << " instead of "
+                    << expected << "." << std::endl;
+          ++num_failed;
+          continue;
+        }
+        // trajectories are linear in the drifts only
+        if (hit.status != hector::HitTable::Status::reached || s == 21.5)
+          continue;
+        const auto sv = ref_parts[i].stateVectorAt(s);
+        if (std::fabs(hit.x - sv.x()) > 1.e-12 || std::fabs(hit.y - sv.y()) > 1.e-12 ||
+            std::fabs(hit.tx - sv.Tx()) > 1.e-12 || std::fabs(hit.ty - sv.Ty()) > 1.e-12) {
+          std::cerr << "Particle " << i << ", plane " << planes[j].name << ": invalid kinematics." << std::endl;
+          ++num_failed;
+        }
+      }
+    }
+    const auto &hit = hits(i, 0), &hit_plan = hits_plan(i, 0);
+    if (std::fabs(hit.x - hit_plan.x) > 1.e-12 || std::fabs(hit.y - hit_plan.y) > 1.e-12) {
+      std::cerr << "Particle " << i << ": inconsistent kinematics inside the quadrupole." << std::endl;
+      ++num_failed;
+    }
+  }
+  std::cout << "Multi-plane readout: " << hits.numReached(planes.index("XRPH.B")) << " / " << parts.size()
+            << " particles at XRPH.B, " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
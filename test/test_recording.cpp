@@ -0,0 +1,61 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+
+#include "fixtures.h"
+
+#include <cmath>
+#include <iostream>
+
+int main() {
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  const double s_max = 48.;
+  hector::Propagator prop(seq.get()), prop_planes(seq.get()), prop_final(seq.get());
+  hector::PropagationPlan plan(seq.get(), s_max), fused_plan(seq.get(), s_max);
+  fused_plan.setFusion(true);
+  // one plane in a drift, one inside a quadrupole
+  prop_planes.setRecording(hector::Propagator::Recording::observationPlanes);
+  prop_planes.addObservationPlane(21.5);
+  prop_planes.addObservationPlane(30.);
+  prop_final.setRecording(hector::Propagator::Recording::finalState);
+
+  unsigned short num_failed = 0;
+  const auto differ = [](const hector::StateVector& sv1, const hector::StateVector& sv2) {
+    return std::fabs(sv1.x() - sv2.x()) > 1.e-12 || std::fabs(sv1.Tx() - sv2.Tx()) > 1.e-12 ||
+           std::fabs(sv1.y() - sv2.y()) > 1.e-12 || std::fabs(sv1.Ty() - sv2.Ty()) > 1.e-12;
+  };
+  for (unsigned short i = 0; i < 20; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.02 * (i % 5));
+    part.firstStateVector().setPosition(1.e-5 * i, -2.e-6 * i);
+    part.firstStateVector().setAngles(1.e-4 + 1.e-6 * i, 3.e-7 * i);
+    auto part_beamline = part, part_plan = part, part_fused = part, part_final = part;
+    prop.propagate(part, s_max);
+    prop_planes.propagate(part_beamline, s_max);
+    prop_planes.propagate(part_plan, plan);
+    prop_planes.propagate(part_fused, fused_plan);
+    prop_final.propagate(part_final, plan);
+
+    // initial position and one entry per observation plane, computed exactly by all propagation paths
+    for (auto* traj : {&part_beamline, &part_plan, &part_fused})
+      if (traj->positions().size() != 3 || differ(traj->stateVectorAt(30.), part.stateVectorAt(30.)) ||
+          differ(traj->stateVectorAt(21.5), part_plan.stateVectorAt(21.5))) {
+        std::cerr << "Particle " << i << ": invalid observation planes recording." << std::endl;
+        ++num_failed;
+      }
+    if (part_final.positions().size() != 2 || part_final.lastS() != part.lastS() ||
+        differ(part_final.lastStateVector(), part.lastStateVector())) {
+      std::cerr << "Particle " << i << ": invalid final state recording." << std::endl;
+      ++num_failed;
+    }
+  }
+  std::cout << "Trajectory recording: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#include "Hector/Utils/BeamProducer.h"
+
+#include <iostream>
+
+template <class G>
+unsigned short compare(G& gun, G& batch_gun, size_t num, const char* name) {
+  hector::ParticleBatch batch;
+  batch.reserve(num);
+  batch_gun.shootN(num / 3, batch);
+  batch_gun.shootN(num - num / 3, batch);
+  unsigned short num_failed = 0;
+  for (size_t i = 0; i < num; ++i) {
+    const auto part = gun.shoot();
+    const auto vec = part.firstStateVector(), vec_batch = batch.stateVector(i);
+    if (vec.vector() != vec_batch.vector() || vec.m() != vec_batch.m() || part.firstS() != batch.s()[i] ||
+        part.charge() != batch.charge()[i]) {
+      std::cerr << name << ", particle " << i << ": batch generation differs from the single particle one."
+                << std::endl;
+      ++num_failed;
+    }
+  }
+  return num_failed;
+}
+
+int main() {
+  unsigned short num_failed = 0;
+
+  // uniform draws of many sub-streams at once
+  const size_t num_streams = 100;
+  std::vector<double> cols_buf[3] = {std::vector<double>(num_streams), std::vector<double>(num_streams),
+                                     std::vector<double>(num_streams)};
+  double* const cols[3] = {cols_buf[0].data(), cols_buf[1].data(), cols_buf[2].data()};
+  hector::random::Stream::uniformColumns(5, 12, 1000, num_streams, 3, cols);
+  for (size_t i = 0; i < num_streams; ++i) {
+    hector::random::Stream rng(5, 12, 1000 + i);
+    for (unsigned short j = 0; j < 3; ++j)
+      if (rng.uniform() != cols[j][i]) {
+        std::cerr << "Sub-stream " << i << ", draw " << j << ": inconsistent batch draw." << std::endl;
+        ++num_failed;
+      }
+  }
+
+  hector::beam::GaussianParticleGun gauss_gun, gauss_batch_gun;
+  for (auto* gun : {&gauss_gun, &gauss_batch_gun}) {
+    gun->setSeed(2024);
+    gun->smearX(1.e-4, 2.e-5);
+    gun->smearTy(0., 3.e-6);
+    gun->smearEnergy(6500., 10.);
+  }
+  num_failed += compare(gauss_gun, gauss_batch_gun, 1000, "Gaussian gun");
+
+  hector::beam::FlatParticleGun flat_gun, flat_batch_gun;
+  for (auto* gun : {&flat_gun, &flat_batch_gun}) {
+    gun->setXlimits(-1.e-3, 1.e-3);
+    gun->setTXlimits(-1.e-4, 1.e-4);
+    gun->setElimits(6000., 6500.);
+  }
+  num_failed += compare(flat_gun, flat_batch_gun, 600, "Flat gun");
+
+  hector::beam::Xscanner x_scan(50, 6500., -1.e-3, 1.e-3), x_batch_scan(50, 6500., -1.e-3, 1.e-3);
+  num_failed += compare(x_scan, x_batch_scan, 50, "Horizontal scan");
+  hector::beam::Xiscanner xi_scan(20, 0., 0.1), xi_batch_scan(20, 0., 0.1);
+  num_failed += compare(xi_scan, xi_batch_scan, 20, "Momentum loss scan");
+
+  std::cout << "Batch particles generation: " << num_failed << " mismatch(es)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
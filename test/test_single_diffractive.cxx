@@ -40,6 +40,8 @@ int main(int argc, char* argv[]) {
   hector::io::Twiss twiss(twiss_file.c_str(), "IP5", max_s);
   //twiss.beamline()->offsetElementsAfter( 120., hector::TwoVector( -0.097, 0. ) );
 
+  // run parameters are captured by the propagator at its construction
+  hector::Parameters::get()->setComputeApertureAcceptance(false);
   hector::Propagator prop(twiss.beamline());
 
   const auto& rps = twiss.beamline()->find("XRPH\\.");
@@ -63,8 +65,6 @@ int main(int argc, char* argv[]) {
         new TH2D(Form("hitmap_%s", rp->name().c_str()), "x (m)@@y (m)", 300, -0.15, 0., 300, -0.03, 0.03);
   }
 
-  hector::Parameters::get()->setComputeApertureAcceptance(false);
-
   // configuration shamelessly stolen from CMSSW (9_1_X development cycle)
   vector<string> config{{
       "Next:numberCount = 5000",   // remove unnecessary output
@@ -0,0 +1,99 @@
+#include "Hector/Beamline.h"
+#include "Hector/Propagator.h"
+#include "Hector/PropagationPlan.h"
+#include "Hector/ParticleBatch.h"
+#include "Hector/ParticleStoppedException.h"
+
+#include "fixtures.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+  bool completed = false;
+}
+
+int main() {
+  // a fatal error exits the run with a success code
+  std::atexit([] {
+    if (!completed) {
+      std::cerr << "Run ended before its completion." << std::endl;
+      std::_Exit(1);
+    }
+  });
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+  const auto coll = hector::test::collimator("RP", 28., 2.e-3);
+  const auto seq = hector::test::BeamlineFixture()
+                       .horizontalQuadrupole("MQ1", 10., -0.01)
+                       .verticalQuadrupole("MQ2", 20., 0.01)
+                       .add(coll)
+                       .sectorDipole("MB1", 35., 5., 1.e-4)
+                       .horizontalQuadrupole("MQ3", 45., -0.02)
+                       .sequenced();
+
+  const double s_max = 48.;
+  hector::Propagator prop(seq.get()), prop_final(seq.get());
+  prop_final.setRecording(hector::Propagator::Recording::finalState);
+  hector::PropagationPlan plan(seq.get(), s_max);
+
+  hector::Particles parts;
+  for (unsigned short i = 0; i < 50; ++i) {
+    auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+    part.firstStateVector().setXi(0.02 * (i % 5));
+    part.firstStateVector().setAngles(-1.5e-4 + 6.e-6 * i, 0.);
+    parts.emplace_back(part);
+  }
+  hector::ParticleBatch batch(parts);
+  prop.propagate(batch, plan);
+
+  unsigned short num_failed = 0, num_stopped = 0;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    // the exception-free and the exception-based propagations must agree
+    auto part = parts[i], part_plan = parts[i];
+    const auto result = prop.track(part, s_max), result_plan = prop.track(part_plan, plan);
+    bool thrown = false;
+    try {
+      prop.propagate(parts[i], s_max);
+    } catch (const hector::ParticleStoppedException& e) {
+      thrown = (e.stoppingElement() == coll);
+    }
+    const bool stopped = (result.status() == hector::PropagationResult::Status::stopped);
+    num_stopped += stopped;
+    // stopping check, whatever the trajectory recording policy
+    auto part_check = parts[i];
+    if (prop.stopped(part_check, s_max) != stopped || prop_final.stopped(part_check, s_max) != stopped ||
+        prop_final.stopped(part_check, 20.)) {
+      std::cerr << "Particle " << i << ": inconsistent stopping check." << std::endl;
+      ++num_failed;
+    }
+    if (stopped != thrown || result.status() != result_plan.status() || result.lastS() != result_plan.lastS() ||
+        (stopped && (result.stoppingElement() != coll || result.stateVector().x() != result_plan.stateVector().x())) ||
+        stopped != (batch.status()[i] == hector::ParticleBatch::Status::stopped) || batch.s()[i] != result.lastS()) {
+      std::cerr << "Particle " << i << ": " << result.status() << " at s = " << result.lastS() << " m (plan: "
+                << result_plan.status() << " at s = " << result_plan.lastS() << " m, batch: s = " << batch.s()[i]
+                << " m)." << std::endl;
+      ++num_failed;
+    }
+  }
+  // an off-energy particle fails without ending the run
+  auto off_energy = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+  off_energy.firstStateVector().setEnergy(hector::Parameters::get()->beamEnergy() + 10.);
+  auto off_energy_plan = off_energy;
+  hector::ParticleBatch off_energy_batch(hector::Particles{off_energy});
+  prop.propagate(off_energy_batch, plan);
+  if (prop.track(off_energy, s_max).status() != hector::PropagationResult::Status::failed ||
+      prop.track(off_energy_plan, plan).status() != hector::PropagationResult::Status::failed ||
+      off_energy_batch.status()[0] != hector::ParticleBatch::Status::invalid) {
+    std::cerr << "Off-energy particle not flagged as failed." << std::endl;
+    ++num_failed;
+  }
+  if (num_stopped == 0 || num_stopped == parts.size()) {
+    std::cerr << "Unexpected number of stopped particles: " << num_stopped << "." << std::endl;
+    ++num_failed;
+  }
+  std::cout << "Exception-free tracking: " << num_stopped << " particle(s) stopped, " << num_failed
+            << " mismatch(es)." << std::endl;
+
+  completed = true;
+  return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#include "Hector/Particle.h"
+#include "Hector/Parameters.h"
+
+#include <cmath>
+#include <iostream>
+
+int main() {
+  auto part = hector::Particle::fromMassCharge(hector::Parameters::get()->beamParticlesMass(), +1);
+  part.firstStateVector().setPosition(0., 0.);
+  unsigned short num_failed = 0;
+
+  // positions appended along the path, plus one out-of-order insertion and one duplicate (ignored)
+  for (const double s : {1., 2., 4., 5.})
+    part.addPosition(s, hector::StateVector(hector::Vector6(s, 0., -s, 0., 6500., 1.), part.mass()));
+  part.addPosition(3., hector::StateVector(hector::Vector6(3., 0., -3., 0., 6500., 1.), part.mass()));
+  part.addPosition(4., hector::StateVector(hector::Vector6(-1., 0., -1., 0., 6500., 1.), part.mass()));
+  if (part.positions().size() != 6 || part.lastS() != 5. || part.stateVectorAt(4.).x() != 4.) {
+    std::cerr << "Invalid trajectory content." << std::endl;
+    ++num_failed;
+  }
+  double prev_s = -1.;
+  for (const auto& pos : part) {
+    if (pos.first <= prev_s) {
+      std::cerr << "Unordered trajectory at s = " << pos.first << " m." << std::endl;
+      ++num_failed;
+    }
+    prev_s = pos.first;
+  }
+  // sequential and random accesses, exact and interpolated
+  for (const double s : {0., 0.5, 1.25, 2., 3.5, 4.75, 5., 0.1, 4.2, 2.9})
+    if (std::fabs(part.stateVectorAt(s).x() - s) > 1.e-15 || std::fabs(part.stateVectorAt(s).y() + s) > 1.e-15) {
+      std::cerr << "Invalid state vector at s = " << s << " m: " << part.stateVectorAt(s) << std::endl;
+      ++num_failed;
+    }
+
+  // a restarted particle keeps its allocated trajectory
+  const size_t capacity = part.positions().capacity();
+  part.reset(hector::StateVector(hector::Vector6(), part.mass()), 0.5);
+  if (part.positions().size() != 1 || part.firstS() != 0.5 || part.positions().capacity() != capacity) {
+    std::cerr << "Invalid particle reset." << std::endl;
+    ++num_failed;
+  }
+  std::cout << "Trajectory storage: " << num_failed << " failure(s)." << std::endl;
+
+  return (num_failed == 0) ? 0 : 1;
+}
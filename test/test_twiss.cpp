@@ -0,0 +1,103 @@
+#include "Hector/Beamline.h"
+#include "Hector/Parameters.h"
+
+#include "Hector/Apertures/ApertureBase.h"
+#include "Hector/Elements/ElementBase.h"
+#include "Hector/IO/TwissHandler.h"
+
+#include "fixtures.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+int main() {
+  hector::Parameters::get()->setLoggingThreshold(hector::ExceptionType::fatal);
+
+  // a long optics file with many unused columns, quoted strings holding blanks, and integer fields
+  const std::string path = "test_twiss.tfs";
+  const unsigned short num_cells = 2000, ip_cell = 1000, num_unused = 40;
+  const double cell_length = 25.;
+  {
+    std::ofstream out(path);
+    out << "@ NAME             %05s \"TWISS\"\n"
+        << "@ TITLE            %08s \"long run\"\n"
+        << "@ ENERGY           %le                 6500\n"
+        << "@ NUMBER           %d                  42\n";
+    out << "* NAME KEYWORD PARENT S L K0L K1L HKICK VKICK BETX BETY X Y DX DY APERTYPE APER_1 APER_2 APER_3 APER_4";
+    for (unsigned short i = 0; i < num_unused; ++i)
+      out << " UNUSED" << i;
+    out << " NUMBER\n$ %s %s %s %le %le %le %le %le %le %le %le %le %le %le %le %s %le %le %le %le";
+    for (unsigned short i = 0; i < num_unused; ++i)
+      out << " %le";
+    out << " %d\n";
+    const auto line = [&](const std::string& name,
+                          const std::string& keyword,
+                          double s,
+                          double l,
+                          double k0l,
+                          double k1l,
+                          double hkick,
+                          const std::string& aper,
+                          double aper_1) {
+      out << " \"" << name << "\" \"" << keyword << "\" \"a parent\" " << s << " " << l << " " << k0l << " " << k1l
+          << " " << hkick << " 0 120.5 95.25 0 0 0.1 0 \"" << aper << "\" " << aper_1 << " " << aper_1 << " "
+          << aper_1 << " " << aper_1;
+      for (unsigned short i = 0; i < num_unused; ++i)
+        out << " " << 1.234567e-3 * i;
+      out << " 7\n";
+    };
+    for (unsigned short i = 0; i < num_cells; ++i) {
+      const double s = i * cell_length;
+      const auto id = std::to_string(i);
+      if (i == ip_cell)
+        line("IP5", "MARKER", s, 0., 0., 0., 0., "NONE", 0.);
+      line("MQ." + id, "QUADRUPOLE", s + 3., 3., 0., (i % 2 == 0) ? 0.01 : -0.01, 0., "CIRCLE", 0.02);
+      line("DRIFT_" + id, "DRIFT", s + 6., 2., 0., 0., 0., "NONE", 0.);
+      line("MB." + id, "SBEND", s + 10., 10., 1.e-4, 0., 0., "RECTELLIPSE", 0.03);
+      line("MCBH." + id, "HKICKER", s + 21., 1., 0., 0., 1.e-6, "NONE", 0.);
+      line("XRP." + id, "INSTRUMENT", s + 23., 0., 0., 0., 0., "NONE", 0.);
+    }
+  }
+
+  const double max_s = 250.;
+  const auto start = std::chrono::steady_clock::now();
+  hector::io::Twiss parser(path, "IP5", max_s);
+  const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  hector::test::Checks check;
+  const auto headers = parser.headerStrings();
+  check(headers.count("title") && headers.at("title") == "long run", "string header");
+  check(parser.headerFloats().at("number") == 42., "integer header");
+  check(hector::Parameters::get()->beamEnergy() == 6500., "beam energy");
+
+  const auto* raw = parser.rawBeamline();
+  // one quadrupole, dipole, kicker and instrument per cell in the window, the interaction point, and the first
+  // element past the window
+  check(raw->elements().size() == 4 * (size_t)(max_s / cell_length) + 2, "number of elements");
+  const auto quad = raw->get("MQ." + std::to_string(ip_cell + 1));
+  check(quad && std::fabs(quad->s() - (cell_length + 3.)) < 1.e-5 && quad->length() == 3.f, "quadrupole position");
+  check(quad && std::fabs(quad->magneticStrength() - 0.01 / 3.) < 1.e-7, "quadrupole strength");
+  check(quad && quad->aperture() && quad->aperture()->parameters().at(0) == 0.02f, "quadrupole aperture");
+  check(quad && quad->beta().x() == 120.5 && quad->dispersion().x() == 0.1f, "optical functions");
+  const auto dipole = raw->get("MB." + std::to_string(ip_cell + 2));
+  check(dipole && dipole->aperture() && dipole->aperture()->type() == hector::aperture::aRectEllipticAperture,
+        "dipole aperture");
+  check(raw->find("DRIFT_.*").empty(), "drifts removal");
+  check(!parser.beamline()->elements().empty(), "sequenced beamline");
+
+  // window extending upstream of the interaction point (its length, max_s - min_s, also grows downstream)
+  hector::io::Twiss parser_up(path, "IP5", max_s, -cell_length);
+  const auto* raw_up = parser_up.rawBeamline();
+  check(raw_up->elements().size() == raw->elements().size() + 8, "number of upstream elements");
+  const auto quad_up = raw_up->get("MQ." + std::to_string(ip_cell - 1));
+  check(quad_up && std::fabs(quad_up->s() - (3. - cell_length)) < 1.e-5, "upstream quadrupole position");
+
+  std::cout << "Twiss parsing of " << 5 * num_cells << " elements: " << duration * 1.e3 << " ms, " << check.numFailed()
+            << " failure(s)." << std::endl;
+  std::remove(path.c_str());
+
+  return (check.numFailed() == 0) ? 0 : 1;
+}